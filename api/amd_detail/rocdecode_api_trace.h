@@ -47,7 +47,7 @@ THE SOFTWARE.
 
 // Increment the ROCDECODE_RUNTIME_API_TABLE_STEP_VERSION when new runtime API functions are added.
 // If the corresponding ROCDECODE_RUNTIME_API_TABLE_MAJOR_VERSION increases reset the ROCDECODE_RUNTIME_API_TABLE_STEP_VERSION to zero.
-#define ROCDECODE_RUNTIME_API_TABLE_STEP_VERSION 1
+#define ROCDECODE_RUNTIME_API_TABLE_STEP_VERSION 9
 
 // rocDecode API interface
 typedef rocDecStatus (ROCDECAPI *PfnRocDecCreateVideoParser)(RocdecVideoParser *parser_handle, RocdecParserParams *params);
@@ -66,6 +66,19 @@ typedef rocDecStatus (ROCDECAPI *PfnRocDecGetBitstreamCodecType)(RocdecBitstream
 typedef rocDecStatus (ROCDECAPI *PfnRocDecGetBitstreamBitDepth)(RocdecBitstreamReader bs_reader_handle, int *bit_depth);
 typedef rocDecStatus (ROCDECAPI *PfnRocDecGetBitstreamPicData)(RocdecBitstreamReader bs_reader_handle, uint8_t **pic_data, int *pic_size, int64_t *pts);
 typedef rocDecStatus (ROCDECAPI *PfnRocDecDestroyBitstreamReader)(RocdecBitstreamReader bs_reader_handle);
+typedef rocDecStatus (ROCDECAPI *PfnRocDecFlushVideoParser)(RocdecVideoParser parser_handle);
+typedef rocDecStatus (ROCDECAPI *PfnRocDecParseVideoDataEx)(RocdecVideoParser parser_handle, RocdecSourceDataPacket *packet, RocdecParserEvent *events, uint32_t max_events, uint32_t *num_events);
+typedef rocDecStatus (ROCDECAPI *PfnRocDecParserReleasePicParams)(RocdecVideoParser parser_handle, RocdecPicParams *pic_params);
+typedef rocDecStatus (ROCDECAPI *PfnRocDecSelectDevice)(RocdecDeviceSelectInfo *select_info);
+typedef rocDecStatus (ROCDECAPI *PfnRocDecGetInteropMapStatus)(rocDecDecoderHandle decoder_handle, RocdecInteropMapStatus *map_status);
+typedef rocDecStatus (ROCDECAPI *PfnRocDecSetDecodeCompleteNotify)(rocDecDecoderHandle decoder_handle, RocdecDecodeCompleteNotifyParams *notify_params);
+typedef rocDecStatus (ROCDECAPI *PfnRocDecTraceEvent)(const char *name, rocDecTracePhase phase, int pic_idx);
+typedef rocDecStatus (ROCDECAPI *PfnRocDecTraceDump)(const char *file_path);
+typedef rocDecStatus (ROCDECAPI *PfnRocDecGetParserStats)(RocdecVideoParser parser_handle, RocdecParserStats *parser_stats);
+typedef rocDecStatus (ROCDECAPI *PfnRocDecGetDecoderMemoryUsage)(rocDecDecoderHandle decoder_handle, RocdecMemoryUsage *memory_usage);
+typedef rocDecStatus (ROCDECAPI *PfnRocDecGetParserMemoryUsage)(RocdecVideoParser parser_handle, RocdecMemoryUsage *memory_usage);
+typedef rocDecStatus (ROCDECAPI *PfnRocDecGetBitstreamReaderMemoryUsage)(RocdecBitstreamReader bs_reader_handle, RocdecMemoryUsage *memory_usage);
+typedef rocDecStatus (ROCDECAPI *PfnRocDecGetMemoryUsage)(RocdecMemoryUsage *memory_usage);
 
 // rocDecode API dispatch table
 struct RocDecodeDispatchTable {
@@ -91,6 +104,35 @@ struct RocDecodeDispatchTable {
     PfnRocDecDestroyBitstreamReader pfn_rocdec_destroy_bitstream_reader;
     // PLEASE DO NOT EDIT ABOVE!
     // ROCDECODE_RUNTIME_API_TABLE_STEP_VERSION == 2
+    PfnRocDecFlushVideoParser pfn_rocdec_flush_video_parser;
+    // PLEASE DO NOT EDIT ABOVE!
+    // ROCDECODE_RUNTIME_API_TABLE_STEP_VERSION == 3
+    PfnRocDecParseVideoDataEx pfn_rocdec_parse_video_data_ex;
+    PfnRocDecParserReleasePicParams pfn_rocdec_parser_release_pic_params;
+    // PLEASE DO NOT EDIT ABOVE!
+    // ROCDECODE_RUNTIME_API_TABLE_STEP_VERSION == 4
+    PfnRocDecSelectDevice pfn_rocdec_select_device;
+    // PLEASE DO NOT EDIT ABOVE!
+    // ROCDECODE_RUNTIME_API_TABLE_STEP_VERSION == 5
+    PfnRocDecGetInteropMapStatus pfn_rocdec_get_interop_map_status;
+    // PLEASE DO NOT EDIT ABOVE!
+    // ROCDECODE_RUNTIME_API_TABLE_STEP_VERSION == 6
+    PfnRocDecSetDecodeCompleteNotify pfn_rocdec_set_decode_complete_notify;
+    // PLEASE DO NOT EDIT ABOVE!
+    // ROCDECODE_RUNTIME_API_TABLE_STEP_VERSION == 7
+    PfnRocDecTraceEvent pfn_rocdec_trace_event;
+    PfnRocDecTraceDump pfn_rocdec_trace_dump;
+    // PLEASE DO NOT EDIT ABOVE!
+    // ROCDECODE_RUNTIME_API_TABLE_STEP_VERSION == 8
+    PfnRocDecGetParserStats pfn_rocdec_get_parser_stats;
+    // PLEASE DO NOT EDIT ABOVE!
+    // ROCDECODE_RUNTIME_API_TABLE_STEP_VERSION == 9
+    PfnRocDecGetDecoderMemoryUsage pfn_rocdec_get_decoder_memory_usage;
+    PfnRocDecGetParserMemoryUsage pfn_rocdec_get_parser_memory_usage;
+    PfnRocDecGetBitstreamReaderMemoryUsage pfn_rocdec_get_bitstream_reader_memory_usage;
+    PfnRocDecGetMemoryUsage pfn_rocdec_get_memory_usage;
+    // PLEASE DO NOT EDIT ABOVE!
+    // ROCDECODE_RUNTIME_API_TABLE_STEP_VERSION == 10
 
     // ******************************************************************************************* //
     //                                            READ BELOW
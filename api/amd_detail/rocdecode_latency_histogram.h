@@ -0,0 +1,96 @@
+/*
+Copyright (c) 2023 - 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#pragma once
+
+#include <stdint.h>
+#include <math.h>
+
+/*!
+ * \file
+ * \brief Log-linear latency histogram buckets, shared by the API latency interposer of the library and RocVideoDecoder.
+ *
+ * Latencies in ns below 32 ns have a bucket each. Above that every power of two is split into 16 buckets, so a bucket
+ * spans 1/16 of its value and percentiles read from the buckets are accurate to that. Latencies are clamped to 2^40 ns
+ * (~18 minutes). The owner of the counts picks their storage, e.g. plain or single-writer atomic counters.
+ */
+class RocDecLatencyBuckets {
+public:
+    static constexpr int kSubBucketBits = 4;
+    static constexpr int kMaxLatencyBits = 40;
+    static constexpr uint32_t kNumBuckets = (2u << kSubBucketBits) + (kMaxLatencyBits - kSubBucketBits - 1) * (1u << kSubBucketBits);
+
+    /*! \brief Returns the bucket a latency is counted in
+     */
+    static uint32_t GetBucketIndex(uint64_t latency_ns) {
+        const uint64_t max_latency_ns = (1ull << kMaxLatencyBits) - 1;
+        if (latency_ns > max_latency_ns) {
+            latency_ns = max_latency_ns;
+        }
+        if (latency_ns < (2u << kSubBucketBits)) {
+            return static_cast<uint32_t>(latency_ns);
+        }
+        // keep the kSubBucketBits bits below the most significant one
+        int shift = (63 - __builtin_clzll(latency_ns)) - kSubBucketBits;
+        uint32_t sub_bucket = static_cast<uint32_t>(latency_ns >> shift) - (1u << kSubBucketBits);
+        return (2u << kSubBucketBits) + (shift - 1) * (1u << kSubBucketBits) + sub_bucket;
+    }
+
+    /*! \brief Returns the largest latency counted in a bucket
+     */
+    static uint64_t GetBucketUpperBound(uint32_t bucket_index) {
+        if (bucket_index < (2u << kSubBucketBits)) {
+            return bucket_index;
+        }
+        uint32_t shift = (bucket_index - (2u << kSubBucketBits)) / (1u << kSubBucketBits) + 1;
+        uint64_t sub_bucket = (bucket_index - (2u << kSubBucketBits)) % (1u << kSubBucketBits) + (1u << kSubBucketBits);
+        return ((sub_bucket + 1) << shift) - 1;
+    }
+
+    /*! \brief Returns a percentile of the counts of kNumBuckets buckets, capped at the largest latency seen
+     * \param [in] buckets Counts of the buckets
+     * \param [in] max_ns Largest latency counted
+     * \param [in] percentile 0 to 100
+     * \return The upper bound of the bucket holding the percentile, or 0 if nothing was counted
+     */
+    static uint64_t GetPercentile(const uint64_t *buckets, uint64_t max_ns, double percentile) {
+        uint64_t count = 0;
+        for (uint32_t i = 0; i < kNumBuckets; i++) {
+            count += buckets[i];
+        }
+        if (count == 0) {
+            return 0;
+        }
+        uint64_t rank = static_cast<uint64_t>(ceil(percentile / 100.0 * count));
+        if (rank == 0) {
+            rank = 1;
+        }
+        uint64_t seen = 0;
+        for (uint32_t i = 0; i < kNumBuckets; i++) {
+            seen += buckets[i];
+            if (seen >= rank) {
+                uint64_t upper_bound = GetBucketUpperBound(i);
+                return upper_bound < max_ns ? upper_bound : max_ns;
+            }
+        }
+        return max_ns;
+    }
+};
@@ -0,0 +1,76 @@
+/*
+Copyright (c) 2023 - 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#pragma once
+
+#include <stdint.h>
+
+/*!
+ * \file
+ * \brief Layout of the shared-memory metrics segments of rocDecode sessions.
+ *
+ * With ROCDECODE_METRICS_SHM=1, every decoder and parser session publishes its counters in a POSIX shared-memory
+ * segment named ROCDECODE_METRICS_SHM_PREFIX<pid>.<session_id> (/dev/shm/rocdecode.<pid>.<session_id> on Linux).
+ * The segment is created when the session begins and unlinked when it ends. A monitor maps it read-only, checks
+ * magic, version and size, and reads the counters with atomic loads while the session runs. rocdecode-metrics is
+ * such a monitor.
+ */
+
+#define ROCDECODE_METRICS_SHM_PREFIX "/rocdecode."
+#define ROCDECODE_METRICS_MAGIC 0x534D4452 /* "RDMS"; stored last when the segment is created */
+#define ROCDECODE_METRICS_VERSION 1
+
+/*! \brief Kind of session publishing a metrics segment */
+typedef enum rocDecMetricsSessionType_enum {
+    rocDecMetricsSession_Decoder = 1, /**< a decoder created by rocDecCreateDecoder */
+    rocDecMetricsSession_Parser = 2,  /**< a parser created by rocDecCreateVideoParser */
+} rocDecMetricsSessionType;
+
+/*! \brief Shared-memory metrics segment of one session.
+ *
+ * The session updates every field after the header with a single atomic store or add; the fields are not updated
+ * together, so two of them may be from slightly different points in time. All times are CLOCK_MONOTONIC.
+ */
+typedef struct _RocdecMetricsSegment {
+    uint32_t magic;                 /**< ROCDECODE_METRICS_MAGIC once the header is valid */
+    uint32_t version;               /**< ROCDECODE_METRICS_VERSION */
+    uint32_t size;                  /**< sizeof(RocdecMetricsSegment) */
+    uint32_t session_type;          /**< rocDecMetricsSessionType */
+    int32_t pid;                    /**< process of the session */
+    uint32_t session_id;            /**< unique across the decoder and parser sessions of the process */
+    int32_t device_id;              /**< decoder: device id; parser: -1 */
+    uint32_t codec_type;            /**< rocDecVideoCodec */
+    uint64_t start_time_ns;         /**< time the session began */
+    uint64_t update_time_ns;        /**< time of the last update of num_frames */
+    uint32_t width;                 /**< decoder: decode width; parser: coded width of the active sequence */
+    uint32_t height;                /**< decoder: decode height; parser: coded height of the active sequence */
+    uint32_t num_surfaces;          /**< decoder: decode surfaces; parser: decode buffer pool size */
+    uint32_t surfaces_in_use;       /**< parser: decode buffers holding a picture being decoded, referenced or waiting for display; decoder: 0 */
+    uint32_t frames_in_flight;      /**< decoder: pictures submitted and not yet found complete by rocDecGetDecodeStatus or rocDecGetVideoFrame; parser: 0 */
+    uint32_t reserved;
+    uint64_t fps_milli;             /**< num_frames per second times 1000, measured over the last window of at least one second */
+    uint64_t num_frames;            /**< decoder: pictures submitted for decoding; parser: pictures parsed */
+    uint64_t num_frames_output;     /**< decoder: frames returned by rocDecGetVideoFrame; parser: pictures sent to the display callback */
+    uint64_t num_bytes;             /**< decoder: bitstream bytes submitted; parser: bytes passed to rocDecParseVideoData */
+    uint64_t num_errors;            /**< decoder: failed submissions and pictures decoded with errors; parser: failed rocDecParseVideoData calls */
+    uint64_t num_reconfigurations;  /**< decoder: rocDecReconfigureDecoder calls; parser: sequence changes */
+    uint64_t reserved_1[16];
+} RocdecMetricsSegment;
@@ -73,6 +73,13 @@ extern rocDecStatus ROCDECAPI rocDecGetBitstreamBitDepth(RocdecBitstreamReader b
 /************************************************************************************************/
 extern rocDecStatus ROCDECAPI rocDecGetBitstreamPicData(RocdecBitstreamReader bs_reader_handle, uint8_t **pic_data, int *pic_size, int64_t *pts);
 
+/************************************************************************************************/
+//! \ingroup group_roc_bitstream_reader
+//! \fn rocDecStatus ROCDECAPI rocDecGetBitstreamReaderMemoryUsage(RocdecBitstreamReader bs_reader_handle, RocdecMemoryUsage *memory_usage)
+//! Get the memory held by the bitstream reader in bitstream_reader_bytes
+/************************************************************************************************/
+extern rocDecStatus ROCDECAPI rocDecGetBitstreamReaderMemoryUsage(RocdecBitstreamReader bs_reader_handle, RocdecMemoryUsage *memory_usage);
+
 /************************************************************************************************/
 //! \ingroup group_roc_bitstream_reader
 //! \fn rocDecStatus ROCDECAPI rocDecDestroyBitstreamReader(RocdecBitstreamReader bs_reader_handle)
@@ -29,7 +29,12 @@ THE SOFTWARE.
 #endif
 
 #pragma once
+#if ROCDECODE_HOST_ONLY
+#include <stdint.h>
+#include <stddef.h>
+#else
 #include "hip/hip_runtime.h"
+#endif
 #include "rocdecode_version.h"
 
 /*!
@@ -141,6 +146,43 @@ typedef enum rocDecodeStatus_enum {
     rocDecodeStatus_Displaying = 10,     // Decode is completed, displaying in progress
 } rocDecDecodeStatus;
 
+/*************************************************************************/
+//! \enum rocDecBackendType
+//! \ingroup group_amd_rocdecode
+//! Decoder backend enums
+//! These enums are used in RocDecoderCreateInfo structure
+/*************************************************************************/
+typedef enum rocDecBackendType_enum {
+    rocDecBackend_Default = 0, // VA-API on the VCN hardware, unless overridden by the ROCDECODE_BACKEND environment variable
+    rocDecBackend_VAAPI = 1,   // Hardware decode on the VCN through VA-API
+    rocDecBackend_Null = 2,    // No decode; surfaces are host memory and complete immediately or after ROCDECODE_NULL_DECODE_DELAY_US
+} rocDecBackendType;
+
+/*************************************************************************/
+//! \enum rocDecInteropMapMode
+//! \ingroup group_amd_rocdecode
+//! HIP interop mapping enums
+//! These enums are used in RocDecoderCreateInfo structure
+/*************************************************************************/
+typedef enum rocDecInteropMapMode_enum {
+    rocDecInteropMap_Default = 0,    // Lazy, unless overridden by the ROCDECODE_INTEROP_MAP environment variable
+    rocDecInteropMap_Lazy = 1,       // Each surface is exported and mapped for HIP on its first rocDecGetVideoFrame
+    rocDecInteropMap_Eager = 2,      // All surfaces are mapped before decoder creation or reconfiguration returns
+    rocDecInteropMap_Background = 3, // All surfaces are mapped by a background thread after creation or reconfiguration
+} rocDecInteropMapMode;
+
+/*************************************************************************/
+//! \enum rocDecTracePhase
+//! \ingroup group_amd_rocdecode
+//! Pipeline trace event phase enums
+//! These enums are used in rocDecTraceEvent API
+/*************************************************************************/
+typedef enum rocDecTracePhase_enum {
+    rocDecTracePhase_Begin = 0,   // Begin of a stage on the calling thread
+    rocDecTracePhase_End = 1,     // End of the last begun stage on the calling thread
+    rocDecTracePhase_Instant = 2, // A point in time
+} rocDecTracePhase;
+
 /**************************************************************************************************************/
 //! \struct RocdecDecodeCaps;
 //! \ingroup group_amd_rocdecode
@@ -162,6 +204,23 @@ typedef struct _RocdecDecodeCaps {
     uint32_t reserved_2[6];                /**< Reserved for future use - set to zero */
 } RocdecDecodeCaps;
 
+/**************************************************************************************************************/
+//! \struct RocdecDeviceSelectInfo
+//! \ingroup group_amd_rocdecode
+//! This structure is used in rocDecSelectDevice API
+/**************************************************************************************************************/
+typedef struct _RocdecDeviceSelectInfo {
+    rocDecVideoCodec codec_type;           /**< IN: rocDecVideoCodec_XXX */
+    rocDecVideoChromaFormat chroma_format; /**< IN: rocDecVideoChromaFormat_XXX */
+    uint32_t bit_depth_minus_8;            /**< IN: The value "BitDepth minus 8" */
+    uint32_t width;                        /**< IN: Coded sequence width in pixels */
+    uint32_t height;                       /**< IN: Coded sequence height in pixels */
+    uint32_t frame_rate;                   /**< IN: Expected frames per second of the stream, 0 assumes 30 */
+    uint32_t num_devices;                  /**< IN: Consider devices 0 to num_devices - 1 only, 0 considers all devices */
+    uint8_t device_id;                     /**< OUT: the least-loaded device that supports the IN params */
+    uint32_t reserved[8];                  /**< Reserved for future use - set to zero */
+} RocdecDeviceSelectInfo;
+
 /**************************************************************************************************************/
 //! \struct RocDecoderCreateInfo
 //! \ingroup group_amd_rocdecode
@@ -200,9 +259,69 @@ typedef struct _RocDecoderCreateInfo {
         int16_t bottom;
     } target_rect;          /**< IN: (for future use) target rectangle in the output frame (for aspect ratio conversion)
                                     if a null rectangle is specified, {0,0,target_width,target_height} will be used*/
-    uint32_t reserved_2[4]; /**< Reserved for future use - set to zero */
+    rocDecBackendType backend_type; /**< IN: rocDecBackend_XXX; rocDecBackend_Default selects VA-API unless ROCDECODE_BACKEND is set */
+    uint32_t submit_queue_depth; /**< IN: Max # of pictures queued for an internal submission thread before rocDecDecodeFrame blocks.
+                                          0 submits on the calling thread unless ROCDECODE_SUBMIT_QUEUE_DEPTH is set */
+    rocDecInteropMapMode interop_map_mode; /**< IN: rocDecInteropMap_XXX; when the decode surfaces are mapped for HIP */
+    uint32_t reserved_2[1]; /**< Reserved for future use - set to zero */
 } RocDecoderCreateInfo;
 
+/*********************************************************************************************************/
+//! \fn int (ROCDECAPI *PFNVIDDECODECOMPLETECALLBACK)(void *user_data, int pic_idx, rocDecDecodeStatus decode_status)
+//! \ingroup group_amd_rocdecode
+//! Callback type for decode completion notifications, see RocdecDecodeCompleteNotifyParams.
+/*********************************************************************************************************/
+typedef int (ROCDECAPI *PFNVIDDECODECOMPLETECALLBACK)(void *user_data, int pic_idx, rocDecDecodeStatus decode_status);
+
+/*********************************************************************************************************/
+//! \struct RocdecDecodeCompleteNotifyParams
+//! \ingroup group_amd_rocdecode
+//! Struct for requesting notifications when submitted pictures finish decoding.
+//! This structure is used in rocDecSetDecodeCompleteNotify API.
+/*********************************************************************************************************/
+typedef struct _RocdecDecodeCompleteNotifyParams {
+    PFNVIDDECODECOMPLETECALLBACK pfn_decode_complete; /**< IN: Called on the completion thread for every picture that finished
+                                                            decoding, or NULL. It must not reconfigure or destroy the decoder */
+    void *user_data;          /**< IN: User data passed to pfn_decode_complete */
+    uint32_t enable_event_fd; /**< IN: 1 to create an eventfd whose counter is incremented for every picture that finished decoding */
+    int event_fd;             /**< OUT: The eventfd, or -1 if not requested. It is owned and closed by the decoder */
+    uint32_t reserved[14];    /**< Reserved for future use - set to zero */
+    void *p_reserved[4];      /**< Reserved for future use - set to NULL */
+} RocdecDecodeCompleteNotifyParams;
+
+/*********************************************************************************************************/
+//! \struct RocdecInteropMapStatus
+//! \ingroup group_amd_rocdecode
+//! Struct for reporting the progress of the HIP interop mapping of the decode surfaces.
+//! This structure is used in rocDecGetInteropMapStatus API.
+/*********************************************************************************************************/
+typedef struct _RocdecInteropMapStatus {
+    uint32_t wait;          /**< IN: 1 to block until the mapping started by the last creation or reconfiguration is done */
+    uint32_t num_surfaces;  /**< OUT: Number of decode surfaces */
+    uint32_t num_mapped;    /**< OUT: Number of decode surfaces mapped for HIP (all of them for host-memory surfaces) */
+    uint32_t is_complete;   /**< OUT: 1 when the mapping is done; surfaces not mapped by then are mapped on first use */
+    rocDecStatus status;    /**< OUT: first error of the eager or background mapping, ROCDEC_SUCCESS otherwise */
+    uint32_t reserved[11];  /**< Reserved for future use - set to zero */
+} RocdecInteropMapStatus;
+
+/*********************************************************************************************************/
+//! \struct RocdecMemoryUsage
+//! \ingroup group_amd_rocdecode
+//! Bytes of memory held by rocDecode, per category.
+//! This structure is used in rocDecGetDecoderMemoryUsage, rocDecGetParserMemoryUsage, rocDecGetBitstreamReaderMemoryUsage
+//! and rocDecGetMemoryUsage APIs. A field that does not apply to the handle is 0.
+/*********************************************************************************************************/
+typedef struct _RocdecMemoryUsage {
+    uint64_t surface_bytes;           /**< OUT: Decode surfaces: VA-API surfaces in device memory (estimated from their layout), or host memory surfaces of the null backend */
+    uint64_t interop_bytes;           /**< OUT: Decode surfaces mapped for HIP. These map the surface memory; they do not add to it */
+    uint64_t decode_queue_bytes;      /**< OUT: Copies of the pictures queued for asynchronous submission */
+    uint64_t parser_bytes;            /**< OUT: Parser buffers: SEI and slice lists, decode buffer pool, queued packets and event-mode picture parameters */
+    uint64_t bitstream_reader_bytes;  /**< OUT: Bitstream reader stream ring and picture buffer */
+    uint64_t device_bytes;            /**< OUT: Total device memory: the VA-API surfaces */
+    uint64_t host_bytes;              /**< OUT: Total host memory: all of the above except the VA-API surfaces and their mappings */
+    uint64_t reserved[9];             /**< Reserved for future use - set to zero */
+} RocdecMemoryUsage;
+
 /*********************************************************************************************************/
 //! \struct RocdecDecodeStatus
 //! \ingroup group_amd_rocdecode
@@ -1703,6 +1822,17 @@ extern rocDecStatus ROCDECAPI rocDecDestroyDecoder(rocDecDecoderHandle decoder_h
 /**********************************************************************************************************************/
 extern rocDecStatus ROCDECAPI rocDecGetDecoderCaps(RocdecDecodeCaps *decode_caps);
 
+/**********************************************************************************************************************/
+//! \fn rocDecStatus ROCDECAPI rocDecSelectDevice(RocdecDeviceSelectInfo *select_info)
+//! \ingroup group_amd_rocdecode
+//! Selects the device to create the decoder of a new stream on. The load of a device is the pixel rate of its active
+//! decoder sessions per VCN instance; the device with the lowest load after adding the new stream is returned in
+//! device_id. The selection is held for the new stream for a few seconds so that back-to-back calls spread the
+//! streams before their decoders are created.
+//! Returns ROCDEC_NOT_SUPPORTED if no device can decode the IN params.
+/**********************************************************************************************************************/
+extern rocDecStatus ROCDECAPI rocDecSelectDevice(RocdecDeviceSelectInfo *select_info);
+
 /*****************************************************************************************************/
 //! \fn rocDecStatus ROCDECAPI rocDecDecodeFrame(rocDecDecoderHandle decoder_handle, RocdecPicParams *pic_params)
 //! \ingroup group_amd_rocdecode
@@ -1741,6 +1871,57 @@ extern rocDecStatus ROCDECAPI rocDecGetVideoFrame(rocDecDecoderHandle decoder_ha
                                                     void *dev_mem_ptr[3], uint32_t *horizontal_pitch,
                                                     RocdecProcParams *vid_postproc_params);
 
+/*****************************************************************************************************/
+//! \fn rocDecStatus ROCDECAPI rocDecGetInteropMapStatus(rocDecDecoderHandle decoder_handle, RocdecInteropMapStatus *map_status)
+//! \ingroup group_amd_rocdecode
+//! Reports how many decode surfaces are mapped for HIP, and whether the eager or background mapping requested with
+//! RocDecoderCreateInfo::interop_map_mode is done. rocDecGetVideoFrame on a mapped surface does not export or import
+//! memory.
+/*****************************************************************************************************/
+extern rocDecStatus ROCDECAPI rocDecGetInteropMapStatus(rocDecDecoderHandle decoder_handle, RocdecInteropMapStatus *map_status);
+
+/*****************************************************************************************************/
+//! \fn rocDecStatus ROCDECAPI rocDecSetDecodeCompleteNotify(rocDecDecoderHandle decoder_handle, RocdecDecodeCompleteNotifyParams *notify_params)
+//! \ingroup group_amd_rocdecode
+//! Requests a callback and/or an eventfd notification for every picture submitted with rocDecDecodeFrame after this call,
+//! once it has finished decoding. One completion thread per process polls the decode status of the pictures of all
+//! decoders, so no thread has to block per stream. Passing a NULL callback with enable_event_fd 0 turns the
+//! notifications off. Pictures pending at a reconfiguration are not notified.
+/*****************************************************************************************************/
+extern rocDecStatus ROCDECAPI rocDecSetDecodeCompleteNotify(rocDecDecoderHandle decoder_handle, RocdecDecodeCompleteNotifyParams *notify_params);
+
+/*****************************************************************************************************/
+//! \fn rocDecStatus ROCDECAPI rocDecGetDecoderMemoryUsage(rocDecDecoderHandle decoder_handle, RocdecMemoryUsage *memory_usage)
+//! \ingroup group_amd_rocdecode
+//! Returns the memory held by a decoder: its decode surfaces, their HIP interop mappings and its submission queue.
+//! May be called from any thread.
+/*****************************************************************************************************/
+extern rocDecStatus ROCDECAPI rocDecGetDecoderMemoryUsage(rocDecDecoderHandle decoder_handle, RocdecMemoryUsage *memory_usage);
+
+/*****************************************************************************************************/
+//! \fn rocDecStatus ROCDECAPI rocDecGetMemoryUsage(RocdecMemoryUsage *memory_usage)
+//! \ingroup group_amd_rocdecode
+//! Returns the memory held by all decoders (including the pooled ones), parsers and bitstream readers of the process.
+/*****************************************************************************************************/
+extern rocDecStatus ROCDECAPI rocDecGetMemoryUsage(RocdecMemoryUsage *memory_usage);
+
+/*****************************************************************************************************/
+//! \fn rocDecStatus ROCDECAPI rocDecTraceEvent(const char *name, rocDecTracePhase phase, int pic_idx)
+//! \ingroup group_amd_rocdecode
+//! Records an application event into the pipeline trace, next to the events of the parser and the decoder.
+//! The pipeline trace is enabled with ROCDECODE_TRACE=1; otherwise the call does nothing.
+//! name must stay valid until the trace is dumped (e.g. a string literal); pic_idx is -1 if the event has no picture.
+/*****************************************************************************************************/
+extern rocDecStatus ROCDECAPI rocDecTraceEvent(const char *name, rocDecTracePhase phase, int pic_idx);
+
+/*****************************************************************************************************/
+//! \fn rocDecStatus ROCDECAPI rocDecTraceDump(const char *file_path)
+//! \ingroup group_amd_rocdecode
+//! Writes the pipeline trace events recorded so far as Chrome trace JSON to file_path, or to ROCDECODE_TRACE_FILE if
+//! file_path is NULL. The trace is also written at process exit. Returns ROCDEC_NOT_SUPPORTED if tracing is off.
+/*****************************************************************************************************/
+extern rocDecStatus ROCDECAPI rocDecTraceDump(const char *file_path);
+
 /*****************************************************************************************************/
 //! \fn const char* ROCDECAPI rocDecGetErrorName(rocDecStatus rocdec_status)
 //! \ingroup group_amd_rocdecode
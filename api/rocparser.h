@@ -245,8 +245,13 @@ typedef struct _RocdecParserParams {
     uint32_t error_threshold;                     /**< IN: % Error threshold (0-100) for calling pfn_decode_picture (100=always IN: call pfn_decode_picture even if picture bitstream is fully corrupted) */
     uint32_t max_display_delay;                   /**< IN: Max display queue delay (improves pipelining of decode with display) 0 = no delay (recommended values: 2..4) */
     uint32_t annex_b : 1;                         /**< IN: AV1 annexB stream                                                   */
-    uint32_t reserved : 31;                       /**< Reserved for future use - set to zero                                   */
-    uint32_t reserved_1[4];                       /**< IN: Reserved for future use - set to 0                                  */
+    uint32_t async_mode : 1;                      /**< IN: Parse on an internal worker thread: rocDecParseVideoData only queues a copy of the packet and all callbacks are called from the worker. Use rocDecFlushVideoParser to wait for the queued packets */
+    uint32_t tight_surface_pool : 1;              /**< IN: Size the decode surface pool to the minimum the active sequence needs (from its DPB and reorder parameters) plus max_display_delay, shrinking it on new sequences. The display callback must be done with a surface when it returns */
+    uint32_t auto_display_delay : 1;              /**< IN: Ignore max_display_delay and display every picture as soon as the reordering of the active sequence allows: sps_max_num_reorder_pics for HEVC, the VUI num_reorder_frames (or its inferred value) for AVC, none for AV1 and VP9 */
+    uint32_t decode_order_output : 1;             /**< IN: Ignore max_display_delay and display every picture right after it is submitted for decode, in decode order, without POC reordering. AV1 and VP9 frames are displayed as shown */
+    uint32_t reserved : 27;                       /**< Reserved for future use - set to zero                                   */
+    uint32_t async_queue_depth;                   /**< IN: Max # of packets queued in async_mode before rocDecParseVideoData blocks (0 = default of 4) */
+    uint32_t reserved_1[3];                       /**< IN: Reserved for future use - set to 0                                  */
     void *user_data;                              /**< IN: User data for callbacks                                             */
     PFNVIDSEQUENCECALLBACK pfn_sequence_callback; /**< IN: Called before decoding frames and/or whenever there is a fmt change */
     PFNVIDDECODECALLBACK pfn_decode_picture;      /**< IN: Called when a picture is ready to be decoded (decode order)         */
@@ -256,10 +261,67 @@ typedef struct _RocdecParserParams {
     RocdecVideoFormatEx *ext_video_info;          /**< IN: [Optional] sequence header data from system layer                   */
 } RocdecParserParams;
 
+/**
+ * @brief Parser event types
+ * @ingroup group_rocdec_struct
+ * Used in rocDecParseVideoDataEx API
+ */
+typedef enum rocDecParserEventType_enum {
+    rocDecParserEvent_SequenceChange = 0, /**< Initial sequence header or video format change; video_format is set     */
+    rocDecParserEvent_DecodePicture = 1,  /**< A picture is ready to be decoded (decode order); pic_params is set      */
+    rocDecParserEvent_DisplayPicture = 2, /**< A picture is ready to be displayed (display order); disp_info is set    */
+} rocDecParserEventType;
+
+/*****************************************************************************/
+//! \ingroup group_rocdec_struct
+//! \struct RocdecParserEvent
+//! Used in rocDecParseVideoDataEx API
+//! video_format is owned by the parser and stays valid until the next rocDecParseVideoDataEx call.
+//! pic_params points to a parser-owned slot holding a private copy of the picture parameters, slice parameters and
+//! bitstream data; it stays valid until it is returned with rocDecParserReleasePicParams.
+/*****************************************************************************/
+typedef struct _RocdecParserEvent {
+    rocDecParserEventType event_type; /**< OUT: rocDecParserEvent_XXX                                      */
+    uint32_t reserved;                /**< Reserved for future use                                         */
+    RocdecVideoFormat *video_format;  /**< OUT: New video format (rocDecParserEvent_SequenceChange)        */
+    RocdecPicParams *pic_params;      /**< OUT: Picture parameters (rocDecParserEvent_DecodePicture)       */
+    RocdecParserDispInfo disp_info;   /**< OUT: Display information (rocDecParserEvent_DisplayPicture)     */
+} RocdecParserEvent;
+
+/*****************************************************************************/
+//! \ingroup group_rocdec_struct
+//! \struct RocdecParserStats
+//! Used in rocDecGetParserStats API
+//! Cumulative counters of a parser since it was created. The times are in nanoseconds; parse_time_ns excludes the time
+//! spent in the callbacks, which is reported per callback.
+/*****************************************************************************/
+typedef struct _RocdecParserStats {
+    uint64_t num_packets;                     /**< OUT: Packets passed to rocDecParseVideoData(Ex), including end of stream packets */
+    uint64_t num_bytes;                       /**< OUT: Payload bytes of those packets                                          */
+    uint64_t num_units;                       /**< OUT: NAL units (AVC, HEVC), OBUs (AV1) or frames (VP9) parsed                */
+    uint64_t num_units_by_type[64];           /**< OUT: NAL units by nal_unit_type (AVC, HEVC) or OBUs by obu_type (AV1)        */
+    uint64_t num_pics_parsed;                 /**< OUT: Picture headers parsed, including pictures that only show an existing frame */
+    uint64_t num_pics_submitted;              /**< OUT: Pictures passed to pfn_decode_picture                                   */
+    uint64_t num_pics_displayed;              /**< OUT: Pictures passed to pfn_display_picture                                  */
+    uint64_t num_emulation_prevention_bytes;  /**< OUT: Emulation prevention bytes removed from parsed NAL units (AVC, HEVC)    */
+    uint64_t num_sei_bytes;                   /**< OUT: SEI payload bytes parsed (AVC, HEVC)                                    */
+    uint64_t num_sequence_changes;            /**< OUT: Activations of a new or changed sequence (calls of pfn_sequence_callback) */
+    uint32_t dpb_high_water_mark;             /**< OUT: Max number of decode surfaces held by the parser at once (DPB and display queue) */
+    uint32_t reserved;                        /**< Reserved for future use                                                      */
+    uint64_t parse_time_ns;                   /**< OUT: Time spent parsing in rocDecParseVideoData(Ex), excluding the callbacks  */
+    uint64_t sequence_callback_time_ns;       /**< OUT: Time spent in pfn_sequence_callback                                     */
+    uint64_t decode_callback_time_ns;         /**< OUT: Time spent in pfn_decode_picture                                        */
+    uint64_t display_callback_time_ns;        /**< OUT: Time spent in pfn_display_picture                                       */
+    uint64_t sei_callback_time_ns;            /**< OUT: Time spent in pfn_get_sei_msg                                           */
+    uint64_t reserved_1[16];                  /**< Reserved for future use                                                      */
+} RocdecParserStats;
+
 /************************************************************************************************/
 //! \ingroup group_rocparser
 //! \fn rocDecodeStatus ROCDECAPI rocDecCreateVideoParser(RocdecVideoParser *parser_handle, RocdecParserParams *params)
 //! Create video parser object and initialize
+//! If pfn_sequence_callback, pfn_decode_picture and pfn_display_picture are all NULL the parser is created in event
+//! mode: it is driven with rocDecParseVideoDataEx instead of rocDecParseVideoData. Event mode cannot be combined with async_mode
 /************************************************************************************************/
 extern rocDecStatus ROCDECAPI rocDecCreateVideoParser(RocdecVideoParser *parser_handle, RocdecParserParams *params);
 
@@ -272,9 +334,38 @@ extern rocDecStatus ROCDECAPI rocDecCreateVideoParser(RocdecVideoParser *parser_
 //! calls back pfn_sequence_callback with RocdecVideoFormat data for initial sequence header or when
 //! the decoder encounters a video format change
 //! calls back pfn_display_picture with RocdecParserDispInfo data to display a video frame
+//! With async_mode the packet payload is copied into the parser's bounded queue and the call returns once it is queued;
+//! the callbacks above then run on the parser worker thread, and an error may belong to an earlier queued packet
 /************************************************************************************************/
 extern rocDecStatus ROCDECAPI rocDecParseVideoData(RocdecVideoParser parser_handle, RocdecSourceDataPacket *packet);
 
+/************************************************************************************************/
+//! \ingroup group_rocparser
+//! \fn rocDecStatus ROCDECAPI rocDecParseVideoDataEx(RocdecVideoParser parser_handle, RocdecSourceDataPacket *packet,
+//!                                                    RocdecParserEvent *events, uint32_t max_events, uint32_t *num_events)
+//! Parse the video data from source data packet in packet for a parser created in event mode.
+//! Instead of calling back into the application, the parser stores the sequence changes, pictures ready for decoding
+//! and pictures ready for display in events, in the order the callbacks would have been called, and returns the number
+//! of events in num_events. Events that do not fit into max_events are kept and returned first by the next call;
+//! packet may be NULL to only fetch them.
+//! The events must be consumed in order: the surface of a rocDecParserEvent_DisplayPicture event may be reused by any
+//! rocDecParserEvent_DecodePicture event that follows it. Every pic_params must be released with rocDecParserReleasePicParams
+//! once it has been submitted, which may happen on another thread
+//! A rocDecParserEvent_SequenceChange event is returned after the parser has moved on, so unlike the return value of
+//! pfn_sequence_callback it cannot override the number of decode surfaces: the pool is sized by
+//! RocdecParserParams::max_num_decode_surfaces (or tight_surface_pool), and video_format->min_num_decode_surfaces reports
+//! the number of surfaces the new sequence needs
+/************************************************************************************************/
+extern rocDecStatus ROCDECAPI rocDecParseVideoDataEx(RocdecVideoParser parser_handle, RocdecSourceDataPacket *packet,
+                                                     RocdecParserEvent *events, uint32_t max_events, uint32_t *num_events);
+
+/************************************************************************************************/
+//! \ingroup group_rocparser
+//! \fn rocDecStatus ROCDECAPI rocDecParserReleasePicParams(RocdecVideoParser parser_handle, RocdecPicParams *pic_params)
+//! Return a pic_params slot handed out by rocDecParseVideoDataEx to the parser so it can be reused
+/************************************************************************************************/
+extern rocDecStatus ROCDECAPI rocDecParserReleasePicParams(RocdecVideoParser parser_handle, RocdecPicParams *pic_params);
+
 /************************************************************************************************/
 //! \ingroup group_rocparser
 //! \fn rocDecStatus ROCDECAPI rocDecParserMarkFrameForReuse(RocdecVideoParser parser_handle, int pic_idx)
@@ -282,6 +373,31 @@ extern rocDecStatus ROCDECAPI rocDecParseVideoData(RocdecVideoParser parser_hand
 /************************************************************************************************/
 extern rocDecStatus ROCDECAPI rocDecParserMarkFrameForReuse(RocdecVideoParser parser_handle, int pic_idx);
 
+/************************************************************************************************/
+//! \ingroup group_rocparser
+//! \fn rocDecStatus ROCDECAPI rocDecFlushVideoParser(RocdecVideoParser parser_handle)
+//! Wait until every packet queued by rocDecParseVideoData has been parsed and all of its callbacks have returned.
+//! Only parsers created with async_mode queue packets; for the others this returns immediately.
+//! Returns the first error the parser worker hit since the previous flush
+/************************************************************************************************/
+extern rocDecStatus ROCDECAPI rocDecFlushVideoParser(RocdecVideoParser parser_handle);
+
+/************************************************************************************************/
+//! \ingroup group_rocparser
+//! \fn rocDecStatus ROCDECAPI rocDecGetParserStats(RocdecVideoParser parser_handle, RocdecParserStats *parser_stats)
+//! Get the cumulative statistics of the parser. Comparing parse_time_ns with the callback times shows whether a stream
+//! is bound by the parser or by the decoder behind the callbacks. May be called from any thread, including a parser
+//! callback, without waiting for the parse: the statistics are those at the end of the last parsed packet
+/************************************************************************************************/
+extern rocDecStatus ROCDECAPI rocDecGetParserStats(RocdecVideoParser parser_handle, RocdecParserStats *parser_stats);
+
+/************************************************************************************************/
+//! \ingroup group_rocparser
+//! \fn rocDecStatus ROCDECAPI rocDecGetParserMemoryUsage(RocdecVideoParser parser_handle, RocdecMemoryUsage *memory_usage)
+//! Get the memory held by the parser in parser_bytes. The usage is updated after every packet. May be called from any thread
+/************************************************************************************************/
+extern rocDecStatus ROCDECAPI rocDecGetParserMemoryUsage(RocdecVideoParser parser_handle, RocdecMemoryUsage *memory_usage);
+
 /************************************************************************************************/
 //! \ingroup group_rocparser
 //! \fn rocDecStatus ROCDECAPI rocDecDestroyVideoParser(RocdecVideoParser parser_handle)
@@ -50,7 +50,8 @@ void ShowHelpAndExit(const char *option = NULL) {
     << "-backend backend (0 for GPU, 1 CPU-FFMpeg, 2 CPU-FFMpeg No threading); optional; default: 0" << std::endl
     << "-f Number of decoded frames - specify the number of pictures to be decoded; optional" << std::endl
     << "-z force_zero_latency (force_zero_latency, Decoded frames will be flushed out for display immediately); optional;" << std::endl
-    << "-disp_delay -specify the number of frames to be delayed for display; optional; default: 1" << std::endl
+    << "-disp_delay -specify the number of frames to be delayed for display, or auto to derive it from the stream; optional; default: 1" << std::endl
+    << "-tight_pool - allocate only the decode surfaces the stream needs plus the display delay (output memory type 0 is copied); optional;" << std::endl
     << "-sei extract SEI messages; optional;" << std::endl
     << "-md5 generate MD5 message digest on the decoded YUV image sequence; optional;" << std::endl
     << "-md5_check MD5 File Path - generate MD5 message digest on the decoded YUV image sequence and compare to the reference MD5 string in a file; optional;" << std::endl
@@ -71,9 +72,10 @@ int main(int argc, char **argv) {
     std::fstream ref_md5_file;
     int dump_output_frames = 0;
     int device_id = 0;
-    int disp_delay = 1;
+    uint32_t disp_delay = 1;
     int backend = 0;
     bool b_force_zero_latency = false;     // false by default: enabling this option might affect decoding performance
+    bool b_tight_surface_pool = false;
     bool b_extract_sei_messages = false;
     bool b_generate_md5 = false;
     bool b_md5_check = false;
@@ -131,7 +133,7 @@ int main(int argc, char **argv) {
             if (++i == argc) {
                 ShowHelpAndExit("-disp_delay");
             }
-            disp_delay = atoi(argv[i]);
+            disp_delay = strcmp(argv[i], "auto") ? atoi(argv[i]) : DISP_DELAY_AUTO;
             continue;
         }
         if (!strcmp(argv[i], "-f")) {
@@ -148,6 +150,13 @@ int main(int argc, char **argv) {
             b_force_zero_latency = true;
             continue;
         }
+        if (!strcmp(argv[i], "-tight_pool")) {
+            if (i == argc) {
+                ShowHelpAndExit("-tight_pool");
+            }
+            b_tight_surface_pool = true;
+            continue;
+        }
         if (!strcmp(argv[i], "-sei")) {
             if (i == argc) {
                 ShowHelpAndExit("-sei");
@@ -256,8 +265,15 @@ int main(int argc, char **argv) {
 
         RocVideoDecoder *viddec;
         VideoSeekContext video_seek_ctx;
+#if ROCDECODE_HOST_ONLY
+        // a host-only rocDecode has no device memory: decoded frames are always copied to host memory
+        if (mem_type == OUT_SURFACE_MEM_DEV_INTERNAL || mem_type == OUT_SURFACE_MEM_DEV_COPIED) mem_type = OUT_SURFACE_MEM_HOST_COPIED;
+#endif
+        // internal frames hold their decode surface until they are released, which a tight pool has no room for
+        if (b_tight_surface_pool && mem_type == OUT_SURFACE_MEM_DEV_INTERNAL) mem_type = OUT_SURFACE_MEM_DEV_COPIED;
         if (!backend)   // gpu backend
-            viddec = new RocVideoDecoder(device_id, mem_type, rocdec_codec_id, b_force_zero_latency, p_crop_rect, b_extract_sei_messages, disp_delay);
+            viddec = new RocVideoDecoder(device_id, mem_type, rocdec_codec_id, b_force_zero_latency, p_crop_rect, b_extract_sei_messages, disp_delay,
+                                         0, 0, 1000, b_tight_surface_pool);
         else {
             std::cout << "info: RocDecode is using CPU backend!" << std::endl;
             bool use_threading = false;
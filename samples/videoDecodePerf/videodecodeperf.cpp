@@ -270,6 +270,19 @@ int main(int argc, char **argv) {
         std::cout << "info: avg decode FPS: " << total_fps_dec  << std::endl;
         std::cout << "info: avg output/display time per frame: " << 1000 / total_fps << " ms" << std::endl;
         std::cout << "info: avg output/display FPS: " << total_fps  << std::endl;
+        for (int i = 0; i < n_thread; i++) {
+            std::cout << "info: stage latencies of decoder session " << i << ":" << std::endl;
+            v_viddec[i]->PrintStageLatencies();
+        }
+        RocdecMemoryUsage memory_usage;
+        if (rocDecGetMemoryUsage(&memory_usage) == ROCDEC_SUCCESS) {
+            uint64_t frame_buffer_bytes = 0;
+            for (int i = 0; i < n_thread; i++) {
+                frame_buffer_bytes += v_viddec[i]->GetFrameBufferMemoryUsage();
+            }
+            std::cout << "info: memory held by rocDecode: decode surfaces " << memory_usage.surface_bytes / (1024 * 1024) << " MB, parsers "
+                      << memory_usage.parser_bytes / 1024 << " KB, output frame buffers " << frame_buffer_bytes / (1024 * 1024) << " MB" << std::endl;
+        }
     } catch (const std::exception &ex) {
       std::cout << ex.what() << std::endl;
       exit(1);
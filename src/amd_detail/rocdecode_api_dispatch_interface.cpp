@@ -73,4 +73,43 @@ rocDecStatus ROCDECAPI rocDecGetBitstreamPicData(RocdecBitstreamReader bs_reader
 rocDecStatus ROCDECAPI rocDecDestroyBitstreamReader(RocdecBitstreamReader bs_reader_handle) {
     return rocdecode::GetRocDecodeDispatchTable()->pfn_rocdec_destroy_bitstream_reader(bs_reader_handle);
 }
+rocDecStatus ROCDECAPI rocDecFlushVideoParser(RocdecVideoParser parser_handle) {
+    return rocdecode::GetRocDecodeDispatchTable()->pfn_rocdec_flush_video_parser(parser_handle);
+}
+rocDecStatus ROCDECAPI rocDecParseVideoDataEx(RocdecVideoParser parser_handle, RocdecSourceDataPacket *packet, RocdecParserEvent *events, uint32_t max_events, uint32_t *num_events) {
+    return rocdecode::GetRocDecodeDispatchTable()->pfn_rocdec_parse_video_data_ex(parser_handle, packet, events, max_events, num_events);
+}
+rocDecStatus ROCDECAPI rocDecParserReleasePicParams(RocdecVideoParser parser_handle, RocdecPicParams *pic_params) {
+    return rocdecode::GetRocDecodeDispatchTable()->pfn_rocdec_parser_release_pic_params(parser_handle, pic_params);
+}
+rocDecStatus ROCDECAPI rocDecSelectDevice(RocdecDeviceSelectInfo *select_info) {
+    return rocdecode::GetRocDecodeDispatchTable()->pfn_rocdec_select_device(select_info);
+}
+rocDecStatus ROCDECAPI rocDecGetInteropMapStatus(rocDecDecoderHandle decoder_handle, RocdecInteropMapStatus *map_status) {
+    return rocdecode::GetRocDecodeDispatchTable()->pfn_rocdec_get_interop_map_status(decoder_handle, map_status);
+}
+rocDecStatus ROCDECAPI rocDecSetDecodeCompleteNotify(rocDecDecoderHandle decoder_handle, RocdecDecodeCompleteNotifyParams *notify_params) {
+    return rocdecode::GetRocDecodeDispatchTable()->pfn_rocdec_set_decode_complete_notify(decoder_handle, notify_params);
+}
+rocDecStatus ROCDECAPI rocDecTraceEvent(const char *name, rocDecTracePhase phase, int pic_idx) {
+    return rocdecode::GetRocDecodeDispatchTable()->pfn_rocdec_trace_event(name, phase, pic_idx);
+}
+rocDecStatus ROCDECAPI rocDecTraceDump(const char *file_path) {
+    return rocdecode::GetRocDecodeDispatchTable()->pfn_rocdec_trace_dump(file_path);
+}
+rocDecStatus ROCDECAPI rocDecGetParserStats(RocdecVideoParser parser_handle, RocdecParserStats *parser_stats) {
+    return rocdecode::GetRocDecodeDispatchTable()->pfn_rocdec_get_parser_stats(parser_handle, parser_stats);
+}
+rocDecStatus ROCDECAPI rocDecGetDecoderMemoryUsage(rocDecDecoderHandle decoder_handle, RocdecMemoryUsage *memory_usage) {
+    return rocdecode::GetRocDecodeDispatchTable()->pfn_rocdec_get_decoder_memory_usage(decoder_handle, memory_usage);
+}
+rocDecStatus ROCDECAPI rocDecGetParserMemoryUsage(RocdecVideoParser parser_handle, RocdecMemoryUsage *memory_usage) {
+    return rocdecode::GetRocDecodeDispatchTable()->pfn_rocdec_get_parser_memory_usage(parser_handle, memory_usage);
+}
+rocDecStatus ROCDECAPI rocDecGetBitstreamReaderMemoryUsage(RocdecBitstreamReader bs_reader_handle, RocdecMemoryUsage *memory_usage) {
+    return rocdecode::GetRocDecodeDispatchTable()->pfn_rocdec_get_bitstream_reader_memory_usage(bs_reader_handle, memory_usage);
+}
+rocDecStatus ROCDECAPI rocDecGetMemoryUsage(RocdecMemoryUsage *memory_usage) {
+    return rocdecode::GetRocDecodeDispatchTable()->pfn_rocdec_get_memory_usage(memory_usage);
+}
 
@@ -0,0 +1,207 @@
+/*
+Copyright (c) 2023 - 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include "../commons.h"
+#include "rocdecode_api_interposer.h"
+
+namespace {
+uint64_t ApiTimeNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+constexpr size_t GetApiIndex(size_t table_offset) {
+    return (table_offset - offsetof(RocDecodeDispatchTable, pfn_rocdec_create_video_parser)) / sizeof(void *);
+}
+
+// One wrapper per dispatch table entry: times the call into the function that was in the entry before Install().
+template <size_t Index, typename Fn> struct ApiWrapper;
+template <size_t Index, typename Ret, typename... Args> struct ApiWrapper<Index, Ret (ROCDECAPI *)(Args...)> {
+    static inline Ret (ROCDECAPI *next)(Args...) = nullptr;
+    static Ret ROCDECAPI Call(Args... args) {
+        uint64_t start_time = ApiTimeNs();
+        Ret ret = next(args...);
+        RocDecodeApiInterposer::GetInstance().RecordCall(Index, ApiTimeNs() - start_time);
+        return ret;
+    }
+};
+
+template <size_t Index, typename Fn> void Interpose(Fn *entry) {
+    ApiWrapper<Index, Fn>::next = *entry;
+    *entry = &ApiWrapper<Index, Fn>::Call;
+}
+} //namespace
+
+#define ROCDEC_INTERPOSE(ENTRY, NAME) \
+    do { \
+        constexpr size_t api_index = GetApiIndex(offsetof(RocDecodeDispatchTable, ENTRY)); \
+        Interpose<api_index>(&dispatch_table->ENTRY); \
+        api_names_[api_index] = NAME; \
+    } while (0)
+
+RocDecodeApiInterposer::RocDecodeApiInterposer() {
+    char *api_stats = std::getenv("ROCDECODE_API_STATS");
+    if (api_stats == nullptr || std::atoi(api_stats) <= 0) {
+        return;
+    }
+    level_ = std::atoi(api_stats);
+    char *file_path = std::getenv("ROCDECODE_API_STATS_FILE");
+    if (file_path != nullptr) {
+        file_path_ = file_path;
+    }
+    enabled_ = true;
+}
+
+RocDecodeApiInterposer::~RocDecodeApiInterposer() {
+    if (enabled_) {
+        enabled_ = false;
+        PrintSummary();
+    }
+}
+
+void RocDecodeApiInterposer::Install(RocDecodeDispatchTable *dispatch_table) {
+    if (!IsEnabled()) {
+        return;
+    }
+    ROCDEC_INTERPOSE(pfn_rocdec_create_video_parser, "rocDecCreateVideoParser");
+    ROCDEC_INTERPOSE(pfn_rocdec_parse_video_data, "rocDecParseVideoData");
+    ROCDEC_INTERPOSE(pfn_rocdec_destroy_video_parser, "rocDecDestroyVideoParser");
+    ROCDEC_INTERPOSE(pfn_rocdec_create_decoder, "rocDecCreateDecoder");
+    ROCDEC_INTERPOSE(pfn_rocdec_destroy_decoder, "rocDecDestroyDecoder");
+    ROCDEC_INTERPOSE(pfn_rocdec_get_gecoder_caps, "rocDecGetDecoderCaps");
+    ROCDEC_INTERPOSE(pfn_rocdec_decode_frame, "rocDecDecodeFrame");
+    ROCDEC_INTERPOSE(pfn_rocdec_get_decode_status, "rocDecGetDecodeStatus");
+    ROCDEC_INTERPOSE(pfn_rocdec_reconfigure_decoder, "rocDecReconfigureDecoder");
+    ROCDEC_INTERPOSE(pfn_rocdec_get_video_frame, "rocDecGetVideoFrame");
+    ROCDEC_INTERPOSE(pfn_rocdec_get_error_name, "rocDecGetErrorName");
+    ROCDEC_INTERPOSE(pfn_rocdec_create_bitstream_reader, "rocDecCreateBitstreamReader");
+    ROCDEC_INTERPOSE(pfn_rocdec_get_bitstream_codec_type, "rocDecGetBitstreamCodecType");
+    ROCDEC_INTERPOSE(pfn_rocdec_get_bitstream_bit_depth, "rocDecGetBitstreamBitDepth");
+    ROCDEC_INTERPOSE(pfn_rocdec_get_bitstream_pic_data, "rocDecGetBitstreamPicData");
+    ROCDEC_INTERPOSE(pfn_rocdec_destroy_bitstream_reader, "rocDecDestroyBitstreamReader");
+    ROCDEC_INTERPOSE(pfn_rocdec_flush_video_parser, "rocDecFlushVideoParser");
+    ROCDEC_INTERPOSE(pfn_rocdec_parse_video_data_ex, "rocDecParseVideoDataEx");
+    ROCDEC_INTERPOSE(pfn_rocdec_parser_release_pic_params, "rocDecParserReleasePicParams");
+    ROCDEC_INTERPOSE(pfn_rocdec_select_device, "rocDecSelectDevice");
+    ROCDEC_INTERPOSE(pfn_rocdec_get_interop_map_status, "rocDecGetInteropMapStatus");
+    ROCDEC_INTERPOSE(pfn_rocdec_set_decode_complete_notify, "rocDecSetDecodeCompleteNotify");
+    ROCDEC_INTERPOSE(pfn_rocdec_trace_event, "rocDecTraceEvent");
+    ROCDEC_INTERPOSE(pfn_rocdec_trace_dump, "rocDecTraceDump");
+    ROCDEC_INTERPOSE(pfn_rocdec_get_parser_stats, "rocDecGetParserStats");
+    ROCDEC_INTERPOSE(pfn_rocdec_get_decoder_memory_usage, "rocDecGetDecoderMemoryUsage");
+    ROCDEC_INTERPOSE(pfn_rocdec_get_parser_memory_usage, "rocDecGetParserMemoryUsage");
+    ROCDEC_INTERPOSE(pfn_rocdec_get_bitstream_reader_memory_usage, "rocDecGetBitstreamReaderMemoryUsage");
+    ROCDEC_INTERPOSE(pfn_rocdec_get_memory_usage, "rocDecGetMemoryUsage");
+    for (size_t i = 0; i < kNumApis; i++) {
+        if (api_names_[i] == nullptr) {
+            ERR("The API latency interposer does not wrap dispatch table entry " + TOSTR(i));
+        }
+    }
+}
+
+RocDecodeApiInterposer::ThreadStats *RocDecodeApiInterposer::GetThreadStats() {
+    thread_local ThreadStats *thread_stats = nullptr;
+    if (thread_stats == nullptr) {
+        std::unique_ptr<ThreadStats> stats = std::make_unique<ThreadStats>();
+        stats->tid = static_cast<uint32_t>(syscall(SYS_gettid));
+        thread_stats = stats.get();
+        std::lock_guard<std::mutex> lock(mutex_);
+        thread_stats_.push_back(std::move(stats));
+    }
+    return thread_stats;
+}
+
+void RocDecodeApiInterposer::RecordCall(size_t api_index, uint64_t latency_ns) {
+    if (!IsEnabled()) {
+        return;
+    }
+    LatencyHistogram &histogram = GetThreadStats()->histograms[api_index];
+    std::atomic<uint64_t> &bucket = histogram.buckets[RocDecLatencyBuckets::GetBucketIndex(latency_ns)];
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    histogram.num_calls.store(histogram.num_calls.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    histogram.total_ns.store(histogram.total_ns.load(std::memory_order_relaxed) + latency_ns, std::memory_order_relaxed);
+    if (latency_ns > histogram.max_ns.load(std::memory_order_relaxed)) {
+        histogram.max_ns.store(latency_ns, std::memory_order_relaxed);
+    }
+}
+
+void RocDecodeApiInterposer::MergeHistogram(const LatencyHistogram &histogram, LatencySummary *summary) {
+    summary->num_calls += histogram.num_calls.load(std::memory_order_relaxed);
+    summary->total_ns += histogram.total_ns.load(std::memory_order_relaxed);
+    summary->max_ns = std::max(summary->max_ns, histogram.max_ns.load(std::memory_order_relaxed));
+    for (uint32_t i = 0; i < kNumBuckets; i++) {
+        summary->buckets[i] += histogram.buckets[i].load(std::memory_order_relaxed);
+    }
+}
+
+uint64_t RocDecodeApiInterposer::GetPercentile(const LatencySummary &summary, double percentile) {
+    return RocDecLatencyBuckets::GetPercentile(summary.buckets.data(), summary.max_ns, percentile);
+}
+
+void RocDecodeApiInterposer::PrintSummaryRow(FILE *fp, const char *name, const LatencySummary &summary) {
+    fprintf(fp, "%-32s %10llu %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f\n", name, static_cast<unsigned long long>(summary.num_calls),
+            summary.total_ns / 1000.0 / summary.num_calls, GetPercentile(summary, 50) / 1000.0, GetPercentile(summary, 90) / 1000.0,
+            GetPercentile(summary, 99) / 1000.0, GetPercentile(summary, 99.9) / 1000.0, summary.max_ns / 1000.0);
+}
+
+void RocDecodeApiInterposer::PrintSummary() {
+    FILE *fp = stderr;
+    if (!file_path_.empty()) {
+        fp = fopen(file_path_.c_str(), "w");
+        if (fp == nullptr) {
+            ERR("Failed to open the API statistics file " + file_path_);
+            return;
+        }
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    fprintf(fp, "rocDecode API latency summary (pid %d, %zu threads), times in us\n", getpid(), thread_stats_.size());
+    fprintf(fp, "%-32s %10s %10s %10s %10s %10s %10s %10s\n", "API", "calls", "mean", "p50", "p90", "p99", "p99.9", "max");
+    for (size_t api_index = 0; api_index < kNumApis; api_index++) {
+        LatencySummary summary;
+        for (auto &stats : thread_stats_) {
+            MergeHistogram(stats->histograms[api_index], &summary);
+        }
+        if (summary.num_calls == 0) {
+            continue;
+        }
+        PrintSummaryRow(fp, api_names_[api_index], summary);
+        if (level_ > 1) {
+            for (auto &stats : thread_stats_) {
+                LatencySummary thread_summary;
+                MergeHistogram(stats->histograms[api_index], &thread_summary);
+                if (thread_summary.num_calls > 0) {
+                    std::string name = "  tid " + std::to_string(stats->tid);
+                    PrintSummaryRow(fp, name.c_str(), thread_summary);
+                }
+            }
+        }
+    }
+    if (fp != stderr) {
+        fclose(fp);
+    }
+}
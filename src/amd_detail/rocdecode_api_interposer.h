@@ -0,0 +1,96 @@
+/*
+Copyright (c) 2023 - 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "../../api/amd_detail/rocdecode_api_trace.h"
+#include "../../api/amd_detail/rocdecode_latency_histogram.h"
+
+/*! \brief In-library interposer that measures the latency of every rocDecode API call.
+ *
+ * Off unless ROCDECODE_API_STATS is set. When enabled, Install() replaces every entry of the dispatch table with a
+ * wrapper that times the call into the runtime implementation. Every thread counts its calls in its own log-linear
+ * (HDR-style) histograms with the buckets of RocDecLatencyBuckets, so a percentile is accurate to 1/16 of its value. The summary of every API (calls, mean, p50/p90/p99/p99.9, max) is written to
+ * ROCDECODE_API_STATS_FILE (default stderr) at process exit; ROCDECODE_API_STATS=2 adds a breakdown per thread.
+ */
+class RocDecodeApiInterposer {
+public:
+    static constexpr size_t kNumApis = (sizeof(RocDecodeDispatchTable) - sizeof(size_t)) / sizeof(void *);
+
+    static RocDecodeApiInterposer& GetInstance() {
+        static RocDecodeApiInterposer instance;
+        return instance;
+    }
+    bool IsEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+    /*! \brief Wraps every entry of the dispatch table; the table must have been filled with the runtime implementation.
+     */
+    void Install(RocDecodeDispatchTable *dispatch_table);
+    /*! \brief Adds a call of api_index (the entry index in the dispatch table) that took latency_ns to the calling thread's histogram.
+     */
+    void RecordCall(size_t api_index, uint64_t latency_ns);
+
+private:
+    static constexpr uint32_t kNumBuckets = RocDecLatencyBuckets::kNumBuckets;
+
+    struct LatencyHistogram {
+        // only written by the owner thread: relaxed loads and stores, no read-modify-write
+        std::atomic<uint64_t> num_calls{0};
+        std::atomic<uint64_t> total_ns{0};
+        std::atomic<uint64_t> max_ns{0};
+        std::atomic<uint64_t> buckets[kNumBuckets] = {};
+    };
+    // owned by the interposer and written by one thread only
+    struct ThreadStats {
+        uint32_t tid;
+        LatencyHistogram histograms[kNumApis];
+    };
+    // a merged copy used for the summary
+    struct LatencySummary {
+        uint64_t num_calls = 0;
+        uint64_t total_ns = 0;
+        uint64_t max_ns = 0;
+        std::vector<uint64_t> buckets = std::vector<uint64_t>(kNumBuckets, 0);
+    };
+
+    RocDecodeApiInterposer();
+    ~RocDecodeApiInterposer();
+    RocDecodeApiInterposer(const RocDecodeApiInterposer&) = delete;
+    RocDecodeApiInterposer& operator=(const RocDecodeApiInterposer&) = delete;
+    ThreadStats *GetThreadStats();
+    static uint64_t GetPercentile(const LatencySummary &summary, double percentile);
+    void MergeHistogram(const LatencyHistogram &histogram, LatencySummary *summary);
+    void PrintSummaryRow(FILE *fp, const char *name, const LatencySummary &summary);
+    void PrintSummary();
+
+    std::atomic<bool> enabled_{false};
+    int level_ = 0;
+    std::string file_path_;
+    const char *api_names_[kNumApis] = {};
+    std::mutex mutex_; // guards thread_stats_
+    std::vector<std::unique_ptr<ThreadStats>> thread_stats_;
+};
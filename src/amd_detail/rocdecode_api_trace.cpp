@@ -20,6 +20,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 */
 #include "../../api/amd_detail/rocdecode_api_trace.h"
+#include "rocdecode_api_interposer.h"
 
 #if defined(ROCDECODE_ROCPROFILER_REGISTER) && ROCDECODE_ROCPROFILER_REGISTER > 0
 #include <rocprofiler-register/rocprofiler-register.h>
@@ -50,6 +51,19 @@ rocDecStatus ROCDECAPI rocDecGetBitstreamCodecType(RocdecBitstreamReader bs_read
 rocDecStatus ROCDECAPI rocDecGetBitstreamBitDepth(RocdecBitstreamReader bs_reader_handle, int *bit_depth);
 rocDecStatus ROCDECAPI rocDecGetBitstreamPicData(RocdecBitstreamReader bs_reader_handle, uint8_t **pic_data, int *pic_size, int64_t *pts);
 rocDecStatus ROCDECAPI rocDecDestroyBitstreamReader(RocdecBitstreamReader bs_reader_handle);
+rocDecStatus ROCDECAPI rocDecFlushVideoParser(RocdecVideoParser parser_handle);
+rocDecStatus ROCDECAPI rocDecParseVideoDataEx(RocdecVideoParser parser_handle, RocdecSourceDataPacket *packet, RocdecParserEvent *events, uint32_t max_events, uint32_t *num_events);
+rocDecStatus ROCDECAPI rocDecParserReleasePicParams(RocdecVideoParser parser_handle, RocdecPicParams *pic_params);
+rocDecStatus ROCDECAPI rocDecSelectDevice(RocdecDeviceSelectInfo *select_info);
+rocDecStatus ROCDECAPI rocDecGetInteropMapStatus(rocDecDecoderHandle decoder_handle, RocdecInteropMapStatus *map_status);
+rocDecStatus ROCDECAPI rocDecSetDecodeCompleteNotify(rocDecDecoderHandle decoder_handle, RocdecDecodeCompleteNotifyParams *notify_params);
+rocDecStatus ROCDECAPI rocDecTraceEvent(const char *name, rocDecTracePhase phase, int pic_idx);
+rocDecStatus ROCDECAPI rocDecTraceDump(const char *file_path);
+rocDecStatus ROCDECAPI rocDecGetParserStats(RocdecVideoParser parser_handle, RocdecParserStats *parser_stats);
+rocDecStatus ROCDECAPI rocDecGetDecoderMemoryUsage(rocDecDecoderHandle decoder_handle, RocdecMemoryUsage *memory_usage);
+rocDecStatus ROCDECAPI rocDecGetParserMemoryUsage(RocdecVideoParser parser_handle, RocdecMemoryUsage *memory_usage);
+rocDecStatus ROCDECAPI rocDecGetBitstreamReaderMemoryUsage(RocdecBitstreamReader bs_reader_handle, RocdecMemoryUsage *memory_usage);
+rocDecStatus ROCDECAPI rocDecGetMemoryUsage(RocdecMemoryUsage *memory_usage);
 }
 
 namespace rocdecode {
@@ -72,6 +86,19 @@ void UpdateDispatchTable(RocDecodeDispatchTable* ptr_dispatch_table) {
     ptr_dispatch_table->pfn_rocdec_get_bitstream_bit_depth = rocdecode::rocDecGetBitstreamBitDepth;
     ptr_dispatch_table->pfn_rocdec_get_bitstream_pic_data = rocdecode::rocDecGetBitstreamPicData;
     ptr_dispatch_table->pfn_rocdec_destroy_bitstream_reader = rocdecode::rocDecDestroyBitstreamReader;
+    ptr_dispatch_table->pfn_rocdec_flush_video_parser = rocdecode::rocDecFlushVideoParser;
+    ptr_dispatch_table->pfn_rocdec_parse_video_data_ex = rocdecode::rocDecParseVideoDataEx;
+    ptr_dispatch_table->pfn_rocdec_parser_release_pic_params = rocdecode::rocDecParserReleasePicParams;
+    ptr_dispatch_table->pfn_rocdec_select_device = rocdecode::rocDecSelectDevice;
+    ptr_dispatch_table->pfn_rocdec_get_interop_map_status = rocdecode::rocDecGetInteropMapStatus;
+    ptr_dispatch_table->pfn_rocdec_set_decode_complete_notify = rocdecode::rocDecSetDecodeCompleteNotify;
+    ptr_dispatch_table->pfn_rocdec_trace_event = rocdecode::rocDecTraceEvent;
+    ptr_dispatch_table->pfn_rocdec_trace_dump = rocdecode::rocDecTraceDump;
+    ptr_dispatch_table->pfn_rocdec_get_parser_stats = rocdecode::rocDecGetParserStats;
+    ptr_dispatch_table->pfn_rocdec_get_decoder_memory_usage = rocdecode::rocDecGetDecoderMemoryUsage;
+    ptr_dispatch_table->pfn_rocdec_get_parser_memory_usage = rocdecode::rocDecGetParserMemoryUsage;
+    ptr_dispatch_table->pfn_rocdec_get_bitstream_reader_memory_usage = rocdecode::rocDecGetBitstreamReaderMemoryUsage;
+    ptr_dispatch_table->pfn_rocdec_get_memory_usage = rocdecode::rocDecGetMemoryUsage;
 }
 
 #if ROCDECODE_ROCPROFILER_REGISTER > 0
@@ -112,6 +139,8 @@ template <typename Tp> Tp& GetDispatchTableImpl() {
     static auto dispatch_table = Tp{};
     // Update all function pointers to reference the runtime implementation functions of rocDecode.
     UpdateDispatchTable(&dispatch_table);
+    // Wrap the function pointers with the latency interposer when ROCDECODE_API_STATS is set.
+    RocDecodeApiInterposer::GetInstance().Install(&dispatch_table);
     // The profiler registration process may encapsulate the function pointers.
     ToolInit(&dispatch_table);
     return dispatch_table;
@@ -172,14 +201,35 @@ ROCDECODE_ENFORCE_ABI(RocDecodeDispatchTable, pfn_rocdec_get_bitstream_bit_depth
 ROCDECODE_ENFORCE_ABI(RocDecodeDispatchTable, pfn_rocdec_get_bitstream_pic_data, 14)
 ROCDECODE_ENFORCE_ABI(RocDecodeDispatchTable, pfn_rocdec_destroy_bitstream_reader, 15)
 // ROCDECODE_RUNTIME_API_TABLE_STEP_VERSION == 2
+ROCDECODE_ENFORCE_ABI(RocDecodeDispatchTable, pfn_rocdec_flush_video_parser, 16)
+// ROCDECODE_RUNTIME_API_TABLE_STEP_VERSION == 3
+ROCDECODE_ENFORCE_ABI(RocDecodeDispatchTable, pfn_rocdec_parse_video_data_ex, 17)
+ROCDECODE_ENFORCE_ABI(RocDecodeDispatchTable, pfn_rocdec_parser_release_pic_params, 18)
+// ROCDECODE_RUNTIME_API_TABLE_STEP_VERSION == 4
+ROCDECODE_ENFORCE_ABI(RocDecodeDispatchTable, pfn_rocdec_select_device, 19)
+// ROCDECODE_RUNTIME_API_TABLE_STEP_VERSION == 5
+ROCDECODE_ENFORCE_ABI(RocDecodeDispatchTable, pfn_rocdec_get_interop_map_status, 20)
+// ROCDECODE_RUNTIME_API_TABLE_STEP_VERSION == 6
+ROCDECODE_ENFORCE_ABI(RocDecodeDispatchTable, pfn_rocdec_set_decode_complete_notify, 21)
+// ROCDECODE_RUNTIME_API_TABLE_STEP_VERSION == 7
+ROCDECODE_ENFORCE_ABI(RocDecodeDispatchTable, pfn_rocdec_trace_event, 22)
+ROCDECODE_ENFORCE_ABI(RocDecodeDispatchTable, pfn_rocdec_trace_dump, 23)
+// ROCDECODE_RUNTIME_API_TABLE_STEP_VERSION == 8
+ROCDECODE_ENFORCE_ABI(RocDecodeDispatchTable, pfn_rocdec_get_parser_stats, 24)
+// ROCDECODE_RUNTIME_API_TABLE_STEP_VERSION == 9
+ROCDECODE_ENFORCE_ABI(RocDecodeDispatchTable, pfn_rocdec_get_decoder_memory_usage, 25)
+ROCDECODE_ENFORCE_ABI(RocDecodeDispatchTable, pfn_rocdec_get_parser_memory_usage, 26)
+ROCDECODE_ENFORCE_ABI(RocDecodeDispatchTable, pfn_rocdec_get_bitstream_reader_memory_usage, 27)
+ROCDECODE_ENFORCE_ABI(RocDecodeDispatchTable, pfn_rocdec_get_memory_usage, 28)
+// ROCDECODE_RUNTIME_API_TABLE_STEP_VERSION == 10
 
 // If ROCDECODE_ENFORCE_ABI entries are added for each new function pointer in the table,
 // the number below will be one greater than the number in the last ROCDECODE_ENFORCE_ABI line. For example:
 //  ROCDECODE_ENFORCE_ABI(<table>, <functor>, 15)
 //  ROCDECODE_ENFORCE_ABI_VERSIONING(<table>, 16) <- 15 + 1 = 16
-ROCDECODE_ENFORCE_ABI_VERSIONING(RocDecodeDispatchTable, 16)
+ROCDECODE_ENFORCE_ABI_VERSIONING(RocDecodeDispatchTable, 29)
 
-static_assert(ROCDECODE_RUNTIME_API_TABLE_MAJOR_VERSION == 0 && ROCDECODE_RUNTIME_API_TABLE_STEP_VERSION == 1,
+static_assert(ROCDECODE_RUNTIME_API_TABLE_MAJOR_VERSION == 0 && ROCDECODE_RUNTIME_API_TABLE_STEP_VERSION == 9,
               "If you encounter this error, add the new ROCDECODE_ENFORCE_ABI(...) code for the updated function pointers, "
               "and then modify this check to ensure it evaluates to true.");
 #endif
\ No newline at end of file
@@ -25,20 +25,29 @@ THE SOFTWARE.
 #include <string>
 #include "roc_bitstream_reader.h"
 #include "es_reader.h"
+#include "../metrics/roc_memory_account.h"
 
 class RocBitstreamReaderHandle {
 public:
-    explicit RocBitstreamReaderHandle(const char *input_file_path) : bs_reader_(std::make_shared<RocVideoESParser>(input_file_path)) {};
+    explicit RocBitstreamReaderHandle(const char *input_file_path) : bs_reader_(std::make_shared<RocVideoESParser>(input_file_path)) {
+        memory_account_.Set(kMemBitstreamReader, bs_reader_->GetMemoryUsage());
+    };
     ~RocBitstreamReaderHandle() { ClearErrors(); }
     bool NoError() { return error_.empty(); }
     const char* ErrorMsg() { return error_.c_str(); }
     void CaptureError(const std::string& err_msg) { error_ = err_msg; }
     rocDecStatus GetBitstreamCodecType(rocDecVideoCodec *codec_type) { *codec_type = bs_reader_->GetCodecId(); return ROCDEC_SUCCESS; }
     rocDecStatus GetBitstreamBitDepth(int *bit_depth) { *bit_depth = bs_reader_->GetBitDepth(); return ROCDEC_SUCCESS; }
-    rocDecStatus GetBitstreamPicData(uint8_t **pic_data, int *pic_size, int64_t *pts) { return static_cast<rocDecStatus>(bs_reader_->GetPicData(pic_data, pic_size, pts)); }
+    rocDecStatus GetBitstreamPicData(uint8_t **pic_data, int *pic_size, int64_t *pts) {
+        rocDecStatus ret = static_cast<rocDecStatus>(bs_reader_->GetPicData(pic_data, pic_size, pts));
+        memory_account_.Set(kMemBitstreamReader, bs_reader_->GetMemoryUsage());
+        return ret;
+    }
+    rocDecStatus GetMemoryUsage(RocdecMemoryUsage *memory_usage) { memory_account_.GetUsage(memory_usage); return ROCDEC_SUCCESS; }
 
 private:
     std::shared_ptr<RocVideoESParser> bs_reader_ = nullptr;
+    RocDecMemoryAccount memory_account_;
     void ClearErrors() { error_ = ""; }
 
     std::string error_;
@@ -64,6 +64,10 @@ class RocVideoESParser {
          */
         int GetBitDepth() {return bit_depth_;};
 
+        /*! \brief Function to return the bytes held by the reader: the stream ring and the picture buffer
+         */
+        size_t GetMemoryUsage() { return sizeof(RocVideoESParser) + pic_data_.capacity(); };
+
     private:
         std::ifstream p_stream_file_;
         int stream_type_;
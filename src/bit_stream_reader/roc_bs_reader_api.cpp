@@ -91,6 +91,14 @@ rocDecStatus ROCDECAPI rocDecGetBitstreamPicData(RocdecBitstreamReader bs_reader
     return ret;
 }
 
+rocDecStatus ROCDECAPI rocDecGetBitstreamReaderMemoryUsage(RocdecBitstreamReader bs_reader_handle, RocdecMemoryUsage *memory_usage) {
+    if (bs_reader_handle == nullptr || memory_usage == nullptr) {
+        return ROCDEC_INVALID_PARAMETER;
+    }
+    auto roc_bs_reader_handle = static_cast<RocBitstreamReaderHandle*>(bs_reader_handle);
+    return roc_bs_reader_handle->GetMemoryUsage(memory_usage);
+}
+
 rocDecStatus ROCDECAPI rocDecDestroyBitstreamReader(RocdecBitstreamReader bs_reader_handle) {
     if (bs_reader_handle == nullptr) {
         return ROCDEC_INVALID_PARAMETER;
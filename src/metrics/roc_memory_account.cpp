@@ -0,0 +1,67 @@
+/*
+Copyright (c) 2023 - 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <cstring>
+#include "roc_memory_account.h"
+
+std::atomic<uint64_t> RocDecMemoryAccount::process_bytes_[kMemNumCategories] = {};
+
+RocDecMemoryAccount::~RocDecMemoryAccount() {
+    for (int i = 0; i < kMemNumCategories; i++) {
+        process_bytes_[i].fetch_sub(bytes_[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+}
+
+void RocDecMemoryAccount::Set(RocDecMemoryCategory category, uint64_t bytes) {
+    uint64_t old_bytes = bytes_[category].exchange(bytes, std::memory_order_relaxed);
+    // unsigned wrap-around turns a decrease into the matching subtraction
+    process_bytes_[category].fetch_add(bytes - old_bytes, std::memory_order_relaxed);
+}
+
+void RocDecMemoryAccount::Add(RocDecMemoryCategory category, int64_t bytes) {
+    bytes_[category].fetch_add(static_cast<uint64_t>(bytes), std::memory_order_relaxed);
+    process_bytes_[category].fetch_add(static_cast<uint64_t>(bytes), std::memory_order_relaxed);
+}
+
+void RocDecMemoryAccount::FillUsage(const std::atomic<uint64_t> *bytes, RocdecMemoryUsage *memory_usage) {
+    uint64_t category_bytes[kMemNumCategories];
+    for (int i = 0; i < kMemNumCategories; i++) {
+        category_bytes[i] = bytes[i].load(std::memory_order_relaxed);
+    }
+    memset(memory_usage, 0, sizeof(RocdecMemoryUsage));
+    memory_usage->surface_bytes = category_bytes[kMemDeviceSurfaces] + category_bytes[kMemHostSurfaces];
+    memory_usage->interop_bytes = category_bytes[kMemInterop];
+    memory_usage->decode_queue_bytes = category_bytes[kMemDecodeQueue];
+    memory_usage->parser_bytes = category_bytes[kMemParser] + category_bytes[kMemParserQueue];
+    memory_usage->bitstream_reader_bytes = category_bytes[kMemBitstreamReader];
+    memory_usage->device_bytes = category_bytes[kMemDeviceSurfaces];
+    memory_usage->host_bytes = category_bytes[kMemHostSurfaces] + memory_usage->decode_queue_bytes + memory_usage->parser_bytes +
+                               memory_usage->bitstream_reader_bytes;
+}
+
+void RocDecMemoryAccount::GetUsage(RocdecMemoryUsage *memory_usage) const {
+    FillUsage(bytes_, memory_usage);
+}
+
+void RocDecMemoryAccount::GetProcessUsage(RocdecMemoryUsage *memory_usage) {
+    FillUsage(process_bytes_, memory_usage);
+}
@@ -0,0 +1,65 @@
+/*
+Copyright (c) 2023 - 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include "../../api/rocdecode.h"
+
+enum RocDecMemoryCategory {
+    kMemDeviceSurfaces = 0,  // VA-API decode surfaces
+    kMemHostSurfaces,        // host-memory decode surfaces of the null backend
+    kMemInterop,             // decode surfaces mapped for HIP
+    kMemDecodeQueue,         // pictures queued for asynchronous submission
+    kMemParser,              // buffers of the codec parser
+    kMemParserQueue,         // packets queued for the async parser and event-mode picture parameters
+    kMemBitstreamReader,     // stream ring and picture buffer of the bitstream reader
+    kMemNumCategories
+};
+
+/*! \brief Bytes of memory held by one decoder, parser or bitstream reader, per category.
+ *
+ * Every change is also applied to process-wide totals, so rocDecGetMemoryUsage needs no list of the live handles.
+ * The destructor returns whatever the handle still holds. The counters are atomics: they may be updated from the
+ * threads of the handle (e.g. the background interop mapping) while another thread reads them.
+ */
+class RocDecMemoryAccount {
+public:
+    RocDecMemoryAccount() = default;
+    ~RocDecMemoryAccount();
+    RocDecMemoryAccount(const RocDecMemoryAccount&) = delete;
+    RocDecMemoryAccount& operator=(const RocDecMemoryAccount&) = delete;
+    /*! \brief Sets the bytes the handle holds in category
+     */
+    void Set(RocDecMemoryCategory category, uint64_t bytes);
+    /*! \brief Adds bytes (which may be negative) to the bytes the handle holds in category
+     */
+    void Add(RocDecMemoryCategory category, int64_t bytes);
+    void GetUsage(RocdecMemoryUsage *memory_usage) const;
+    static void GetProcessUsage(RocdecMemoryUsage *memory_usage);
+
+private:
+    static void FillUsage(const std::atomic<uint64_t> *bytes, RocdecMemoryUsage *memory_usage);
+    static std::atomic<uint64_t> process_bytes_[kMemNumCategories];
+    std::atomic<uint64_t> bytes_[kMemNumCategories] = {};
+};
@@ -0,0 +1,142 @@
+/*
+Copyright (c) 2023 - 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "../commons.h"
+#include "../../api/rocdecode.h"
+#include "roc_metrics_publisher.h"
+
+#define METRICS_SHM_ENV "ROCDECODE_METRICS_SHM"
+
+static bool MetricsEnabled() {
+    static const bool enabled = [] {
+        char *metrics_shm = std::getenv(METRICS_SHM_ENV);
+        return metrics_shm != nullptr && std::atoi(metrics_shm) != 0;
+    }();
+    return enabled;
+}
+
+uint64_t RocDecMetricsPublisher::GetTimeNs() {
+    // steady_clock is CLOCK_MONOTONIC, which the monitors in other processes read as well
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+std::unique_ptr<RocDecMetricsPublisher> RocDecMetricsPublisher::Create(rocDecMetricsSessionType session_type, int device_id, uint32_t codec_type) {
+    if (!MetricsEnabled()) {
+        return nullptr;
+    }
+    static std::atomic<uint32_t> next_session_id{0};
+    uint32_t session_id = next_session_id++;
+    std::string name = ROCDECODE_METRICS_SHM_PREFIX + std::to_string(getpid()) + "." + std::to_string(session_id);
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        ERR("Failed to create the metrics segment " + name + ": " + strerror(errno));
+        return nullptr;
+    }
+    void *addr = MAP_FAILED;
+    if (ftruncate(fd, sizeof(RocdecMetricsSegment)) == 0) {
+        addr = mmap(nullptr, sizeof(RocdecMetricsSegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (addr == MAP_FAILED) {
+        ERR("Failed to map the metrics segment " + name + ": " + strerror(errno));
+        shm_unlink(name.c_str());
+        return nullptr;
+    }
+    // the segment is zero-filled by ftruncate; the magic is stored last so that a monitor never sees a partial header
+    RocdecMetricsSegment *segment = static_cast<RocdecMetricsSegment *>(addr);
+    segment->version = ROCDECODE_METRICS_VERSION;
+    segment->size = sizeof(RocdecMetricsSegment);
+    segment->session_type = session_type;
+    segment->pid = getpid();
+    segment->session_id = session_id;
+    segment->device_id = device_id;
+    segment->codec_type = codec_type;
+    segment->start_time_ns = segment->update_time_ns = GetTimeNs();
+    __atomic_store_n(&segment->magic, ROCDECODE_METRICS_MAGIC, __ATOMIC_RELEASE);
+
+    std::unique_ptr<RocDecMetricsPublisher> publisher(new RocDecMetricsPublisher(segment, name));
+    publisher->window_start_ns_ = segment->start_time_ns;
+    return publisher;
+}
+
+RocDecMetricsPublisher::~RocDecMetricsPublisher() {
+    munmap(segment_, sizeof(RocdecMetricsSegment));
+    shm_unlink(name_.c_str());
+}
+
+void RocDecMetricsPublisher::UpdateFrameRate() {
+    uint64_t now = GetTimeNs();
+    Store(&RocdecMetricsSegment::update_time_ns, now);
+    uint64_t elapsed_ns = now - window_start_ns_;
+    if (elapsed_ns >= 1000000000ull) {
+        uint64_t num_frames = __atomic_load_n(&segment_->num_frames, __ATOMIC_RELAXED);
+        Store(&RocdecMetricsSegment::fps_milli, (num_frames - window_start_frames_) * 1000000000000ull / elapsed_ns);
+        window_start_ns_ = now;
+        window_start_frames_ = num_frames;
+    }
+}
+
+bool RocDecMetricsPublisher::ClearSurfaceBit(std::atomic<uint64_t> *bits, int pic_idx) {
+    uint64_t mask = 1ull << (pic_idx % 64);
+    return (bits[pic_idx / 64].fetch_and(~mask, std::memory_order_relaxed) & mask) != 0;
+}
+
+void RocDecMetricsPublisher::SurfaceSubmitted(int pic_idx) {
+    if (pic_idx < 0 || pic_idx >= kMaxTrackedSurfaces) {
+        return;
+    }
+    uint64_t mask = 1ull << (pic_idx % 64);
+    unchecked_[pic_idx / 64].fetch_or(mask, std::memory_order_relaxed);
+    // a surface decoded into again before its previous picture was found complete stays one picture in flight
+    if ((in_flight_[pic_idx / 64].fetch_or(mask, std::memory_order_relaxed) & mask) == 0) {
+        Add(&RocdecMetricsSegment::frames_in_flight, 1);
+    }
+}
+
+void RocDecMetricsPublisher::CompleteSurface(int pic_idx) {
+    if (ClearSurfaceBit(in_flight_, pic_idx)) {
+        __atomic_fetch_sub(&segment_->frames_in_flight, 1, __ATOMIC_RELAXED);
+    }
+}
+
+void RocDecMetricsPublisher::SurfaceMapped(int pic_idx) {
+    if (pic_idx < 0 || pic_idx >= kMaxTrackedSurfaces) {
+        return;
+    }
+    CompleteSurface(pic_idx);
+}
+
+void RocDecMetricsPublisher::SurfaceStatus(int pic_idx, int decode_status) {
+    if (pic_idx < 0 || pic_idx >= kMaxTrackedSurfaces || decode_status == rocDecodeStatus_InProgress || decode_status == rocDecodeStatus_Invalid) {
+        return;
+    }
+    CompleteSurface(pic_idx);
+    if (ClearSurfaceBit(unchecked_, pic_idx) && (decode_status == rocDecodeStatus_Error || decode_status == rocDecodeStatus_Error_Concealed)) {
+        Add(&RocdecMetricsSegment::num_errors, 1);
+    }
+}
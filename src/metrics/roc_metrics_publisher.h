@@ -0,0 +1,83 @@
+/*
+Copyright (c) 2023 - 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <cstdint>
+#include "../../api/amd_detail/rocdecode_metrics.h"
+
+/*! \brief Shared-memory metrics segment of one decoder or parser session (see rocdecode_metrics.h).
+ *
+ * Off unless ROCDECODE_METRICS_SHM=1. The session owns the segment: Create() makes and maps it, the destructor unmaps
+ * and unlinks it. Updates are plain atomic stores and adds into the mapped segment, so publishing takes no lock and
+ * no system call.
+ */
+class RocDecMetricsPublisher {
+public:
+    /*! \brief Creates the segment of a new session.
+     * \return The segment, or null if ROCDECODE_METRICS_SHM is not set or the segment could not be created
+     */
+    static std::unique_ptr<RocDecMetricsPublisher> Create(rocDecMetricsSessionType session_type, int device_id, uint32_t codec_type);
+    ~RocDecMetricsPublisher();
+    RocDecMetricsPublisher(const RocDecMetricsPublisher&) = delete;
+    RocDecMetricsPublisher& operator=(const RocDecMetricsPublisher&) = delete;
+
+    template <typename T, typename U> void Store(T RocdecMetricsSegment::*field, U value) {
+        __atomic_store_n(&(segment_->*field), static_cast<T>(value), __ATOMIC_RELAXED);
+    }
+    template <typename T, typename U> void Add(T RocdecMetricsSegment::*field, U value) {
+        __atomic_fetch_add(&(segment_->*field), static_cast<T>(value), __ATOMIC_RELAXED);
+    }
+    /*! \brief Stamps update_time_ns and refreshes fps_milli from num_frames once the current window is a second old.
+     *  Called by one thread at a time, after num_frames has been updated.
+     */
+    void UpdateFrameRate();
+
+    /*! \brief Decoder sessions: a picture was submitted into surface pic_idx
+     */
+    void SurfaceSubmitted(int pic_idx);
+    /*! \brief Decoder sessions: the picture of surface pic_idx was found complete by rocDecGetVideoFrame
+     */
+    void SurfaceMapped(int pic_idx);
+    /*! \brief Decoder sessions: rocDecGetDecodeStatus returned decode_status for surface pic_idx. The first final status
+     *  after a submission completes the picture and counts it as an error if it failed.
+     */
+    void SurfaceStatus(int pic_idx, int decode_status);
+
+private:
+    static constexpr int kMaxTrackedSurfaces = 256; // higher pic_idx are not counted in frames_in_flight
+    RocDecMetricsPublisher(RocdecMetricsSegment *segment, const std::string &name) : segment_{segment}, name_{name} {};
+    static uint64_t GetTimeNs();
+    // clears bit pic_idx of bits; returns true if it was set
+    static bool ClearSurfaceBit(std::atomic<uint64_t> *bits, int pic_idx);
+    void CompleteSurface(int pic_idx);
+
+    RocdecMetricsSegment *segment_;
+    std::string name_;
+    std::atomic<uint64_t> in_flight_[kMaxTrackedSurfaces / 64] = {};  // submitted and not yet complete
+    std::atomic<uint64_t> unchecked_[kMaxTrackedSurfaces / 64] = {};   // submitted and no final status returned yet
+    uint64_t window_start_ns_ = 0;
+    uint64_t window_start_frames_ = 0;
+};
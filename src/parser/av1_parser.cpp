@@ -42,11 +42,14 @@ rocDecStatus Av1VideoParser::Initialize(RocdecParserParams *p_params) {
     if ((ret = RocVideoParser::Initialize(p_params)) != ROCDEC_SUCCESS) {
         return ret;
     }
-    // Set display delay to at least DECODE_BUF_POOL_EXTENSION (2) to prevent synchronous submission
-    if (parser_params_.max_display_delay < DECODE_BUF_POOL_EXTENSION) {
+    // Set display delay to at least DECODE_BUF_POOL_EXTENSION (2) to prevent synchronous submission, unless the pool is kept tight
+    // or the delay is automatic or decode order is requested: frames are shown in decode order, so they need none
+    if (!parser_params_.tight_surface_pool && !parser_params_.auto_display_delay && !parser_params_.decode_order_output &&
+        parser_params_.max_display_delay < DECODE_BUF_POOL_EXTENSION) {
         parser_params_.max_display_delay = DECODE_BUF_POOL_EXTENSION;
     }
-    CheckAndAdjustDecBufPoolSize(BUFFER_POOL_MAX_SIZE);
+    // The NUM_REF_FRAMES reference slots hold at most as many frames, plus the frame being decoded
+    CheckAndAdjustDecBufPoolSize(BUFFER_POOL_MAX_SIZE, NUM_REF_FRAMES + 1);
     return ROCDEC_SUCCESS;
 }
 
@@ -55,6 +58,9 @@ rocDecStatus Av1VideoParser::UnInitialize() {
 }
 
 rocDecStatus Av1VideoParser::ParseVideoData(RocdecSourceDataPacket *p_data) { 
+    ROCDEC_TRACE_SCOPE("RocVideoParser::ParseVideoData", -1);
+    ParserStatsTimer parse_timer(parse_total_time_ns_);
+    CountPacket(p_data);
     if (p_data->payload && p_data->payload_size) {
         curr_pts_ = p_data->pts;
         if (ParsePictureData(p_data->payload, p_data->payload_size) != PARSER_OK) {
@@ -80,6 +86,7 @@ ParserResult Av1VideoParser::ParsePictureData(const uint8_t *p_stream, uint32_t
     curr_byte_offset_ = 0;
 
     while (ReadObuHeaderAndSize() != PARSER_EOF) {
+        CountUnit(obu_header_.obu_type);
         switch (obu_header_.obu_type) {
             case kObuTemporalDelimiter: {
                 seen_frame_header_ = 0;
@@ -98,6 +105,7 @@ ParserResult Av1VideoParser::ParsePictureData(const uint8_t *p_stream, uint32_t
                 if ((ret = ParseFrameHeaderObu(pic_data_buffer_ptr_ + obu_byte_offset_, obu_size_, &bytes_parsed)) != PARSER_OK) {
                     return ret;
                 }
+                stats_.num_pics_parsed++;
                 break;
             }
             case kObuRedundantFrameHeader: {
@@ -116,6 +124,7 @@ ParserResult Av1VideoParser::ParsePictureData(const uint8_t *p_stream, uint32_t
                 if ((ret = ParseFrameHeaderObu(pic_data_buffer_ptr_ + obu_byte_offset_, obu_size_, &bytes_parsed)) != PARSER_OK) {
                     return ret;
                 }
+                stats_.num_pics_parsed++;
                 obu_byte_offset_ += bytes_parsed;
                 if (obu_size_ > bytes_parsed) {
                     obu_size_ -= bytes_parsed;
@@ -158,12 +167,8 @@ ParserResult Av1VideoParser::ParsePictureData(const uint8_t *p_stream, uint32_t
                 decode_buffer_pool_[disp_idx].use_status |= kFrameUsedForDisplay;
                 decode_buffer_pool_[disp_idx].pts = curr_pts_;
                 // Insert into output/display picture list
-                if (num_output_pics_ >= dec_buf_pool_size_) {
-                    ERR("Display list size larger than decode buffer pool size!");
+                if (InsertOutputPicture(disp_idx) != PARSER_OK) {
                     return PARSER_OUT_OF_RANGE;
-                } else {
-                    output_pic_list_[num_output_pics_] = disp_idx;
-                    num_output_pics_++;
                 }
             }
             if ((ret = DecodeFrameWrapup()) != PARSER_OK) {
@@ -234,7 +239,7 @@ ParserResult Av1VideoParser::NotifyNewSequence(Av1SequenceHeader *p_seq_header,
     video_format_params_.seqhdr_data_length = 0;
 
     // callback function with RocdecVideoFormat params filled out
-    if (pfn_sequece_cb_(parser_params_.user_data, &video_format_params_) == 0) {
+    if (CallSequenceCallback() == 0) {
         ERR("Sequence callback function failed.");
         return PARSER_FAIL;
     } else {
@@ -470,7 +475,8 @@ ParserResult Av1VideoParser::SendPicForDecode() {
     PrintVaapiParams();
 #endif // DBGINFO
 
-    if (pfn_decode_picture_cb_(parser_params_.user_data, &dec_pic_params_) == 0) {
+    ROCDEC_TRACE_SCOPE("RocVideoParser::DecodePicture", dec_pic_params_.curr_pic_idx);
+    if (CallDecodePictureCallback() == 0) {
         ERR("Decode error occurred.");
         return PARSER_FAIL;
     } else {
@@ -604,14 +610,9 @@ ParserResult Av1VideoParser::FlushDpb() {
 }
 
 ParserResult Av1VideoParser::FindFreeInDecBufPool() {
-    int dec_buf_index;
     // Find a free buffer in decode/display buffer pool to store the decoded image
-    for (dec_buf_index = 0; dec_buf_index < dec_buf_pool_size_; dec_buf_index++) {
-        if (decode_buffer_pool_[dec_buf_index].use_status == kNotUsed) {
-            break;
-        }
-    }
-    if (dec_buf_index == dec_buf_pool_size_) {
+    int dec_buf_index = FindFreeDecodeBuffer();
+    if (dec_buf_index < 0) {
         ERR("Could not find a free buffer in decode buffer pool for decoded image.");
         return PARSER_NOT_FOUND;
     }
@@ -621,12 +622,8 @@ ParserResult Av1VideoParser::FindFreeInDecBufPool() {
     decode_buffer_pool_[dec_buf_index].pts = curr_pts_;
     // Find a free buffer in decode/display buffer pool to store FG output
     if (seq_header_.film_grain_params_present && frame_header_.film_grain_params.apply_grain) {
-        for (dec_buf_index = 0; dec_buf_index < dec_buf_pool_size_; dec_buf_index++) {
-            if (decode_buffer_pool_[dec_buf_index].use_status == kNotUsed) {
-                break;
-            }
-        }
-        if (dec_buf_index == dec_buf_pool_size_) {
+        dec_buf_index = FindFreeDecodeBuffer();
+        if (dec_buf_index < 0) {
             ERR("Could not find a free buffer in decode buffer pool for FG output.");
             return PARSER_NOT_FOUND;
         }
@@ -641,13 +638,8 @@ ParserResult Av1VideoParser::FindFreeInDecBufPool() {
 }
 
 ParserResult Av1VideoParser::FindFreeInDpbAndMark() {
-    int i;
-    for (i = 0; i < BUFFER_POOL_MAX_SIZE; i++ ) {
-        if (dpb_buffer_.dec_ref_count[i] == 0) {
-            break;
-        }
-    }
-    if (i == BUFFER_POOL_MAX_SIZE) {
+    int i = DpbEngine::FindFreeSlot(BUFFER_POOL_MAX_SIZE, [&](int i) { return dpb_buffer_.dec_ref_count[i] == 0; });
+    if (i < 0) {
         ERR("DPB buffer overflow!");
         return PARSER_NOT_FOUND;
     }
@@ -666,12 +658,8 @@ ParserResult Av1VideoParser::FindFreeInDpbAndMark() {
         decode_buffer_pool_[disp_idx].use_status |= kFrameUsedForDisplay;
         decode_buffer_pool_[disp_idx].pts = curr_pts_;
         // Insert into output/display picture list
-        if (num_output_pics_ >= dec_buf_pool_size_) {
-            ERR("Display list size larger than decode buffer pool size!");
+        if (InsertOutputPicture(disp_idx) != PARSER_OK) {
             return PARSER_OUT_OF_RANGE;
-        } else {
-            output_pic_list_[num_output_pics_] = disp_idx;
-            num_output_pics_++;
         }
     }
 
@@ -884,9 +872,12 @@ void Av1VideoParser::ParseSequenceHeaderObu(uint8_t *p_stream, size_t size) {
     ParseColorConfig(p_stream, offset, p_seq_header);
 
     p_seq_header->film_grain_params_present = Parser::GetBit(p_stream, offset);
-    // Increase decode/display pool size for film grain synthesis output store
+    // Increase decode/display pool size for film grain synthesis output store. The film grain output of a frame is only held until
+    // it is displayed, so a tight pool needs one more buffer, for the frame being decoded.
     if (p_seq_header->film_grain_params_present) {
-        CheckAndAdjustDecBufPoolSize(BUFFER_POOL_MAX_SIZE * 2);
+        CheckAndAdjustDecBufPoolSize(BUFFER_POOL_MAX_SIZE * 2, NUM_REF_FRAMES + 2);
+    } else {
+        CheckAndAdjustDecBufPoolSize(BUFFER_POOL_MAX_SIZE, NUM_REF_FRAMES + 1);
     }
 }
 
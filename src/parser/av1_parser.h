@@ -55,6 +55,13 @@ public:
      */
     virtual rocDecStatus UnInitialize();     // derived method
 
+    /*! \brief Function to get the bytes held by the parser, including its parameter set tables and slice lists
+     */
+    size_t GetMemoryUsage() override {
+        return sizeof(*this) - sizeof(RocVideoParser) + RocVideoParser::GetMemoryUsage() +
+               tile_param_list_.capacity() * sizeof(RocdecAv1SliceParams);
+    }
+
     typedef struct {
         uint32_t tile_offset;
         uint32_t tile_size;
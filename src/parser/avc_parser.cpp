@@ -40,12 +40,15 @@ AvcVideoParser::AvcVideoParser() {
     max_long_term_frame_idx_ = NO_LONG_TERM_FRAME_INDICES;
 
     slice_info_list_.assign(INIT_SLICE_LIST_NUM, {0});
+    num_slice_header_jobs_ = 0;
     slice_param_list_.assign(INIT_SLICE_LIST_NUM, {0});
     memset(&curr_pic_, 0, sizeof(AvcPicture));
     field_pic_count_ = 0;
     second_field_ = 0;
     first_field_pic_idx_ = 0;
     first_field_dec_buf_idx_ = 0;
+    num_reorder_frames_ = AVC_MAX_DPB_FRAMES;
+    prev_output_poc_ = INT32_MIN;
 
     InitDpb();
 }
@@ -62,6 +65,9 @@ rocDecStatus AvcVideoParser::UnInitialize() {
 }
 
 rocDecStatus AvcVideoParser::ParseVideoData(RocdecSourceDataPacket *p_data) {
+    ROCDEC_TRACE_SCOPE("RocVideoParser::ParseVideoData", -1);
+    ParserStatsTimer parse_timer(parse_total_time_ns_);
+    CountPacket(p_data);
     if (p_data->payload && p_data->payload_size) {
         curr_pts_ = p_data->pts;
         if (ParsePictureData(p_data->payload, p_data->payload_size) != PARSER_OK) {
@@ -86,6 +92,7 @@ rocDecStatus AvcVideoParser::ParseVideoData(RocdecSourceDataPacket *p_data) {
         if (num_slices_ == 0) {
             return ROCDEC_SUCCESS;
         }
+        stats_.num_pics_parsed++;
 
         // Output decoded pictures from DPB if any are ready in case of frame_num gaps.
         if (pfn_display_picture_cb_ && num_output_pics_ > 0) {
@@ -139,6 +146,7 @@ ParserResult AvcVideoParser::ParsePictureData(const uint8_t *p_stream, uint32_t
     next_start_code_offset_ = 0;
 
     num_slices_ = 0;
+    num_slice_header_jobs_ = 0;
     sei_message_count_ = 0;
     sei_payload_size_ = 0;
     curr_pic_ = {0};
@@ -156,6 +164,14 @@ ParserResult AvcVideoParser::ParsePictureData(const uint8_t *p_stream, uint32_t
             int ebsp_size = nal_unit_size_ - 4 > RBSP_BUF_SIZE ? RBSP_BUF_SIZE : nal_unit_size_ - 4; // only copy enough bytes for header parsing
 
             nal_unit_header_ = ParseNalUnitHeader(pic_data_buffer_ptr_[curr_start_code_offset_ + 3]);
+            CountUnit(nal_unit_header_.nal_unit_type);
+            // The queued slice headers are parsed with the parameter sets that are received now
+            if (num_slice_header_jobs_ > 0 && (nal_unit_header_.nal_unit_type == kAvcNalTypeSeq_Parameter_Set ||
+                nal_unit_header_.nal_unit_type == kAvcNalTypePic_Parameter_Set)) {
+                if ((ret2 = ParseQueuedSliceHeaders()) != PARSER_OK) {
+                    return ret2;
+                }
+            }
             switch (nal_unit_header_.nal_unit_type) {
                 case kAvcNalTypeSeq_Parameter_Set: {
                     memcpy(rbsp_buf_, (pic_data_buffer_ptr_ + curr_start_code_offset_ + 4), ebsp_size);
@@ -181,13 +197,25 @@ ParserResult AvcVideoParser::ParsePictureData(const uint8_t *p_stream, uint32_t
                     // Save slice NAL unit header
                     slice_nal_unit_header_ = nal_unit_header_;
 
-                    // Resize slice info list if needed
-                    if ((num_slices_ + 1) > slice_info_list_.size()) {
-                        slice_info_list_.resize(num_slices_ + 1, {0});
+                    // Resize slice info list if needed. Queued slices follow the parsed ones.
+                    int slice_idx = num_slices_ + num_slice_header_jobs_;
+                    if ((slice_idx + 1) > slice_info_list_.size()) {
+                        slice_info_list_.resize(slice_idx + 1, {0});
                     }
 
-                    slice_info_list_[num_slices_].slice_data_offset = curr_start_code_offset_;
-                    slice_info_list_[num_slices_].slice_data_size = nal_unit_size_;
+                    slice_info_list_[slice_idx].slice_data_offset = curr_start_code_offset_;
+                    slice_info_list_[slice_idx].slice_data_size = nal_unit_size_;
+
+                    // Only the first slice of a picture changes the DPB state. The headers of the others are queued and parsed
+                    // together by ParseQueuedSliceHeaders().
+                    if (num_slices_ > 0) {
+                        if ((num_slice_header_jobs_ + 1) > slice_header_jobs_.size()) {
+                            slice_header_jobs_.resize(num_slice_header_jobs_ + 1);
+                        }
+                        slice_header_jobs_[num_slice_header_jobs_].nal_unit_header = nal_unit_header_;
+                        num_slice_header_jobs_++;
+                        break;
+                    }
 
                     memcpy(rbsp_buf_, (pic_data_buffer_ptr_ + curr_start_code_offset_ + 4), ebsp_size);
                     rbsp_size_ = EbspToRbsp(rbsp_buf_, 0, ebsp_size);
@@ -197,40 +225,38 @@ ParserResult AvcVideoParser::ParsePictureData(const uint8_t *p_stream, uint32_t
                     }
 
                     // Start decode process
-                    if (num_slices_ == 0) {
-                        if (p_slice_header->field_pic_flag) {
-                            second_field_ = field_pic_count_ & 1;
-                            field_pic_count_++;
-                        } else {
-                            second_field_ = 0;
-                        }
-
-                        // Use the data directly from demuxer without copying
-                        pic_stream_data_ptr_ = pic_data_buffer_ptr_ + curr_start_code_offset_;
-                        // Picture stream data size is calculated as the diff between the frame end and the first slice offset.
-                        // This is to consider the possibility of non-slice NAL units between slices.
-                        pic_stream_data_size_ = pic_data_size - curr_start_code_offset_;
-
-                        // Decode gaps in frame_num if needed (8.2.5.2)
-                        DecodeFrameNumGaps();
+                    if (p_slice_header->field_pic_flag) {
+                        second_field_ = field_pic_count_ & 1;
+                        field_pic_count_++;
+                    } else {
+                        second_field_ = 0;
+                    }
 
-                        // Set current picture properties
-                        CalculateCurrPoc(); // 8.2.1
-                        prev_has_mmco_5_ = curr_has_mmco_5_;
-                        prev_ref_pic_bottom_field_ = curr_ref_pic_bottom_field_;
-                        if (p_slice_header->field_pic_flag) {
-                            if (p_slice_header->bottom_field_flag) {
-                                curr_pic_.pic_structure = kBottomField;
-                            } else {
-                                curr_pic_.pic_structure = kTopField;
-                            }
+                    // Use the data directly from demuxer without copying
+                    pic_stream_data_ptr_ = pic_data_buffer_ptr_ + curr_start_code_offset_;
+                    // Picture stream data size is calculated as the diff between the frame end and the first slice offset.
+                    // This is to consider the possibility of non-slice NAL units between slices.
+                    pic_stream_data_size_ = pic_data_size - curr_start_code_offset_;
+
+                    // Decode gaps in frame_num if needed (8.2.5.2)
+                    DecodeFrameNumGaps();
+
+                    // Set current picture properties
+                    CalculateCurrPoc(); // 8.2.1
+                    prev_has_mmco_5_ = curr_has_mmco_5_;
+                    prev_ref_pic_bottom_field_ = curr_ref_pic_bottom_field_;
+                    if (p_slice_header->field_pic_flag) {
+                        if (p_slice_header->bottom_field_flag) {
+                            curr_pic_.pic_structure = kBottomField;
                         } else {
-                            curr_pic_.pic_structure = kFrame;
-                        }
-                        curr_pic_.frame_num = p_slice_header->frame_num;
-                        if (p_slice_header->field_pic_flag == 0 || second_field_) {
-                            curr_pic_.pic_output_flag = 1; // Annex C. OutputFlag is set to 1 for Annex A streams
+                            curr_pic_.pic_structure = kTopField;
                         }
+                    } else {
+                        curr_pic_.pic_structure = kFrame;
+                    }
+                    curr_pic_.frame_num = p_slice_header->frame_num;
+                    if (p_slice_header->field_pic_flag == 0 || second_field_) {
+                        curr_pic_.pic_output_flag = 1; // Annex C. OutputFlag is set to 1 for Annex A streams
                     }
 
                     // Reference picture lists construction (8.2.4)
@@ -238,13 +264,11 @@ ParserResult AvcVideoParser::ParsePictureData(const uint8_t *p_stream, uint32_t
                         return ret2;
                     }
 
-                    if (num_slices_ == 0) {
-                        if ((ret2 = FindFreeInDecBufPool()) != PARSER_OK) {
-                            return ret2;
-                        }
-                        if ((ret2 = FindFreeBufInDpb()) != PARSER_OK) {
-                            return ret2;
-                        }
+                    if ((ret2 = FindFreeInDecBufPool()) != PARSER_OK) {
+                        return ret2;
+                    }
+                    if ((ret2 = FindFreeBufInDpb()) != PARSER_OK) {
+                        return ret2;
                     }
                     num_slices_++;
                     break;
@@ -291,9 +315,60 @@ ParserResult AvcVideoParser::ParsePictureData(const uint8_t *p_stream, uint32_t
         }
     } while (1);
 
+    if (num_slice_header_jobs_ > 0) {
+        return ParseQueuedSliceHeaders();
+    }
     return PARSER_OK;
 }
 
+ParserResult AvcVideoParser::ParseQueuedSliceHeaders() {
+    int num_jobs = num_slice_header_jobs_;
+    num_slice_header_jobs_ = 0;
+
+    // The headers only read the SPS and PPS tables, which stay as they are until the jobs are done, and write their own
+    // slice info and job. The slices of a picture may refer to different PPSs of the active SPS.
+    RunSliceHeaderJobs(num_jobs, [&](int i) {
+        AvcSliceHeaderJob *p_job = &slice_header_jobs_[i];
+        AvcSliceInfo *p_slice_info = &slice_info_list_[num_slices_ + i];
+        int ebsp_size = p_slice_info->slice_data_size - 4 > RBSP_BUF_SIZE ? RBSP_BUF_SIZE : p_slice_info->slice_data_size - 4;
+        memcpy(p_job->rbsp_buf, (pic_data_buffer_ptr_ + p_slice_info->slice_data_offset + 4), ebsp_size);
+        size_t rbsp_size = ConvertEbspToRbsp(p_job->rbsp_buf, 0, ebsp_size, &p_job->num_emulation_prevention_bytes);
+        size_t offset = 0;
+        Parser::ExpGolomb::ReadUe(p_job->rbsp_buf, offset);  // first_mb_in_slice
+        Parser::ExpGolomb::ReadUe(p_job->rbsp_buf, offset);  // slice_type
+        uint32_t pps_id = Parser::ExpGolomb::ReadUe(p_job->rbsp_buf, offset);
+        if (pps_id >= AVC_MAX_PPS_NUM || pps_list_[pps_id].is_received == 0 || pps_list_[pps_id].seq_parameter_set_id != active_sps_id_) {
+            ERR("Slices of a picture refer to an empty PPS or to different SPSs.");
+            p_job->result = PARSER_WRONG_STATE;
+            return;
+        }
+        p_job->result = ParseSliceHeaderSyntax(p_job->rbsp_buf, rbsp_size, &p_job->nal_unit_header, &sps_list_[active_sps_id_], &pps_list_[pps_id],
+                                               &p_slice_info->slice_header);
+    });
+
+    // Set up the reference lists in decoding order. Later slices repeat the reference picture marking of the first one, so
+    // curr_has_mmco_5_ and curr_ref_pic_bottom_field_ are left as it set them.
+    ParserResult ret = PARSER_OK;
+    for (int i = 0; i < num_jobs; i++) {
+        AvcSliceHeaderJob *p_job = &slice_header_jobs_[i];
+        stats_.num_emulation_prevention_bytes += p_job->num_emulation_prevention_bytes;
+        // Stop at the first slice with an error, as the serial parse does
+        if (ret != PARSER_OK || (ret = p_job->result) != PARSER_OK) {
+            continue;
+        }
+        AvcSliceInfo *p_slice_info = &slice_info_list_[num_slices_];
+        active_pps_id_ = p_slice_info->slice_header.pic_parameter_set_id;
+#if DBGINFO
+        PrintSliceHeader(&p_slice_info->slice_header);
+#endif // DBGINFO
+        // Reference picture lists construction (8.2.4)
+        if ((ret = SetupReflist(p_slice_info)) == PARSER_OK) {
+            num_slices_++;
+        }
+    }
+    return ret;
+}
+
 ParserResult AvcVideoParser::NotifyNewSps(AvcSeqParameterSet *p_sps) {
     video_format_params_.codec = rocDecVideoCodec_AVC;
     video_format_params_.frame_rate.numerator = frame_rate_.numerator;
@@ -398,7 +473,7 @@ ParserResult AvcVideoParser::NotifyNewSps(AvcSeqParameterSet *p_sps) {
     video_format_params_.seqhdr_data_length = 0;
 
     // callback function with RocdecVideoFormat params filled out
-    if (pfn_sequece_cb_(parser_params_.user_data, &video_format_params_) == 0) {
+    if (CallSequenceCallback() == 0) {
         ERR("Sequence callback function failed.");
         return PARSER_FAIL;
     } else {
@@ -413,7 +488,7 @@ void AvcVideoParser::SendSeiMsgPayload() {
     sei_message_info_params_.picIdx = curr_pic_.dec_buf_idx;
 
     // callback function with RocdecSeiMessageInfo params filled out
-    if (pfn_get_sei_message_cb_) pfn_get_sei_message_cb_(parser_params_.user_data, &sei_message_info_params_);
+    CallSeiMessageCallback();
 }
 
 static const int diag_scan_4x4[16] = {
@@ -703,7 +778,8 @@ ParserResult AvcVideoParser::SendPicForDecode() {
     PrintVappiBufInfo();
 #endif // DBGINFO
 
-    if (pfn_decode_picture_cb_(parser_params_.user_data, &dec_pic_params_) == 0) {
+    ROCDEC_TRACE_SCOPE("RocVideoParser::DecodePicture", dec_pic_params_.curr_pic_idx);
+    if (CallDecodePictureCallback() == 0) {
         ERR("Decode error occurred.");
         return PARSER_FAIL;
     } else {
@@ -1153,7 +1229,6 @@ ParserResult AvcVideoParser::ParsePps(uint8_t *p_stream, size_t stream_size_in_b
 }
 
 ParserResult AvcVideoParser::ParseSliceHeader(uint8_t *p_stream, size_t stream_size_in_byte, AvcSliceHeader *p_slice_header) {
-    int i;
     size_t offset = 0;  // current bit offset
     AvcSeqParameterSet *p_sps = nullptr;
     AvcPicParameterSet *p_pps = nullptr;
@@ -1161,6 +1236,7 @@ ParserResult AvcVideoParser::ParseSliceHeader(uint8_t *p_stream, size_t stream_s
     curr_has_mmco_5_ = 0;
     memset(p_slice_header, 0, sizeof(AvcSliceHeader));
 
+    // Read up to pic_parameter_set_id to activate the parameter sets. ParseSliceHeaderSyntax() parses the whole header.
     p_slice_header->first_mb_in_slice = Parser::ExpGolomb::ReadUe(p_stream, offset);
     p_slice_header->slice_type = Parser::ExpGolomb::ReadUe(p_stream, offset);
     p_slice_header->pic_parameter_set_id = Parser::ExpGolomb::ReadUe(p_stream, offset);
@@ -1199,9 +1275,12 @@ ParserResult AvcVideoParser::ParseSliceHeader(uint8_t *p_stream, size_t stream_s
         new_seq_activated_ = true;  // Note: clear this flag after the actions are taken.
     }
 
-    // Check and adjust decode buffer pool size if needed
+    // Check and adjust decode buffer pool size if needed. A new picture takes its buffer when the DPB has at most dpb_size - 1
+    // pictures, as the DPB is bumped whenever it fills up. The VUI max_dec_frame_buffering is at least max_num_ref_frames, so
+    // it cannot lower this.
     if (new_seq_activated_) {
-        CheckAndAdjustDecBufPoolSize(dpb_buffer_.dpb_size);
+        CheckAndAdjustDecBufPoolSize(dpb_buffer_.dpb_size, dpb_buffer_.dpb_size);
+        SetNumReorderFrames(p_sps);
     }
 
     // Set frame rate if available
@@ -1215,6 +1294,35 @@ ParserResult AvcVideoParser::ParseSliceHeader(uint8_t *p_stream, size_t stream_s
         }
     }
 
+    ParserResult ret = ParseSliceHeaderSyntax(p_stream, stream_size_in_byte, &nal_unit_header_, p_sps, p_pps, p_slice_header);
+    if (nal_unit_header_.nal_ref_idc) {
+        curr_ref_pic_bottom_field_ = p_slice_header->bottom_field_flag;
+    }
+    if (ret != PARSER_OK) {
+        return ret;
+    }
+    for (int i = 0; i < p_slice_header->dec_ref_pic_marking.mmco_count; i++) {
+        if (p_slice_header->dec_ref_pic_marking.mmco[i].memory_management_control_operation == 5) {
+            curr_has_mmco_5_ = 1;
+        }
+    }
+
+#if DBGINFO
+    PrintSliceHeader(p_slice_header);
+#endif // DBGINFO
+    return PARSER_OK;
+}
+
+ParserResult AvcVideoParser::ParseSliceHeaderSyntax(uint8_t *p_stream, size_t stream_size_in_byte, AvcNalUnitHeader *p_nal_unit_header,
+                                                    AvcSeqParameterSet *p_sps, AvcPicParameterSet *p_pps, AvcSliceHeader *p_slice_header) {
+    int i;
+    size_t offset = 0;  // current bit offset
+
+    memset(p_slice_header, 0, sizeof(AvcSliceHeader));
+    p_slice_header->first_mb_in_slice = Parser::ExpGolomb::ReadUe(p_stream, offset);
+    p_slice_header->slice_type = Parser::ExpGolomb::ReadUe(p_stream, offset);
+    p_slice_header->pic_parameter_set_id = Parser::ExpGolomb::ReadUe(p_stream, offset);
+
     if (p_sps->separate_colour_plane_flag == 1) {
         p_slice_header->colour_plane_id = Parser::ReadBits(p_stream, offset, 2);
     }
@@ -1231,11 +1339,7 @@ ParserResult AvcVideoParser::ParseSliceHeader(uint8_t *p_stream, size_t stream_s
         p_slice_header->bottom_field_flag = 0;
     }
 
-    if ( nal_unit_header_.nal_ref_idc ) {
-        curr_ref_pic_bottom_field_ = p_slice_header->bottom_field_flag;
-    }
-    
-    if (nal_unit_header_.nal_unit_type == kAvcNalTypeSlice_IDR) {
+    if (p_nal_unit_header->nal_unit_type == kAvcNalTypeSlice_IDR) {
         p_slice_header->idr_pic_id = Parser::ExpGolomb::ReadUe(p_stream, offset);
     }
 
@@ -1277,7 +1381,7 @@ ParserResult AvcVideoParser::ParseSliceHeader(uint8_t *p_stream, size_t stream_s
     }
 
     // Bail out for NAL unit type 20/21
-    if ( nal_unit_header_.nal_unit_type == 21 || nal_unit_header_.nal_unit_type == 21) {
+    if ( p_nal_unit_header->nal_unit_type == 21 || p_nal_unit_header->nal_unit_type == 21) {
         return PARSER_NOT_SUPPORTED;
     }
 
@@ -1388,8 +1492,8 @@ ParserResult AvcVideoParser::ParseSliceHeader(uint8_t *p_stream, size_t stream_s
 
     // Decoded reference picture marking.
     int memory_management_control_operation;
-    if (nal_unit_header_.nal_ref_idc != 0) {
-        if (nal_unit_header_.nal_unit_type == kAvcNalTypeSlice_IDR) {
+    if (p_nal_unit_header->nal_ref_idc != 0) {
+        if (p_nal_unit_header->nal_unit_type == kAvcNalTypeSlice_IDR) {
             p_slice_header->dec_ref_pic_marking.no_output_of_prior_pics_flag = Parser::GetBit(p_stream, offset);
             p_slice_header->dec_ref_pic_marking.long_term_reference_flag = Parser::GetBit(p_stream, offset);
         } else {
@@ -1412,9 +1516,6 @@ ParserResult AvcVideoParser::ParseSliceHeader(uint8_t *p_stream, size_t stream_s
                     if (memory_management_control_operation == 4) {
                         p_slice_header->dec_ref_pic_marking.mmco[i].max_long_term_frame_idx_plus1 = Parser::ExpGolomb::ReadUe(p_stream, offset);
                     }
-                    if ( memory_management_control_operation == 5) {
-                        curr_has_mmco_5_ = 1;
-                    }
                     i++;
                 } while (memory_management_control_operation != 0);
                 p_slice_header->dec_ref_pic_marking.mmco_count = i - 1;
@@ -1448,9 +1549,6 @@ ParserResult AvcVideoParser::ParseSliceHeader(uint8_t *p_stream, size_t stream_s
         p_slice_header->slice_group_change_cycle = Parser::ReadBits(p_stream, offset, size);
     }
 
-#if DBGINFO
-    PrintSliceHeader(p_slice_header);
-#endif // DBGINFO
     return PARSER_OK;
 }
 
@@ -1637,6 +1735,7 @@ void AvcVideoParser::InitDpb() {
     dpb_buffer_.num_short_term_ref_fields = 0;
     dpb_buffer_.num_long_term_ref_fields = 0;
     dpb_buffer_.num_pics_needed_for_output = 0;
+    dpb_engine_.Reset();
 }
 
 // 8.2.1 Decoding process for picture order count
@@ -1953,17 +2052,14 @@ ParserResult AvcVideoParser::DecodeFrameNumGaps() {
                 }
             }
 
-            for (i = 0; i < dpb_buffer_.dpb_size; i++) {
-                if (dpb_buffer_.frame_buffer_list[i].use_status == kNotUsed) {
-                    break;
-                }
-            }
-            if (i < dpb_buffer_.dpb_size) {
+            i = FindFreeInDpb();
+            if (i >= 0) {
                 non_existing_pic.pic_idx = dpb_buffer_.frame_buffer_list[i].pic_idx;
                 non_existing_pic.use_status = kFrameUsedForDecode;
                 dpb_buffer_.frame_buffer_list[i] = non_existing_pic;
                 dpb_buffer_.dpb_fullness++;
                 dpb_buffer_.num_short_term++;
+                dpb_engine_.IndexFrameNum(non_existing_pic.frame_num, i);
             } else {
                 ERR("Could not find any free frame buffer in DPB.");
                 return PARSER_FAIL;
@@ -2557,6 +2653,12 @@ ParserResult AvcVideoParser::CheckDpbAndOutput() {
                 return PARSER_FAIL;
         }
     }
+    // Output the pictures that no later picture can precede
+    if (parser_params_.auto_display_delay || parser_params_.decode_order_output) {
+        if (OutputReorderedPics() != PARSER_OK) {
+            return PARSER_FAIL;
+        }
+    }
     // Output decoded pictures from DPB if any are ready
     if (pfn_display_picture_cb_ && num_output_pics_ > 0) {
         if (OutputDecodedPictures(false) != PARSER_OK) {
@@ -2571,12 +2673,8 @@ ParserResult AvcVideoParser::FindFreeInDecBufPool() {
 
     if (curr_pic_.pic_structure == kFrame || !second_field_) {
         // Find a free buffer in decode buffer pool
-        for (dec_buf_index = 0; dec_buf_index < dec_buf_pool_size_; dec_buf_index++) {
-            if (decode_buffer_pool_[dec_buf_index].use_status == kNotUsed) {
-                break;
-            }
-        }
-        if (dec_buf_index == dec_buf_pool_size_) {
+        dec_buf_index = FindFreeDecodeBuffer();
+        if (dec_buf_index < 0) {
             ERR("Could not find a free buffer in decode buffer pool.");
             return PARSER_NOT_FOUND;
         }
@@ -2592,6 +2690,22 @@ ParserResult AvcVideoParser::FindFreeInDecBufPool() {
     return PARSER_OK;
 }
 
+int AvcVideoParser::FindFreeInDpb() {
+    return DpbEngine::FindFreeSlot(dpb_buffer_.dpb_size, [&](int i) {
+        return dpb_buffer_.frame_buffer_list[i].use_status == kNotUsed;
+    });
+}
+
+int AvcVideoParser::FindShortTermRefFrame(int pic_num) {
+    AvcSeqParameterSet *p_sps = &sps_list_[active_sps_id_];
+    int max_frame_num = 1 << (p_sps->log2_max_frame_num_minus4 + 4); // MaxFrameNum
+    // PicNum is FrameNumWrap for frames, so a negative value wraps back to the coded frame_num.
+    int frame_num = pic_num < 0 ? pic_num + max_frame_num : pic_num;
+    return dpb_engine_.FindFrameNum(frame_num, dpb_buffer_.dpb_size, [&](int j) {
+        return dpb_buffer_.frame_buffer_list[j].is_reference == kUsedForShortTerm && dpb_buffer_.frame_buffer_list[j].pic_num == pic_num;
+    });
+}
+
 ParserResult AvcVideoParser::FindFreeBufInDpb() {
     int i;
     if (curr_pic_.pic_structure == kFrame || !second_field_) {
@@ -2601,12 +2715,8 @@ ParserResult AvcVideoParser::FindFreeBufInDpb() {
             }
         }
 
-        for (i = 0; i < dpb_buffer_.dpb_size; i++) {
-            if (dpb_buffer_.frame_buffer_list[i].use_status == kNotUsed) {
-                break;
-            }
-        }
-        if (i < dpb_buffer_.dpb_size) {
+        i = FindFreeInDpb();
+        if (i >= 0) {
             curr_pic_.pic_idx = dpb_buffer_.frame_buffer_list[i].pic_idx;
             if (curr_pic_.pic_structure == kFrame) {
                 curr_pic_.use_status = kFrameUsedForDecode;
@@ -2693,19 +2803,17 @@ ParserResult AvcVideoParser::MarkDecodedRefPics() {
                                 }
                             }
                         } else {
-                            for (int j = 0; j < dpb_buffer_.dpb_size; j++) {
-                                if (dpb_buffer_.frame_buffer_list[j].is_reference == kUsedForShortTerm && dpb_buffer_.frame_buffer_list[j].pic_num == pic_num_x) {
-                                    dpb_buffer_.frame_buffer_list[j].is_reference = kUnusedForReference;
-                                    dpb_buffer_.num_short_term--;
-                                    if (dpb_buffer_.field_pic_list[j * 2].is_reference == kUsedForShortTerm) {
-                                        dpb_buffer_.field_pic_list[j * 2].is_reference = kUnusedForReference;
-                                        dpb_buffer_.num_short_term_ref_fields--;
-                                    }
-                                    if (dpb_buffer_.field_pic_list[j * 2 + 1].is_reference == kUsedForShortTerm) {
-                                        dpb_buffer_.field_pic_list[j * 2 + 1].is_reference = kUnusedForReference;
-                                        dpb_buffer_.num_short_term_ref_fields--;
-                                    }
-                                    break;
+                            int j = FindShortTermRefFrame(pic_num_x);
+                            if (j >= 0) {
+                                dpb_buffer_.frame_buffer_list[j].is_reference = kUnusedForReference;
+                                dpb_buffer_.num_short_term--;
+                                if (dpb_buffer_.field_pic_list[j * 2].is_reference == kUsedForShortTerm) {
+                                    dpb_buffer_.field_pic_list[j * 2].is_reference = kUnusedForReference;
+                                    dpb_buffer_.num_short_term_ref_fields--;
+                                }
+                                if (dpb_buffer_.field_pic_list[j * 2 + 1].is_reference == kUsedForShortTerm) {
+                                    dpb_buffer_.field_pic_list[j * 2 + 1].is_reference = kUnusedForReference;
+                                    dpb_buffer_.num_short_term_ref_fields--;
                                 }
                             }
                         }
@@ -2790,25 +2898,23 @@ ParserResult AvcVideoParser::MarkDecodedRefPics() {
                                 }
                             }
                         } else {
-                            for (int j = 0; j < dpb_buffer_.dpb_size; j++) {
-                                if (dpb_buffer_.frame_buffer_list[j].is_reference == kUsedForShortTerm && dpb_buffer_.frame_buffer_list[j].pic_num == pic_num_x) {
-                                    dpb_buffer_.frame_buffer_list[j].is_reference = kUsedForLongTerm;
-                                    dpb_buffer_.frame_buffer_list[j].long_term_frame_idx = p_mmco->long_term_frame_idx;
-                                    dpb_buffer_.num_short_term--;
-                                    dpb_buffer_.num_long_term++;
-                                    if (dpb_buffer_.field_pic_list[j * 2].is_reference == kUsedForShortTerm) {
-                                        dpb_buffer_.field_pic_list[j * 2].is_reference = kUsedForLongTerm;
-                                        dpb_buffer_.field_pic_list[j * 2].long_term_frame_idx = p_mmco->long_term_frame_idx;
-                                        dpb_buffer_.num_short_term_ref_fields--;
-                                        dpb_buffer_.num_long_term_ref_fields++;
-                                    }
-                                    if (dpb_buffer_.field_pic_list[j * 2 + 1].is_reference == kUsedForShortTerm) {
-                                        dpb_buffer_.field_pic_list[j * 2 + 1].is_reference = kUsedForLongTerm;
-                                        dpb_buffer_.field_pic_list[j * 2 + 1].long_term_frame_idx = p_mmco->long_term_frame_idx;
-                                        dpb_buffer_.num_short_term_ref_fields--;
-                                        dpb_buffer_.num_long_term_ref_fields++;
-                                    }
-                                    break;
+                            int j = FindShortTermRefFrame(pic_num_x);
+                            if (j >= 0) {
+                                dpb_buffer_.frame_buffer_list[j].is_reference = kUsedForLongTerm;
+                                dpb_buffer_.frame_buffer_list[j].long_term_frame_idx = p_mmco->long_term_frame_idx;
+                                dpb_buffer_.num_short_term--;
+                                dpb_buffer_.num_long_term++;
+                                if (dpb_buffer_.field_pic_list[j * 2].is_reference == kUsedForShortTerm) {
+                                    dpb_buffer_.field_pic_list[j * 2].is_reference = kUsedForLongTerm;
+                                    dpb_buffer_.field_pic_list[j * 2].long_term_frame_idx = p_mmco->long_term_frame_idx;
+                                    dpb_buffer_.num_short_term_ref_fields--;
+                                    dpb_buffer_.num_long_term_ref_fields++;
+                                }
+                                if (dpb_buffer_.field_pic_list[j * 2 + 1].is_reference == kUsedForShortTerm) {
+                                    dpb_buffer_.field_pic_list[j * 2 + 1].is_reference = kUsedForLongTerm;
+                                    dpb_buffer_.field_pic_list[j * 2 + 1].long_term_frame_idx = p_mmco->long_term_frame_idx;
+                                    dpb_buffer_.num_short_term_ref_fields--;
+                                    dpb_buffer_.num_long_term_ref_fields++;
                                 }
                             }
                         }
@@ -2968,24 +3074,19 @@ ParserResult AvcVideoParser::MarkDecodedRefPics() {
 
 ParserResult AvcVideoParser::BumpPicFromDpb() {
     int32_t min_poc_no_ref = 0x7FFFFFFF;  // largest possible POC value 2^31 - 1
-    int32_t min_poc_ref = 0x7FFFFFFF;  // largest possible POC value 2^31 - 1
+    int32_t min_poc_ref;
     int min_poc_pic_idx_no_ref = AVC_MAX_DPB_FRAMES;
-    int min_poc_pic_idx_ref = AVC_MAX_DPB_FRAMES;
+    int min_poc_pic_idx_ref;
     int i;
+    auto is_waiting_for_output = [&](int i) {
+        return i < dpb_buffer_.dpb_size && dpb_buffer_.frame_buffer_list[i].pic_output_flag && dpb_buffer_.frame_buffer_list[i].use_status;
+    };
 
     for (i = 0; i < dpb_buffer_.dpb_size; i++) {
-        if (dpb_buffer_.frame_buffer_list[i].use_status) {
-            if (dpb_buffer_.frame_buffer_list[i].is_reference) {
-                if (dpb_buffer_.frame_buffer_list[i].pic_order_cnt < min_poc_ref && dpb_buffer_.frame_buffer_list[i].pic_output_flag) {
-                    // Find the min-poc ref pic that has not been output yet.
-                    min_poc_ref = dpb_buffer_.frame_buffer_list[i].pic_order_cnt;
-                    min_poc_pic_idx_ref = i;
-                }
-            } else {
-                if (dpb_buffer_.frame_buffer_list[i].pic_order_cnt < min_poc_no_ref) {
-                    min_poc_no_ref = dpb_buffer_.frame_buffer_list[i].pic_order_cnt;
-                    min_poc_pic_idx_no_ref = i;
-                }
+        if (dpb_buffer_.frame_buffer_list[i].use_status && !dpb_buffer_.frame_buffer_list[i].is_reference) {
+            if (dpb_buffer_.frame_buffer_list[i].pic_order_cnt < min_poc_no_ref) {
+                min_poc_no_ref = dpb_buffer_.frame_buffer_list[i].pic_order_cnt;
+                min_poc_pic_idx_no_ref = i;
             }
         }
     }
@@ -2994,30 +3095,20 @@ ParserResult AvcVideoParser::BumpPicFromDpb() {
         return PARSER_OUT_OF_RANGE;
     }
 
-    // Output any ref pics before (lower POC) the non-ref pic to be bumped out.
-    while (min_poc_ref < min_poc_no_ref) {
+    // Output any ref pics before (lower POC) the non-ref pic to be bumped out. The output heap is ordered by POC, so
+    // every waiting picture with a lower POC than the non-ref pic is a ref pic.
+    while ((min_poc_pic_idx_ref = dpb_engine_.PeekOutput(is_waiting_for_output, &min_poc_ref)) >= 0 && min_poc_ref < min_poc_no_ref) {
+        dpb_engine_.PopOutput();
         dpb_buffer_.frame_buffer_list[min_poc_pic_idx_ref].pic_output_flag = 0;
         if (dpb_buffer_.num_pics_needed_for_output > 0) {
             dpb_buffer_.num_pics_needed_for_output--;
             // Insert into output/display picture list
             if (pfn_display_picture_cb_) {
-                if (num_output_pics_ >= dec_buf_pool_size_) {
-                    ERR("Error! Decode buffer pool overflow!");
+                if (InsertOutputPicture(dpb_buffer_.frame_buffer_list[min_poc_pic_idx_ref].dec_buf_idx) != PARSER_OK) {
                     return PARSER_OUT_OF_RANGE;
-                } else {
-                    output_pic_list_[num_output_pics_] = dpb_buffer_.frame_buffer_list[min_poc_pic_idx_ref].dec_buf_idx;
-                    num_output_pics_++;
                 }
             }
         }
-        min_poc_ref = 0x7FFFFFFF;
-        min_poc_pic_idx_ref = AVC_MAX_DPB_FRAMES;
-        for (i = 0; i < dpb_buffer_.dpb_size; i++) {
-            if (dpb_buffer_.frame_buffer_list[i].pic_output_flag && dpb_buffer_.frame_buffer_list[i].use_status && dpb_buffer_.frame_buffer_list[i].is_reference && dpb_buffer_.frame_buffer_list[i].pic_order_cnt < min_poc_ref) {
-                min_poc_ref = dpb_buffer_.frame_buffer_list[i].pic_order_cnt;
-                min_poc_pic_idx_ref = i;
-            }
-        }
     }
 
     // Mark as "not needed for output"
@@ -3029,12 +3120,8 @@ ParserResult AvcVideoParser::BumpPicFromDpb() {
 
         // Insert into output/display picture list
         if (pfn_display_picture_cb_) {
-            if (num_output_pics_ >= dec_buf_pool_size_) {
-                ERR("Error! Decode buffer pool overflow!");
+            if (InsertOutputPicture(dpb_buffer_.frame_buffer_list[min_poc_pic_idx_no_ref].dec_buf_idx) != PARSER_OK) {
                 return PARSER_OUT_OF_RANGE;
-            } else {
-                output_pic_list_[num_output_pics_] = dpb_buffer_.frame_buffer_list[min_poc_pic_idx_no_ref].dec_buf_idx;
-                num_output_pics_++;
             }
         }
     }
@@ -3048,6 +3135,67 @@ ParserResult AvcVideoParser::BumpPicFromDpb() {
     return PARSER_OK;
 }
 
+void AvcVideoParser::SetNumReorderFrames(AvcSeqParameterSet *p_sps) {
+    uint32_t max_num_reorder_frames = dpb_buffer_.dpb_size - 1;
+    // In decode order every picture is output as soon as it is in the DPB
+    if (parser_params_.decode_order_output) {
+        num_reorder_frames_ = 0;
+        return;
+    }
+    if (p_sps->vui_parameters_present_flag && p_sps->vui_seq_parameters.bitstream_restriction_flag) {
+        num_reorder_frames_ = std::min(p_sps->vui_seq_parameters.num_reorder_frames, max_num_reorder_frames);
+        return;
+    }
+    // With pic_order_cnt_type 2 output order is decoding order (8.2.1.3). Without bitstream_restriction_flag, num_reorder_frames is
+    // inferred to be 0 for the intra profiles (E.2.1).
+    bool intra_profile = p_sps->constraint_set3_flag && (p_sps->profile_idc == 44 || p_sps->profile_idc == 86 || p_sps->profile_idc == 100 ||
+                         p_sps->profile_idc == 110 || p_sps->profile_idc == 122 || p_sps->profile_idc == 244);
+    if (p_sps->pic_order_cnt_type == 2 || intra_profile) {
+        num_reorder_frames_ = 0;
+        return;
+    }
+    // Otherwise it is inferred to be the DPB size: output only when the DPB is full. The reordering seen in earlier pictures does not
+    // bound that of later ones, so it is not used to lower this.
+    num_reorder_frames_ = max_num_reorder_frames;
+}
+
+ParserResult AvcVideoParser::OutputReorderedPics() {
+    auto is_waiting_for_output = [&](int i) {
+        return i < dpb_buffer_.dpb_size && dpb_buffer_.frame_buffer_list[i].pic_output_flag && dpb_buffer_.frame_buffer_list[i].use_status;
+    };
+    if (curr_pic_.pic_output_flag && !parser_params_.decode_order_output) {
+        // A picture that precedes one already output shows that the stream reorders more than assumed: output later pictures
+        // after one more
+        if (curr_pic_.pic_order_cnt < prev_output_poc_ && num_reorder_frames_ < dpb_buffer_.dpb_size - 1) {
+            num_reorder_frames_++;
+        }
+    }
+
+    int i;
+    int32_t poc;
+    while (dpb_buffer_.num_pics_needed_for_output > num_reorder_frames_ && (i = dpb_engine_.PeekOutput(is_waiting_for_output, &poc)) >= 0) {
+        dpb_engine_.PopOutput();
+        dpb_buffer_.frame_buffer_list[i].pic_output_flag = 0;
+        dpb_buffer_.num_pics_needed_for_output--;
+        prev_output_poc_ = poc;
+        // Insert into output/display picture list
+        if (pfn_display_picture_cb_) {
+            if (InsertOutputPicture(dpb_buffer_.frame_buffer_list[i].dec_buf_idx) != PARSER_OK) {
+                return PARSER_OUT_OF_RANGE;
+            }
+        }
+        // A non-reference picture is no longer needed once it is output
+        if (!dpb_buffer_.frame_buffer_list[i].is_reference) {
+            dpb_buffer_.frame_buffer_list[i].use_status = kNotUsed;
+            decode_buffer_pool_[dpb_buffer_.frame_buffer_list[i].dec_buf_idx].use_status &= ~kFrameUsedForDecode;
+            if (dpb_buffer_.dpb_fullness > 0) {
+                dpb_buffer_.dpb_fullness--;
+            }
+        }
+    }
+    return PARSER_OK;
+}
+
 ParserResult AvcVideoParser::InsertCurrPicIntoDpb() {
     int i;
     // We have reserved a spot in DPB already.
@@ -3060,9 +3208,11 @@ ParserResult AvcVideoParser::InsertCurrPicIntoDpb() {
         if (curr_pic_.pic_structure == kFrame) {
             dpb_buffer_.frame_buffer_list[i] = curr_pic_;
             if (dpb_buffer_.frame_buffer_list[i].pic_output_flag) {
-                    dpb_buffer_.num_pics_needed_for_output++;
+                dpb_buffer_.num_pics_needed_for_output++;
+                dpb_engine_.PushOutput(i, dpb_buffer_.frame_buffer_list[i].pic_order_cnt);
             }
             dpb_buffer_.dpb_fullness++;
+            dpb_engine_.IndexFrameNum(curr_pic_.frame_num, i);
             if (curr_pic_.is_reference == kUsedForShortTerm) {
                 dpb_buffer_.num_short_term++;
             } else if (curr_pic_.is_reference == kUsedForLongTerm) {
@@ -3083,6 +3233,7 @@ ParserResult AvcVideoParser::InsertCurrPicIntoDpb() {
                 dpb_buffer_.frame_buffer_list[i] = curr_pic_; // Store several parameters
                 dpb_buffer_.frame_buffer_list[i].pic_structure = kFrame;
                 dpb_buffer_.frame_buffer_list[i].pic_output_flag = 0;
+                dpb_engine_.IndexFrameNum(curr_pic_.frame_num, i);
             } else {
                 dpb_buffer_.field_pic_list[i * 2 + 1] = curr_pic_;
                 if (curr_pic_.pic_structure == kTopField) {
@@ -3095,8 +3246,10 @@ ParserResult AvcVideoParser::InsertCurrPicIntoDpb() {
                 dpb_buffer_.frame_buffer_list[i].use_status = kFrameUsedForDecode;
                 if (dpb_buffer_.frame_buffer_list[i].pic_output_flag) {
                     dpb_buffer_.num_pics_needed_for_output++;
+                    dpb_engine_.PushOutput(i, dpb_buffer_.frame_buffer_list[i].pic_order_cnt);
                 }
                 dpb_buffer_.dpb_fullness++;
+                dpb_engine_.IndexFrameNum(curr_pic_.frame_num, i);
                 if (curr_pic_.is_reference == kUsedForShortTerm) {
                     dpb_buffer_.num_short_term++;
                 } else if (curr_pic_.is_reference == kUsedForLongTerm) {
@@ -3144,6 +3297,8 @@ ParserResult AvcVideoParser::FlushDpb() {
         }
     }
 
+    prev_output_poc_ = INT32_MIN;
+
     // Empty DPB
     for (int i = 0; i < AVC_MAX_DPB_FRAMES; i++) {
         dpb_buffer_.frame_buffer_list[i].use_status = kNotUsed;
@@ -3151,6 +3306,7 @@ ParserResult AvcVideoParser::FlushDpb() {
         dpb_buffer_.field_pic_list[i * 2 + 1].use_status = kNotUsed;
         decode_buffer_pool_[dpb_buffer_.frame_buffer_list[i].dec_buf_idx].use_status = kNotUsed;
     }
+    dpb_engine_.Reset();
     return PARSER_OK;
 }
 
@@ -52,6 +52,14 @@ public:
      */
     virtual rocDecStatus UnInitialize();     // derived method
 
+    /*! \brief Function to get the bytes held by the parser, including its parameter set tables and slice lists
+     */
+    size_t GetMemoryUsage() override {
+        return sizeof(*this) - sizeof(RocVideoParser) + RocVideoParser::GetMemoryUsage() +
+               slice_info_list_.capacity() * sizeof(AvcSliceInfo) + slice_param_list_.capacity() * sizeof(RocdecAvcSliceParams) +
+               slice_header_jobs_.capacity() * sizeof(AvcSliceHeaderJob);
+    }
+
     enum PictureStructure {
         kFrame,
         kTopField,
@@ -92,6 +100,15 @@ protected:
         AvcPicture ref_list_1_[AVC_MAX_REF_PICTURE_NUM];
     } AvcSliceInfo;
 
+    /*! \brief A slice header queued for parsing on the slice header workers
+     */
+    typedef struct {
+        AvcNalUnitHeader nal_unit_header;
+        ParserResult result;
+        uint32_t num_emulation_prevention_bytes;
+        uint8_t rbsp_buf[RBSP_BUF_SIZE];
+    } AvcSliceHeaderJob;
+
     /*! \brief Decoded picture buffer
      */
     typedef struct{
@@ -118,6 +135,8 @@ protected:
     AvcNalUnitHeader   slice_nal_unit_header_;
     std::vector<AvcSliceInfo> slice_info_list_;
     std::vector<RocdecAvcSliceParams> slice_param_list_;
+    std::vector<AvcSliceHeaderJob> slice_header_jobs_;
+    int num_slice_header_jobs_;  // slices of the current picture queued after the parsed ones
 
     int prev_pic_order_cnt_msb_; // prevPicOrderCntMsb
     int prev_pic_order_cnt_lsb_; // prevPicOrderCntLsb
@@ -137,6 +156,10 @@ protected:
     int first_field_pic_idx_;
     int first_field_dec_buf_idx_;
 
+    // Automatic display delay
+    uint32_t num_reorder_frames_;  // pictures that can precede a picture in decoding order while following it in output order
+    int32_t prev_output_poc_;      // POC of the picture last output by OutputReorderedPics(), INT32_MIN after the DPB is flushed
+
     // DPB
     AvcPicture curr_pic_;
     DecodedPictureBuffer dpb_buffer_;
@@ -191,6 +214,25 @@ protected:
      */
     ParserResult ParseSliceHeader(uint8_t *p_stream, size_t stream_size_in_byte, AvcSliceHeader *p_slice_header);
 
+    /*! \brief Function to parse the slice header syntax. It does not change the parser state and may run on the slice header
+     * workers.
+     * \param p_stream The pointer to the input bit stream
+     * \param [in] stream_size_in_byte The byte size of the stream
+     * \param [in] p_nal_unit_header The pointer to the NAL unit header of the slice
+     * \param [in] p_sps The pointer to the SPS the slice refers to
+     * \param [in] p_pps The pointer to the PPS the slice refers to
+     * \param [out] p_slice_header The pointer to the slice header strucutre
+     * \return <tt>ParserResult</tt>
+     */
+    ParserResult ParseSliceHeaderSyntax(uint8_t *p_stream, size_t stream_size_in_byte, AvcNalUnitHeader *p_nal_unit_header,
+                                        AvcSeqParameterSet *p_sps, AvcPicParameterSet *p_pps, AvcSliceHeader *p_slice_header);
+
+    /*! \brief Function to parse the queued slice headers of the current picture on the slice header workers, and to set up
+     * their reference lists in decoding order
+     * \return <tt>ParserResult</tt>
+     */
+    ParserResult ParseQueuedSliceHeaders();
+
     /*! \brief Function to parse a scaling list
      * \param [in] p_stream A pointer of <tt>uint8_t</tt> for the input stream to be parsed
      * \param [in/out] offset Current bit offset
@@ -270,6 +312,17 @@ protected:
      */
     ParserResult FindFreeBufInDpb();
 
+    /*! \brief Function to find an unused frame buffer slot in DPB
+     * \return The DPB buffer index of the free slot, or -1 if DPB is full
+     */
+    int FindFreeInDpb();
+
+    /*! \brief Function to find the short-term reference frame with the given picture number in DPB
+     * \param [in] pic_num The frame picture number (PicNum)
+     * \return The DPB buffer index of the frame, or -1 if it is not in DPB
+     */
+    int FindShortTermRefFrame(int pic_num);
+
     /*! \brief Function to mark decoded reference picture in DPB. 8.2.5. This step is 
      * performed after the current picture is decoded, for future pictures.
      * \return <tt>ParserResult</tt>
@@ -281,6 +334,20 @@ protected:
      */
     ParserResult BumpPicFromDpb();
 
+    /*! \brief Function to set the reorder depth of a new sequence for the automatic display delay: the VUI num_reorder_frames,
+     * 0 where it is inferred to be 0 (E.2.1) or output order is decoding order, and otherwise dpb_size - 1 (output when the DPB is
+     * full). In decode order it is 0.
+     * \param [in] p_sps Pointer to the active SPS
+     */
+    void SetNumReorderFrames(AvcSeqParameterSet *p_sps);
+
+    /*! \brief Function to output pictures in POC order while more than num_reorder_frames_ are waiting for output, with the
+     * automatic display delay or in decode order. Output non-reference pictures are removed from DPB. The reorder depth is raised when the current
+     * picture shows more reordering than assumed.
+     * \return <tt>ParserResult</tt>
+     */
+    ParserResult OutputReorderedPics();
+
     /*! \brief Function to insert the current picture into DPB.
      * \return <tt>ParserResult</tt>
      */
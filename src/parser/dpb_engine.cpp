@@ -0,0 +1,84 @@
+/*
+Copyright (c) 2023 - 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include "dpb_engine.h"
+
+void DpbEngine::Reset() {
+    output_heap_.clear();
+    poc_index_.Clear();
+    frame_num_index_.Clear();
+}
+
+size_t DpbEngine::GetMemoryUsage() const {
+    return output_heap_.capacity() * sizeof(OutputEntry) + slot_generation_.capacity() * sizeof(uint32_t) + poc_index_.GetMemoryUsage() +
+           frame_num_index_.GetMemoryUsage();
+}
+
+void DpbEngine::SlotIndex::Insert(int32_t key, int slot) {
+    if (slot >= key_of_slot_.size()) {
+        key_of_slot_.resize(slot + 1, 0);
+        slot_indexed_.resize(slot + 1, false);
+    }
+    // the picture that held the slot has left the DPB
+    if (slot_indexed_[slot]) {
+        auto it = slot_of_key_.find(key_of_slot_[slot]);
+        if (it != slot_of_key_.end() && it->second == slot) {
+            slot_of_key_.erase(it);
+        }
+    }
+    // a key is held by one picture at a time
+    auto it = slot_of_key_.find(key);
+    if (it != slot_of_key_.end()) {
+        slot_indexed_[it->second] = false;
+    }
+    slot_of_key_[key] = slot;
+    key_of_slot_[slot] = key;
+    slot_indexed_[slot] = true;
+}
+
+void DpbEngine::SlotIndex::Clear() {
+    slot_of_key_.clear();
+    std::fill(slot_indexed_.begin(), slot_indexed_.end(), false);
+}
+
+size_t DpbEngine::SlotIndex::GetMemoryUsage() const {
+    // the map nodes are estimated as the key/value pair plus the chaining pointer
+    return slot_of_key_.bucket_count() * sizeof(void *) + slot_of_key_.size() * (sizeof(std::pair<const int32_t, int>) + sizeof(void *)) +
+           key_of_slot_.capacity() * sizeof(int32_t) + slot_indexed_.capacity() / 8;
+}
+
+void DpbEngine::PushOutput(int slot, int32_t poc) {
+    if (slot >= slot_generation_.size()) {
+        slot_generation_.resize(slot + 1, 0);
+    }
+    OutputEntry entry = {poc, slot, ++slot_generation_[slot]};
+    output_heap_.push_back(entry);
+    std::push_heap(output_heap_.begin(), output_heap_.end(), OutputAfter);
+}
+
+void DpbEngine::PopOutput() {
+    if (output_heap_.empty()) {
+        return;
+    }
+    std::pop_heap(output_heap_.begin(), output_heap_.end(), OutputAfter);
+    output_heap_.pop_back();
+}
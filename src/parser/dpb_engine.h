@@ -0,0 +1,171 @@
+/*
+Copyright (c) 2023 - 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+
+/**
+ * @brief Codec-agnostic bookkeeping shared by the DPB implementations of the parsers.
+ *
+ * The picture slots themselves stay in the codec specific DPB structs, which own the reference marking rules. The engine
+ * keeps the ordered structures on the side:
+ *  - a POC-ordered min-heap of the pictures that are waiting for output, used for bumping,
+ *  - POC and frame_num index maps to find pictures without scanning the DPB,
+ *  - a free slot search shared by the DPB and the decode buffer pool allocators.
+ * The codec code changes the state of its slots in many places, so every heap entry and every index lookup is validated
+ * against the slot state with a predicate supplied by the caller, and stale heap entries are dropped lazily. Each slot has
+ * at most one entry per index, which is replaced when the slot is indexed again, so the index maps never outgrow the DPB
+ * and a miss means that the picture is not in the DPB.
+ */
+class DpbEngine {
+public:
+    DpbEngine() {};
+    ~DpbEngine() {};
+
+    /*! \brief Function to drop all output entries and index maps, e.g. when the DPB is emptied
+     */
+    void Reset();
+
+    /*! \brief Function to get the bytes held by the output heap and the index maps
+     */
+    size_t GetMemoryUsage() const;
+
+    /*! \brief Function to queue a picture for output in POC order. A slot that is queued again replaces its previous entry.
+     * \param [in] slot Index of the picture in the DPB
+     * \param [in] poc Picture order count used for ordering; ties are output in slot order
+     */
+    void PushOutput(int slot, int32_t poc);
+
+    /*! \brief Function to get the picture with the smallest POC that is still waiting for output
+     * \param [in] is_waiting Predicate that checks with the DPB whether a slot is still waiting for output
+     * \param [out] poc POC of the returned picture
+     * \return The DPB slot index of the picture, or -1 if no picture is waiting
+     */
+    template <typename IsWaiting>
+    int PeekOutput(IsWaiting is_waiting, int32_t *poc = nullptr) {
+        while (!output_heap_.empty()) {
+            const OutputEntry &top = output_heap_.front();
+            if (top.generation == slot_generation_[top.slot] && is_waiting(top.slot)) {
+                if (poc) {
+                    *poc = top.poc;
+                }
+                return top.slot;
+            }
+            PopOutput();
+        }
+        return -1;
+    }
+
+    /*! \brief Function to remove the entry returned by PeekOutput
+     */
+    void PopOutput();
+
+    /*! \brief Function to record the DPB slot of a picture with the given POC, replacing the previous entries of the slot and
+     * of the POC
+     */
+    void IndexPoc(int32_t poc, int slot) { poc_index_.Insert(poc, slot); }
+
+    /*! \brief Function to find the picture with the given POC
+     * \param [in] poc Picture order count to look for
+     * \param [in] num_slots Number of DPB slots
+     * \param [in] matches Predicate that checks with the DPB whether a slot holds the picture
+     * \return The DPB slot index, or -1 if there is no such picture
+     */
+    template <typename Matches>
+    int FindPoc(int32_t poc, int num_slots, Matches matches) const {
+        return poc_index_.Find(poc, num_slots, matches);
+    }
+
+    /*! \brief Function to record the DPB slot of a picture with the given frame_num, replacing the previous entries of the
+     * slot and of the frame_num
+     */
+    void IndexFrameNum(int32_t frame_num, int slot) { frame_num_index_.Insert(frame_num, slot); }
+
+    /*! \brief Function to find the picture with the given frame_num
+     * \param [in] frame_num frame_num to look for
+     * \param [in] num_slots Number of DPB slots
+     * \param [in] matches Predicate that checks with the DPB whether a slot holds the picture
+     * \return The DPB slot index, or -1 if there is no such picture
+     */
+    template <typename Matches>
+    int FindFrameNum(int32_t frame_num, int num_slots, Matches matches) const {
+        return frame_num_index_.Find(frame_num, num_slots, matches);
+    }
+
+    /*! \brief Function to find the first free slot of a DPB or of the decode buffer pool
+     * \param [in] num_slots Number of slots
+     * \param [in] is_free Predicate that checks whether a slot is free
+     * \return The index of the first free slot, or -1 if all slots are in use
+     */
+    template <typename IsFree>
+    static int FindFreeSlot(int num_slots, IsFree is_free) {
+        for (int i = 0; i < num_slots; i++) {
+            if (is_free(i)) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+private:
+    typedef struct {
+        int32_t poc;
+        int slot;
+        uint32_t generation;  // slot_generation_ of the slot when the entry was pushed
+    } OutputEntry;
+
+    // std::push_heap builds a max-heap, so the comparison is reversed to keep the smallest POC on top
+    static bool OutputAfter(const OutputEntry &a, const OutputEntry &b) {
+        return a.poc != b.poc ? a.poc > b.poc : a.slot > b.slot;
+    }
+
+    // Key to slot map that holds one entry per slot: indexing a slot again drops its previous key
+    class SlotIndex {
+    public:
+        void Insert(int32_t key, int slot);
+        void Clear();
+        size_t GetMemoryUsage() const;
+
+        template <typename Matches>
+        int Find(int32_t key, int num_slots, Matches matches) const {
+            auto it = slot_of_key_.find(key);
+            // the picture may have left the DPB since it was indexed, but a picture in the DPB is always indexed
+            if (it != slot_of_key_.end() && it->second < num_slots && matches(it->second)) {
+                return it->second;
+            }
+            return -1;
+        }
+
+    private:
+        std::unordered_map<int32_t, int> slot_of_key_;
+        std::vector<int32_t> key_of_slot_;
+        std::vector<bool> slot_indexed_;
+    };
+
+    std::vector<OutputEntry> output_heap_;
+    std::vector<uint32_t> slot_generation_;
+    SlotIndex poc_index_;
+    SlotIndex frame_num_index_;
+};
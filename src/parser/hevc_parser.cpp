@@ -29,6 +29,7 @@ HevcVideoParser::HevcVideoParser() {
     m_active_pps_id_ = -1;
     slice_info_list_.assign(INIT_SLICE_LIST_NUM, {0});
     slice_param_list_.assign(INIT_SLICE_LIST_NUM, {0});
+    num_slice_header_jobs_ = 0;
     memset(&curr_pic_info_, 0, sizeof(HevcPicInfo));
     for (int i = 0; i < MAX_VPS_COUNT; i++) {
         vps_list_[i].is_received = 0;
@@ -55,6 +56,9 @@ rocDecStatus HevcVideoParser::UnInitialize() {
 }
 
 rocDecStatus HevcVideoParser::ParseVideoData(RocdecSourceDataPacket *p_data) {
+    ROCDEC_TRACE_SCOPE("RocVideoParser::ParseVideoData", -1);
+    ParserStatsTimer parse_timer(parse_total_time_ns_);
+    CountPacket(p_data);
     if (p_data->payload && p_data->payload_size) {
         curr_pts_ = p_data->pts;
         if (ParsePictureData(p_data->payload, p_data->payload_size) != PARSER_OK) {
@@ -79,6 +83,7 @@ rocDecStatus HevcVideoParser::ParseVideoData(RocdecSourceDataPacket *p_data) {
         if (num_slices_ == 0) {
             return ROCDEC_SUCCESS;
         }
+        stats_.num_pics_parsed++;
 
         // Decode the picture
         if (SendPicForDecode() != PARSER_OK) {
@@ -201,7 +206,7 @@ int HevcVideoParser::FillSeqCallbackFn(HevcSeqParamSet* sps_data) {
     video_format_params_.seqhdr_data_length = 0;
 
     // callback function with RocdecVideoFormat params filled out
-    if (pfn_sequece_cb_(parser_params_.user_data, &video_format_params_) == 0) {
+    if (CallSequenceCallback() == 0) {
         ERR("Sequence callback function failed.");
         return PARSER_FAIL;
     } else {
@@ -216,7 +221,7 @@ void HevcVideoParser::SendSeiMsgPayload() {
     sei_message_info_params_.picIdx = curr_pic_info_.dec_buf_idx;
 
     // callback function with RocdecSeiMessageInfo params filled out
-    if (pfn_get_sei_message_cb_) pfn_get_sei_message_cb_(parser_params_.user_data, &sei_message_info_params_);
+    CallSeiMessageCallback();
 }
 
 int HevcVideoParser::SendPicForDecode() {
@@ -514,7 +519,8 @@ int HevcVideoParser::SendPicForDecode() {
     PrintVappiBufInfo();
 #endif // DBGINFO
 
-    if (pfn_decode_picture_cb_(parser_params_.user_data, &dec_pic_params_) == 0) {
+    ROCDEC_TRACE_SCOPE("RocVideoParser::DecodePicture", dec_pic_params_.curr_pic_idx);
+    if (CallDecodePictureCallback() == 0) {
         ERR("Decode error occurred.");
         return PARSER_FAIL;
     } else {
@@ -534,6 +540,7 @@ ParserResult HevcVideoParser::ParsePictureData(const uint8_t* p_stream, uint32_t
     next_start_code_offset_ = 0;
 
     num_slices_ = 0;
+    num_slice_header_jobs_ = 0;
     sei_message_count_ = 0;
     sei_payload_size_ = 0;
 
@@ -549,6 +556,13 @@ ParserResult HevcVideoParser::ParsePictureData(const uint8_t* p_stream, uint32_t
             int ebsp_size = nal_unit_size_ - 5 > RBSP_BUF_SIZE ? RBSP_BUF_SIZE : nal_unit_size_ - 5; // only copy enough bytes for header parsing
 
             nal_unit_header_ = ParseNalUnitHeader(&pic_data_buffer_ptr_[curr_start_code_offset_ + 3]);
+            CountUnit(nal_unit_header_.nal_unit_type);
+            // The queued slice segment headers are parsed with the parameter sets that are active now
+            if (num_slice_header_jobs_ > 0 && nal_unit_header_.nal_unit_type >= NAL_UNIT_VPS && nal_unit_header_.nal_unit_type <= NAL_UNIT_PPS) {
+                if ((ret2 = ParseQueuedSliceHeaders()) != PARSER_OK) {
+                    return ret2;
+                }
+            }
             switch (nal_unit_header_.nal_unit_type) {
                 case NAL_UNIT_VPS: {
                     memcpy(rbsp_buf_, (pic_data_buffer_ptr_ + curr_start_code_offset_ + 5), ebsp_size);
@@ -590,13 +604,25 @@ ParserResult HevcVideoParser::ParsePictureData(const uint8_t* p_stream, uint32_t
                     // Save slice NAL unit header
                     slice_nal_unit_header_ = nal_unit_header_;
 
-                    // Resize slice info list if needed
-                    if ((num_slices_ + 1) > slice_info_list_.size()) {
-                        slice_info_list_.resize(num_slices_ + 1, {0});
+                    // Resize slice info list if needed. Queued slice segments follow the parsed ones.
+                    int slice_idx = num_slices_ + num_slice_header_jobs_;
+                    if ((slice_idx + 1) > slice_info_list_.size()) {
+                        slice_info_list_.resize(slice_idx + 1, {0});
                     }
 
-                    slice_info_list_[num_slices_].slice_data_offset = curr_start_code_offset_;
-                    slice_info_list_[num_slices_].slice_data_size = nal_unit_size_;
+                    slice_info_list_[slice_idx].slice_data_offset = curr_start_code_offset_;
+                    slice_info_list_[slice_idx].slice_data_size = nal_unit_size_;
+
+                    // Only the first slice segment of a picture changes the DPB state. The headers of the others are queued and
+                    // parsed together by ParseQueuedSliceHeaders().
+                    if (num_slices_ > 0) {
+                        if ((num_slice_header_jobs_ + 1) > slice_header_jobs_.size()) {
+                            slice_header_jobs_.resize(num_slice_header_jobs_ + 1);
+                        }
+                        slice_header_jobs_[num_slice_header_jobs_].nal_unit_header = nal_unit_header_;
+                        num_slice_header_jobs_++;
+                        break;
+                    }
 
                     memcpy(rbsp_buf_, (pic_data_buffer_ptr_ + curr_start_code_offset_ + 5), ebsp_size);
                     rbsp_size_ = EbspToRbsp(rbsp_buf_, 0, ebsp_size);
@@ -607,63 +633,64 @@ ParserResult HevcVideoParser::ParsePictureData(const uint8_t* p_stream, uint32_t
                     }
 
                     // Start decode process
-                    if (num_slices_ == 0) {
-                        // Use the data directly from demuxer without copying
-                        pic_stream_data_ptr_ = pic_data_buffer_ptr_ + curr_start_code_offset_;
-                        // Picture stream data size is calculated as the diff between the frame end and the first slice offset.
-                        // This is to consider the possibility of non-slice NAL units between slices.
-                        pic_stream_data_size_ = pic_data_size - curr_start_code_offset_;
-
-                        if (IsIrapPic(&slice_nal_unit_header_)) {
-                            if (IsIdrPic(&slice_nal_unit_header_) || IsBlaPic(&slice_nal_unit_header_) || pic_count_ == 0 || first_pic_after_eos_nal_unit_) {
-                                no_rasl_output_flag_ = 1;
-                            } else {
-                                no_rasl_output_flag_ = 0;
-                            }
-                        }
-
-                        if (first_pic_after_eos_nal_unit_) {
-                            first_pic_after_eos_nal_unit_ = 0;  // clear the flag
-                        }
-
-                        if (IsRaslPic(&slice_nal_unit_header_) && no_rasl_output_flag_ == 1) {
-                            curr_pic_info_.pic_output_flag = 0;
+                    // Use the data directly from demuxer without copying
+                    pic_stream_data_ptr_ = pic_data_buffer_ptr_ + curr_start_code_offset_;
+                    // Picture stream data size is calculated as the diff between the frame end and the first slice offset.
+                    // This is to consider the possibility of non-slice NAL units between slices.
+                    pic_stream_data_size_ = pic_data_size - curr_start_code_offset_;
+
+                    if (IsIrapPic(&slice_nal_unit_header_)) {
+                        if (IsIdrPic(&slice_nal_unit_header_) || IsBlaPic(&slice_nal_unit_header_) || pic_count_ == 0 || first_pic_after_eos_nal_unit_) {
+                            no_rasl_output_flag_ = 1;
                         } else {
-                            curr_pic_info_.pic_output_flag = p_slice_header->pic_output_flag;
+                            no_rasl_output_flag_ = 0;
                         }
+                    }
 
-                        // Get POC. 8.3.1.
-                        CalculateCurrPoc();
+                    if (first_pic_after_eos_nal_unit_) {
+                        first_pic_after_eos_nal_unit_ = 0;  // clear the flag
+                    }
 
-                        // Locate a free buffer for the current picutre in decode buffer pool before output picture marking (C.5.2.2)
-                        if (FindFreeInDecBufPool() != PARSER_OK) {
-                            return PARSER_FAIL;
-                        }
+                    if (IsRaslPic(&slice_nal_unit_header_) && no_rasl_output_flag_ == 1) {
+                        curr_pic_info_.pic_output_flag = 0;
+                    } else {
+                        curr_pic_info_.pic_output_flag = p_slice_header->pic_output_flag;
+                    }
+
+                    // Get POC. 8.3.1.
+                    CalculateCurrPoc();
 
-                        // Decode RPS. 8.3.2.
-                        DecodeRps();
+                    // Locate a free buffer for the current picture in decode buffer pool before output picture marking (C.5.2.2).
+                    // A tight pool only has room for it after the pictures no longer needed are removed from the DPB.
+                    if (!parser_params_.tight_surface_pool && FindFreeInDecBufPool() != PARSER_OK) {
+                        return PARSER_FAIL;
                     }
 
+                    // Decode RPS. 8.3.2.
+                    DecodeRps();
+
                     // Construct ref lists. 8.3.4.
                     if(p_slice_header->slice_type != HEVC_SLICE_TYPE_I) {
                         ConstructRefPicLists(&slice_info_list_[num_slices_]);
                     }
 
-                    if (num_slices_ == 0) {
-                        // C.5.2.2. Mark output buffers. (After 8.3.2.)
-                        if (MarkOutputPictures() != PARSER_OK) {
-                            return PARSER_FAIL;
-                        }
+                    // C.5.2.2. Mark output buffers. (After 8.3.2.)
+                    if (MarkOutputPictures() != PARSER_OK) {
+                        return PARSER_FAIL;
+                    }
 
-                        // C.5.2.3. Find a free buffer in DPB and mark as used. (After 8.3.2.)
-                        if (FindFreeInDpbAndMark() != PARSER_OK) {
-                            return PARSER_FAIL;
-                        }
+                    if (parser_params_.tight_surface_pool && FindFreeInDecBufPool() != PARSER_OK) {
+                        return PARSER_FAIL;
+                    }
+
+                    // C.5.2.3. Find a free buffer in DPB and mark as used. (After 8.3.2.)
+                    if (FindFreeInDpbAndMark() != PARSER_OK) {
+                        return PARSER_FAIL;
+                    }
 
 #if DBGINFO
-                        PrintDpb();
+                    PrintDpb();
 #endif // DBGINFO
-                    }
                     num_slices_++;
                     break;
                 }
@@ -710,6 +737,9 @@ ParserResult HevcVideoParser::ParsePictureData(const uint8_t* p_stream, uint32_t
         }
     } while (1);
 
+    if (num_slice_header_jobs_ > 0) {
+        return ParseQueuedSliceHeaders();
+    }
     return PARSER_OK;
 }
 
@@ -1509,19 +1539,17 @@ ParserResult HevcVideoParser::ParseSliceHeader(uint8_t *nalu, size_t size, HevcS
     HevcPicParamSet *pps_ptr = nullptr;
     HevcSeqParamSet *sps_ptr = nullptr;
     size_t offset = 0;
-    HevcSliceSegHeader temp_sh;
-    memset(p_slice_header, 0, sizeof(HevcSliceSegHeader));
-    memset(&temp_sh, 0, sizeof(temp_sh));
+    ParserResult ret;
 
-    temp_sh.first_slice_segment_in_pic_flag = p_slice_header->first_slice_segment_in_pic_flag = Parser::GetBit(nalu, offset);
+    // Read up to the PPS id to activate the parameter sets. ParseSliceHeaderSyntax() parses the header from its start.
+    Parser::GetBit(nalu, offset);  // first_slice_segment_in_pic_flag
     if (IsIrapPic(&slice_nal_unit_header_)) {
-        temp_sh.no_output_of_prior_pics_flag = p_slice_header->no_output_of_prior_pics_flag = Parser::GetBit(nalu, offset);
+        Parser::GetBit(nalu, offset);  // no_output_of_prior_pics_flag
     }
 
     // Set active VPS, SPS and PPS for the current slice
     m_active_pps_id_ = Parser::ExpGolomb::ReadUe(nalu, offset);
     CHECK_ALLOWED_MAX(m_active_pps_id_, (MAX_PPS_COUNT - 1));
-    temp_sh.slice_pic_parameter_set_id = p_slice_header->slice_pic_parameter_set_id = m_active_pps_id_;
     pps_ptr = &pps_list_[m_active_pps_id_];
     if ( pps_ptr->is_received == 0) {
         ERR("Empty PPS is referred.");
@@ -1557,9 +1585,11 @@ ParserResult HevcVideoParser::ParseSliceHeader(uint8_t *nalu, size_t size, HevcS
         new_seq_activated_ = true;  // Note: clear this flag after the actions are taken.
     }
 
-    // Check and adjust decode buffer pool size if needed
+    // Check and adjust decode buffer pool size if needed. A new picture takes its buffer after C.5.2.2, when the DPB has at
+    // most sps_max_dec_pic_buffering - 1 pictures. With reordering, a picture bumped out of the DPB there keeps its buffer
+    // until it is displayed after the new picture is submitted.
     if (new_seq_activated_) {
-        CheckAndAdjustDecBufPoolSize(dpb_buffer_.dpb_size);
+        CheckAndAdjustDecBufPoolSize(dpb_buffer_.dpb_size, dpb_buffer_.dpb_size + (GetMaxNumReorderPics(sps_ptr) > 0 ? 1 : 0));
     }
 
     // Set frame rate if available
@@ -1576,12 +1606,30 @@ ParserResult HevcVideoParser::ParseSliceHeader(uint8_t *nalu, size_t size, HevcS
         }
     }
 
+    if ((ret = ParseSliceHeaderSyntax(nalu, size, &slice_nal_unit_header_, pps_ptr, sps_ptr, p_slice_header, &num_pic_total_curr_)) != PARSER_OK) {
+        return ret;
+    }
+    CompleteSliceSegHeader(p_slice_header);
+    return PARSER_OK;
+}
+
+ParserResult HevcVideoParser::ParseSliceHeaderSyntax(uint8_t *nalu, size_t size, HevcNalUnitHeader *p_nal_unit_header, HevcPicParamSet *pps_ptr,
+                                                     HevcSeqParamSet *sps_ptr, HevcSliceSegHeader *p_slice_header, uint32_t *p_num_pic_total_curr) {
+    size_t offset = 0;
+    memset(p_slice_header, 0, sizeof(HevcSliceSegHeader));
+
+    p_slice_header->first_slice_segment_in_pic_flag = Parser::GetBit(nalu, offset);
+    if (IsIrapPic(p_nal_unit_header)) {
+        p_slice_header->no_output_of_prior_pics_flag = Parser::GetBit(nalu, offset);
+    }
+    p_slice_header->slice_pic_parameter_set_id = Parser::ExpGolomb::ReadUe(nalu, offset);
+
     if (!p_slice_header->first_slice_segment_in_pic_flag) {
         if (pps_ptr->dependent_slice_segments_enabled_flag) {
-            temp_sh.dependent_slice_segment_flag = p_slice_header->dependent_slice_segment_flag = Parser::GetBit(nalu, offset);
+            p_slice_header->dependent_slice_segment_flag = Parser::GetBit(nalu, offset);
         }
         int bits_slice_segment_address = (int)ceilf(log2f((float)pic_size_in_ctbs_y_));
-        temp_sh.slice_segment_address = p_slice_header->slice_segment_address = Parser::ReadBits(nalu, offset, bits_slice_segment_address);
+        p_slice_header->slice_segment_address = Parser::ReadBits(nalu, offset, bits_slice_segment_address);
         //todo:: check for max slice_segment_address and error if exceeds max
     }
 
@@ -1601,7 +1649,7 @@ ParserResult HevcVideoParser::ParseSliceHeader(uint8_t *nalu, size_t size, HevcS
             p_slice_header->colour_plane_id = Parser::ReadBits(nalu, offset, 2);
         }
 
-        if (slice_nal_unit_header_.nal_unit_type != NAL_UNIT_CODED_SLICE_IDR_W_RADL && slice_nal_unit_header_.nal_unit_type != NAL_UNIT_CODED_SLICE_IDR_N_LP) {
+        if (p_nal_unit_header->nal_unit_type != NAL_UNIT_CODED_SLICE_IDR_W_RADL && p_nal_unit_header->nal_unit_type != NAL_UNIT_CODED_SLICE_IDR_N_LP) {
             //length of slice_pic_order_cnt_lsb is log2_max_pic_order_cnt_lsb_minus4 + 4 bits.
             p_slice_header->slice_pic_order_cnt_lsb = Parser::ReadBits(nalu, offset, (sps_ptr->log2_max_pic_order_cnt_lsb_minus4 + 4));
 
@@ -1702,16 +1750,16 @@ ParserResult HevcVideoParser::ParseSliceHeader(uint8_t *nalu, size_t size, HevcS
 
             // 7.3.6.2 Reference picture list modification
             // Calculate NumPicTotalCurr
-            num_pic_total_curr_ = 0;
+            *p_num_pic_total_curr = 0;
             HevcShortTermRps *st_rps_ptr = &p_slice_header->st_rps;
             for (int i = 0; i < st_rps_ptr->num_negative_pics; i++) {
                 if (st_rps_ptr->used_by_curr_pic_s0[i]) {
-                    num_pic_total_curr_++;
+                    (*p_num_pic_total_curr)++;
                 }
             }
             for (int i = 0; i < st_rps_ptr->num_positive_pics; i++) {
                 if (st_rps_ptr->used_by_curr_pic_s1[i]) {
-                    num_pic_total_curr_++;
+                    (*p_num_pic_total_curr)++;
                 }
             }
 
@@ -1719,14 +1767,14 @@ ParserResult HevcVideoParser::ParseSliceHeader(uint8_t *nalu, size_t size, HevcS
             // Check the combined list
             for (int i = 0; i < lt_rps_ptr->num_of_pics; i++) {
                 if (lt_rps_ptr->used_by_curr_pic[i]) {
-                    num_pic_total_curr_++;
+                    (*p_num_pic_total_curr)++;
                 }
             }
 
-            if (pps_ptr->lists_modification_present_flag && num_pic_total_curr_ > 1)
+            if (pps_ptr->lists_modification_present_flag && *p_num_pic_total_curr > 1)
             {
                 int list_entry_bits = 0;
-                while ((1 << list_entry_bits) < num_pic_total_curr_) {
+                while ((1 << list_entry_bits) < *p_num_pic_total_curr) {
                     list_entry_bits++;
                 }
 
@@ -1804,16 +1852,6 @@ ParserResult HevcVideoParser::ParseSliceHeader(uint8_t *nalu, size_t size, HevcS
 !p_slice_header->slice_deblocking_filter_disabled_flag)) {
             p_slice_header->slice_loop_filter_across_slices_enabled_flag = Parser::GetBit(nalu, offset);
         }
-
-        memcpy(&slice_header_copy_, p_slice_header, sizeof(HevcSliceSegHeader));
-    } else {
-        //dependant slice
-        memcpy(p_slice_header, &slice_header_copy_, sizeof(HevcSliceSegHeader));
-        p_slice_header->first_slice_segment_in_pic_flag = temp_sh.first_slice_segment_in_pic_flag;
-        p_slice_header->no_output_of_prior_pics_flag = temp_sh.no_output_of_prior_pics_flag;
-        p_slice_header->slice_pic_parameter_set_id = temp_sh.slice_pic_parameter_set_id;
-        p_slice_header->dependent_slice_segment_flag = temp_sh.dependent_slice_segment_flag;
-        p_slice_header->slice_segment_address = temp_sh.slice_segment_address;
     }
     if (pps_ptr->tiles_enabled_flag || pps_ptr->entropy_coding_sync_enabled_flag) {
         int max_num_entry_point_offsets;  // 7.4.7.1
@@ -1848,10 +1886,77 @@ ParserResult HevcVideoParser::ParseSliceHeader(uint8_t *nalu, size_t size, HevcS
     }
 #endif
 
+    return PARSER_OK;
+}
+
+void HevcVideoParser::CompleteSliceSegHeader(HevcSliceSegHeader *p_slice_header) {
+    if (!p_slice_header->dependent_slice_segment_flag) {
+        memcpy(&slice_header_copy_, p_slice_header, sizeof(HevcSliceSegHeader));
+    } else {
+        //dependant slice
+        HevcSliceSegHeader temp_sh;
+        memcpy(&temp_sh, p_slice_header, sizeof(HevcSliceSegHeader));
+        memcpy(p_slice_header, &slice_header_copy_, sizeof(HevcSliceSegHeader));
+        p_slice_header->first_slice_segment_in_pic_flag = temp_sh.first_slice_segment_in_pic_flag;
+        p_slice_header->no_output_of_prior_pics_flag = temp_sh.no_output_of_prior_pics_flag;
+        p_slice_header->slice_pic_parameter_set_id = temp_sh.slice_pic_parameter_set_id;
+        p_slice_header->dependent_slice_segment_flag = temp_sh.dependent_slice_segment_flag;
+        p_slice_header->slice_segment_address = temp_sh.slice_segment_address;
+        p_slice_header->num_entry_point_offsets = temp_sh.num_entry_point_offsets;
+    }
+
 #if DBGINFO
     PrintSliceSegHeader(p_slice_header);
 #endif // DBGINFO
+}
 
+ParserResult HevcVideoParser::ParseQueuedSliceHeaders() {
+    int num_jobs = num_slice_header_jobs_;
+    num_slice_header_jobs_ = 0;
+
+    // The headers only read the active parameter sets, which stay as they are until the jobs are done, and write their own
+    // slice info and job
+    HevcPicParamSet *pps_ptr = &pps_list_[m_active_pps_id_];
+    HevcSeqParamSet *sps_ptr = &sps_list_[m_active_sps_id_];
+    RunSliceHeaderJobs(num_jobs, [&](int i) {
+        HevcSliceHeaderJob *p_job = &slice_header_jobs_[i];
+        HevcSliceInfo *p_slice_info = &slice_info_list_[num_slices_ + i];
+        int ebsp_size = p_slice_info->slice_data_size - 5 > RBSP_BUF_SIZE ? RBSP_BUF_SIZE : p_slice_info->slice_data_size - 5;
+        memcpy(p_job->rbsp_buf, (pic_data_buffer_ptr_ + p_slice_info->slice_data_offset + 5), ebsp_size);
+        size_t rbsp_size = ConvertEbspToRbsp(p_job->rbsp_buf, 0, ebsp_size, &p_job->num_emulation_prevention_bytes);
+        p_job->num_pic_total_curr = 0;
+        p_job->result = ParseSliceHeaderSyntax(p_job->rbsp_buf, rbsp_size, &p_job->nal_unit_header, pps_ptr, sps_ptr, &p_slice_info->slice_header,
+                                               &p_job->num_pic_total_curr);
+        if (p_job->result == PARSER_OK && p_slice_info->slice_header.slice_pic_parameter_set_id != m_active_pps_id_) {
+            ERR("Slice segments of a picture refer to different PPSs.");
+            p_job->result = PARSER_WRONG_STATE;
+        }
+    });
+
+    // Merge the slice segments in decoding order, dropping the ones with errors
+    int num_slices = num_slices_;
+    for (int i = 0; i < num_jobs; i++) {
+        HevcSliceHeaderJob *p_job = &slice_header_jobs_[i];
+        stats_.num_emulation_prevention_bytes += p_job->num_emulation_prevention_bytes;
+        if (p_job->result != PARSER_OK) {
+            continue;
+        }
+        if (num_slices != num_slices_ + i) {
+            slice_info_list_[num_slices] = slice_info_list_[num_slices_ + i];
+        }
+        HevcSliceInfo *p_slice_info = &slice_info_list_[num_slices];
+        if (!p_slice_info->slice_header.dependent_slice_segment_flag && p_slice_info->slice_header.slice_type != HEVC_SLICE_TYPE_I) {
+            num_pic_total_curr_ = p_job->num_pic_total_curr;
+        }
+        CompleteSliceSegHeader(&p_slice_info->slice_header);
+
+        // Construct ref lists. 8.3.4.
+        if (p_slice_info->slice_header.slice_type != HEVC_SLICE_TYPE_I) {
+            ConstructRefPicLists(p_slice_info);
+        }
+        num_slices++;
+    }
+    num_slices_ = num_slices;
     return PARSER_OK;
 }
 
@@ -2006,32 +2111,26 @@ void HevcVideoParser::DecodeRps() {
 
         /// Short term reference pictures
         for (i = 0; i < num_poc_st_curr_before_; i++) {
-            for (j = 0; j < HEVC_MAX_DPB_FRAMES; j++) {
-                if (poc_st_curr_before_[i] == dpb_buffer_.frame_buffer_list[j].pic_order_cnt && dpb_buffer_.frame_buffer_list[j].use_status != kNotUsed) {
-                    ref_pic_set_st_curr_before_[i] = j;  // RefPicSetStCurrBefore. Use DPB buffer index for now
-                    dpb_buffer_.frame_buffer_list[j].is_reference = kUsedForShortTerm;
-                    break;
-                }
+            j = FindDpbPoc(poc_st_curr_before_[i]);
+            if (j >= 0) {
+                ref_pic_set_st_curr_before_[i] = j;  // RefPicSetStCurrBefore. Use DPB buffer index for now
+                dpb_buffer_.frame_buffer_list[j].is_reference = kUsedForShortTerm;
             }
         }
 
         for (i = 0; i < num_poc_st_curr_after_; i++) {
-            for (j = 0; j < HEVC_MAX_DPB_FRAMES; j++) {
-                if (poc_st_curr_after_[i] == dpb_buffer_.frame_buffer_list[j].pic_order_cnt && dpb_buffer_.frame_buffer_list[j].use_status != kNotUsed) {
-                    ref_pic_set_st_curr_after_[i] = j;  // RefPicSetStCurrAfter
-                    dpb_buffer_.frame_buffer_list[j].is_reference = kUsedForShortTerm;
-                    break;
-                }
+            j = FindDpbPoc(poc_st_curr_after_[i]);
+            if (j >= 0) {
+                ref_pic_set_st_curr_after_[i] = j;  // RefPicSetStCurrAfter
+                dpb_buffer_.frame_buffer_list[j].is_reference = kUsedForShortTerm;
             }
         }
 
         for ( i = 0; i < num_poc_st_foll_; i++ ) {
-            for (j = 0; j < HEVC_MAX_DPB_FRAMES; j++) {
-                if (poc_st_foll_[i] == dpb_buffer_.frame_buffer_list[j].pic_order_cnt && dpb_buffer_.frame_buffer_list[j].use_status != kNotUsed) {
-                    ref_pic_set_st_foll_[i] = j;  // RefPicSetStFoll
-                    dpb_buffer_.frame_buffer_list[j].is_reference = kUsedForShortTerm;
-                    break;
-                }
+            j = FindDpbPoc(poc_st_foll_[i]);
+            if (j >= 0) {
+                ref_pic_set_st_foll_[i] = j;  // RefPicSetStFoll
+                dpb_buffer_.frame_buffer_list[j].is_reference = kUsedForShortTerm;
             }
         }
 
@@ -2139,6 +2238,7 @@ void HevcVideoParser::InitDpb() {
     dpb_buffer_.dpb_size = 0;
     dpb_buffer_.dpb_fullness = 0;
     dpb_buffer_.num_pics_needed_for_output = 0;
+    dpb_engine_.Reset();
 }
 
 void HevcVideoParser::EmptyDpb() {
@@ -2151,6 +2251,13 @@ void HevcVideoParser::EmptyDpb() {
     dpb_buffer_.dpb_fullness = 0;
     dpb_buffer_.num_pics_needed_for_output = 0;
     num_output_pics_ = 0;
+    dpb_engine_.Reset();
+}
+
+int HevcVideoParser::FindDpbPoc(int32_t poc) {
+    return dpb_engine_.FindPoc(poc, HEVC_MAX_DPB_FRAMES, [&](int i) {
+        return dpb_buffer_.frame_buffer_list[i].pic_order_cnt == poc && dpb_buffer_.frame_buffer_list[i].use_status != kNotUsed;
+    });
 }
 
 int HevcVideoParser::FlushDpb() {
@@ -2207,7 +2314,7 @@ int HevcVideoParser::MarkOutputPictures() {
 
         HevcSeqParamSet *sps_ptr = &sps_list_[m_active_sps_id_];
         uint32_t highest_tid = sps_ptr->sps_max_sub_layers_minus1; // HighestTid
-        uint32_t max_num_reorder_pics = sps_ptr->sps_max_num_reorder_pics[highest_tid];
+        uint32_t max_num_reorder_pics = GetMaxNumReorderPics(sps_ptr);
         uint32_t max_dec_pic_buffering = sps_ptr->sps_max_dec_pic_buffering_minus1[highest_tid] + 1;
 
         while (dpb_buffer_.dpb_fullness >= max_dec_pic_buffering) {
@@ -2229,15 +2336,9 @@ int HevcVideoParser::MarkOutputPictures() {
 }
 
 ParserResult HevcVideoParser::FindFreeInDecBufPool() {
-    int dec_buf_index;
-
     // Find a free buffer in decode buffer pool
-    for (dec_buf_index = 0; dec_buf_index < dec_buf_pool_size_; dec_buf_index++) {
-        if (decode_buffer_pool_[dec_buf_index].use_status == kNotUsed) {
-            break;
-        }
-    }
-    if (dec_buf_index == dec_buf_pool_size_) {
+    int dec_buf_index = FindFreeDecodeBuffer();
+    if (dec_buf_index < 0) {
         ERR("Could not find a free buffer in decode buffer pool.");
         return PARSER_NOT_FOUND;
     }
@@ -2279,8 +2380,10 @@ ParserResult HevcVideoParser::FindFreeInDpbAndMark() {
 
     if (dpb_buffer_.frame_buffer_list[index].pic_output_flag) {
         dpb_buffer_.num_pics_needed_for_output++;
+        dpb_engine_.PushOutput(index, curr_pic_info_.pic_order_cnt);
     }
     dpb_buffer_.dpb_fullness++;
+    dpb_engine_.IndexPoc(curr_pic_info_.pic_order_cnt, index);
 
     // Mark as used in decode buffer pool
     decode_buffer_pool_[curr_pic_info_.dec_buf_idx].use_status |= kFrameUsedForDecode;
@@ -2291,8 +2394,7 @@ ParserResult HevcVideoParser::FindFreeInDpbAndMark() {
     decode_buffer_pool_[curr_pic_info_.dec_buf_idx].pts = curr_pts_;
 
     HevcSeqParamSet *sps_ptr = &sps_list_[m_active_sps_id_];
-    uint32_t highest_tid = sps_ptr->sps_max_sub_layers_minus1; // HighestTid
-    uint32_t max_num_reorder_pics = sps_ptr->sps_max_num_reorder_pics[highest_tid];
+    uint32_t max_num_reorder_pics = GetMaxNumReorderPics(sps_ptr);
 
     while ( dpb_buffer_.num_pics_needed_for_output > max_num_reorder_pics) {
         if (BumpPicFromDpb() != PARSER_OK) {
@@ -2306,22 +2408,14 @@ ParserResult HevcVideoParser::FindFreeInDpbAndMark() {
 }
 
 int HevcVideoParser::BumpPicFromDpb() {
-    int32_t min_poc = 0x7FFFFFFF;  // largest possible POC value 2^31 - 1
-    int min_poc_pic_idx = HEVC_MAX_DPB_FRAMES;
-    int i;
-
-    for (i = 0; i < HEVC_MAX_DPB_FRAMES; i++) {
-        if (dpb_buffer_.frame_buffer_list[i].pic_output_flag && dpb_buffer_.frame_buffer_list[i].use_status) {
-            if (dpb_buffer_.frame_buffer_list[i].pic_order_cnt < min_poc) {
-                min_poc = dpb_buffer_.frame_buffer_list[i].pic_order_cnt;
-                min_poc_pic_idx = i;
-            }
-        }
-    }
-    if (min_poc_pic_idx >= HEVC_MAX_DPB_FRAMES) {
+    int min_poc_pic_idx = dpb_engine_.PeekOutput([&](int i) {
+        return dpb_buffer_.frame_buffer_list[i].pic_output_flag && dpb_buffer_.frame_buffer_list[i].use_status;
+    });
+    if (min_poc_pic_idx < 0) {
         // No picture that is needed for ouput is found
         return PARSER_OK;
     }
+    dpb_engine_.PopOutput();
 
     // Mark as "not needed for output"
     dpb_buffer_.frame_buffer_list[min_poc_pic_idx].pic_output_flag = 0;
@@ -2340,18 +2434,19 @@ int HevcVideoParser::BumpPicFromDpb() {
 
     // Insert into output/display picture list
     if (pfn_display_picture_cb_) {
-        if (num_output_pics_ >= dec_buf_pool_size_) {
-            ERR("Error! Decode buffer pool overflow!");
-            return PARSER_OUT_OF_RANGE;
-        } else {
-            output_pic_list_[num_output_pics_] = dpb_buffer_.frame_buffer_list[min_poc_pic_idx].dec_buf_idx;
-            num_output_pics_++;
-        }
+        return InsertOutputPicture(dpb_buffer_.frame_buffer_list[min_poc_pic_idx].dec_buf_idx);
     }
 
     return PARSER_OK;
 }
 
+uint32_t HevcVideoParser::GetMaxNumReorderPics(HevcSeqParamSet *sps_ptr) {
+    if (parser_params_.decode_order_output) {
+        return 0;
+    }
+    return sps_ptr->sps_max_num_reorder_pics[sps_ptr->sps_max_sub_layers_minus1];
+}
+
 #if DBGINFO
 void HevcVideoParser::PrintVps(HevcVideoParamSet *vps_ptr) {
     MSG("=== hevc_video_parameter_set_t ===");
@@ -59,6 +59,14 @@ public:
      */
     virtual rocDecStatus UnInitialize();     // derived method :: nothing to do for this
 
+    /*! \brief Function to get the bytes held by the parser, including its parameter set tables and slice lists
+     */
+    size_t GetMemoryUsage() override {
+        return sizeof(*this) - sizeof(RocVideoParser) + RocVideoParser::GetMemoryUsage() +
+               slice_info_list_.capacity() * sizeof(HevcSliceInfo) + slice_param_list_.capacity() * sizeof(RocdecHevcSliceParams) +
+               slice_header_jobs_.capacity() * sizeof(HevcSliceHeaderJob);
+    }
+
 protected:
     /*! \brief Inline function to Parse the NAL Unit Header
      * 
@@ -87,6 +95,16 @@ protected:
         uint8_t ref_pic_list_1_[HEVC_MAX_NUM_REF_PICS];  // RefPicList1
     } HevcSliceInfo;
 
+    /*! \brief A slice segment header queued for parsing on the slice header workers
+     */
+    typedef struct {
+        HevcNalUnitHeader nal_unit_header;
+        ParserResult result;
+        uint32_t num_pic_total_curr;  // NumPicTotalCurr of the slice segment
+        uint32_t num_emulation_prevention_bytes;
+        uint8_t rbsp_buf[RBSP_BUF_SIZE];
+    } HevcSliceHeaderJob;
+
     /*! \brief Picture info for decoding process
      */
     typedef struct {
@@ -125,6 +143,8 @@ protected:
     HevcSliceSegHeader  slice_header_copy_;
     std::vector<HevcSliceInfo> slice_info_list_;
     std::vector<RocdecHevcSliceParams> slice_param_list_;
+    std::vector<HevcSliceHeaderJob> slice_header_jobs_;
+    int num_slice_header_jobs_;  // slice segments of the current picture queued after the parsed ones
 
     HevcNalUnitHeader   slice_nal_unit_header_;
     HevcPicInfo         curr_pic_info_;
@@ -268,6 +288,31 @@ protected:
      */
     ParserResult ParseSliceHeader(uint8_t *nalu, size_t size, HevcSliceSegHeader *p_slice_header);
 
+    /*! \brief Function to parse the slice segment header syntax. It does not change the parser state and may run on the slice
+     * header workers.
+     * \param [in] nalu A pointer of <tt>uint8_t</tt> for the input stream to be parsed
+     * \param [in] size Size of the input stream
+     * \param [in] p_nal_unit_header Pointer to the NAL unit header of the slice segment
+     * \param [in] pps_ptr Pointer to the PPS the slice segment refers to
+     * \param [in] sps_ptr Pointer to the SPS the slice segment refers to
+     * \param [out] p_slice_header Pointer to the slice header struct
+     * \param [out] p_num_pic_total_curr Pointer to NumPicTotalCurr of the slice segment
+     * \return <tt>ParserResult</tt>
+     */
+    ParserResult ParseSliceHeaderSyntax(uint8_t *nalu, size_t size, HevcNalUnitHeader *p_nal_unit_header, HevcPicParamSet *pps_ptr,
+                                        HevcSeqParamSet *sps_ptr, HevcSliceSegHeader *p_slice_header, uint32_t *p_num_pic_total_curr);
+
+    /*! \brief Function to save an independent slice segment header, or to fill a dependent one from the last saved header
+     * \param [in/out] p_slice_header Pointer to the slice header struct
+     */
+    void CompleteSliceSegHeader(HevcSliceSegHeader *p_slice_header);
+
+    /*! \brief Function to parse the queued slice segment headers of the current picture on the slice header workers and to
+     * append them to the slice info list in decoding order
+     * \return <tt>ParserResult</tt>
+     */
+    ParserResult ParseQueuedSliceHeaders();
+
     /*! \brief Function to calculate the picture order count of the current picture. Once per picutre. (8.3.1)
      */
     void CalculateCurrPoc();
@@ -315,6 +360,19 @@ protected:
      */
     int BumpPicFromDpb();
 
+    /*! \brief Function to get the number of pictures that can wait for output in DPB: sps_max_num_reorder_pics[HighestTid],
+     * or 0 when pictures are output in decode order
+     * \param [in] sps_ptr Pointer to the active SPS
+     * \return Number of pictures
+     */
+    uint32_t GetMaxNumReorderPics(HevcSeqParamSet *sps_ptr);
+
+    /*! \brief Function to find the picture with the given POC in DPB
+     * \param [in] poc The picture order count
+     * \return The DPB buffer index of the picture, or -1 if it is not in DPB
+     */
+    int FindDpbPoc(int32_t poc);
+
     /*! \brief Function to parse one picture bit stream received from the demuxer.
      * \param [in] p_stream A pointer of <tt>uint8_t</tt> for the input stream to be parsed
      * \param [in] pic_data_size Size of the input stream
@@ -0,0 +1,294 @@
+/*
+Copyright (c) 2023 - 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <algorithm>
+#include "parser_handle.h"
+
+#define DEFAULT_ASYNC_QUEUE_DEPTH 4
+
+rocDecStatus RocParserHandle::ParseVideoData(RocdecSourceDataPacket *packet) {
+    if (event_mode_) {
+        // the events would pile up without anybody to fetch them
+        return ROCDEC_INVALID_PARAMETER;
+    }
+    if (!async_mode_) {
+        std::lock_guard<std::recursive_mutex> parser_lock(parser_mutex_);
+        return ParsePacket(packet);
+    }
+    std::unique_lock<std::mutex> lock(async_mutex_);
+    async_space_cv_.wait(lock, [&] { return async_count_ < async_queue_.size(); });
+    // copy the packet: the caller is free to reuse its buffer as soon as we return
+    AsyncPacket &slot = async_queue_[(async_head_ + async_count_) % async_queue_.size()];
+    size_t payload_capacity = slot.payload.capacity();
+    if (packet->payload && packet->payload_size) {
+        slot.payload.assign(packet->payload, packet->payload + packet->payload_size);
+    } else {
+        slot.payload.clear();
+    }
+    memory_account_.Add(kMemParserQueue, static_cast<int64_t>(slot.payload.capacity()) - static_cast<int64_t>(payload_capacity));
+    slot.flags = packet->flags;
+    slot.pts = packet->pts;
+    async_count_++;
+    // report an error of a previously queued packet once
+    rocDecStatus status = async_status_;
+    async_status_ = ROCDEC_SUCCESS;
+    lock.unlock();
+    async_work_cv_.notify_one();
+    return status;
+}
+
+rocDecStatus RocParserHandle::ParseVideoDataEx(RocdecSourceDataPacket *packet, RocdecParserEvent *events, uint32_t max_events, uint32_t *num_events) {
+    if (!event_mode_) {
+        return ROCDEC_INVALID_PARAMETER;
+    }
+    std::lock_guard<std::recursive_mutex> lock(parser_mutex_);
+    rocDecStatus status = ROCDEC_SUCCESS;
+    // the events left over from the previous call are returned before the ones of this packet
+    if (packet) {
+        status = ParsePacket(packet);
+    }
+    uint32_t count = static_cast<uint32_t>(std::min<size_t>(max_events, pending_events_.size()));
+    returned_formats_.clear();
+    returned_formats_.reserve(count);
+    for (uint32_t i = 0; i < count; i++) {
+        PendingEvent &pending = pending_events_.front();
+        RocdecParserEvent &event = events[i];
+        memset(&event, 0, sizeof(event));
+        event.event_type = pending.event_type;
+        switch (pending.event_type) {
+            case rocDecParserEvent_SequenceChange:
+                returned_formats_.push_back(pending.video_format);
+                event.video_format = &returned_formats_.back();
+                break;
+            case rocDecParserEvent_DecodePicture:
+                event.pic_params = &pending.slot->pic_params;
+                break;
+            case rocDecParserEvent_DisplayPicture:
+                event.disp_info = pending.disp_info;
+                break;
+        }
+        pending_events_.pop_front();
+    }
+    *num_events = count;
+    return status;
+}
+
+rocDecStatus RocParserHandle::ParsePacket(RocdecSourceDataPacket *packet) {
+    // the caller holds parser_mutex_
+    rocDecStatus status = ROCDEC_RUNTIME_ERROR;
+    try {
+        status = roc_parser_->ParseVideoData(packet);
+    } catch (...) {
+        PacketParsed(ROCDEC_RUNTIME_ERROR);
+        throw;
+    }
+    PacketParsed(status);
+    return status;
+}
+
+void RocParserHandle::PacketParsed(rocDecStatus status) {
+    roc_parser_->PublishStats();
+    memory_account_.Set(kMemParser, roc_parser_->GetMemoryUsage());
+    if (metrics_) {
+        if (status != ROCDEC_SUCCESS) {
+            metrics_->Add(&RocdecMetricsSegment::num_errors, 1);
+        }
+        roc_parser_->PublishMetrics(metrics_.get());
+    }
+}
+
+rocDecStatus RocParserHandle::ReleasePicParams(RocdecPicParams *pic_params) {
+    std::lock_guard<std::mutex> lock(slot_mutex_);
+    for (auto &slot : pic_params_slots_) {
+        if (&slot->pic_params == pic_params) {
+            if (!slot->in_use) {
+                return ROCDEC_INVALID_PARAMETER;
+            }
+            slot->in_use = false;
+            return ROCDEC_SUCCESS;
+        }
+    }
+    return ROCDEC_INVALID_PARAMETER;
+}
+
+RocParserHandle::PicParamsSlot *RocParserHandle::AcquirePicParamsSlot() {
+    std::lock_guard<std::mutex> lock(slot_mutex_);
+    for (auto &slot : pic_params_slots_) {
+        if (!slot->in_use) {
+            slot->in_use = true;
+            return slot.get();
+        }
+    }
+    // every slot is held by the application: the pool grows, a slot is never moved once handed out
+    pic_params_slots_.push_back(std::make_unique<PicParamsSlot>());
+    memory_account_.Add(kMemParserQueue, sizeof(PicParamsSlot));
+    PicParamsSlot *slot = pic_params_slots_.back().get();
+    slot->in_use = true;
+    return slot;
+}
+
+int ROCDECAPI RocParserHandle::EventSequenceCallback(void *user_data, RocdecVideoFormat *video_format) {
+    auto handle = static_cast<RocParserHandle *>(user_data);
+    PendingEvent event = {};
+    event.event_type = rocDecParserEvent_SequenceChange;
+    event.video_format = *video_format;
+    handle->pending_events_.push_back(event);
+    return 1;
+}
+
+int ROCDECAPI RocParserHandle::EventDecodeCallback(void *user_data, RocdecPicParams *pic_params) {
+    auto handle = static_cast<RocParserHandle *>(user_data);
+    PicParamsSlot *slot = handle->AcquirePicParamsSlot();
+    size_t slot_capacity = slot->bitstream.capacity() + slot->slice_params.capacity();
+    slot->pic_params = *pic_params;
+    if (pic_params->bitstream_data && pic_params->bitstream_data_len) {
+        slot->bitstream.assign(pic_params->bitstream_data, pic_params->bitstream_data + pic_params->bitstream_data_len);
+        slot->pic_params.bitstream_data = slot->bitstream.data();
+    }
+    // all slice_params members of the union alias the same pointer
+    size_t slice_params_size = GetSliceParamsSize(handle->codec_type_) * pic_params->num_slices;
+    if (pic_params->slice_params.avc && slice_params_size) {
+        const uint8_t *src = reinterpret_cast<const uint8_t *>(pic_params->slice_params.avc);
+        slot->slice_params.assign(src, src + slice_params_size);
+        slot->pic_params.slice_params.avc = reinterpret_cast<RocdecAvcSliceParams *>(slot->slice_params.data());
+    }
+    handle->memory_account_.Add(kMemParserQueue, static_cast<int64_t>(slot->bitstream.capacity() + slot->slice_params.capacity()) -
+                                static_cast<int64_t>(slot_capacity));
+    PendingEvent event = {};
+    event.event_type = rocDecParserEvent_DecodePicture;
+    event.slot = slot;
+    handle->pending_events_.push_back(event);
+    return 1;
+}
+
+int ROCDECAPI RocParserHandle::EventDisplayCallback(void *user_data, RocdecParserDispInfo *disp_info) {
+    auto handle = static_cast<RocParserHandle *>(user_data);
+    PendingEvent event = {};
+    event.event_type = rocDecParserEvent_DisplayPicture;
+    event.disp_info = *disp_info;
+    handle->pending_events_.push_back(event);
+    return 1;
+}
+
+int ROCDECAPI RocParserHandle::EventSeiCallback(void *user_data, RocdecSeiMessageInfo *sei_message_info) {
+    // SEI messages are not events: they are passed on to the application callback as they are parsed
+    auto handle = static_cast<RocParserHandle *>(user_data);
+    return handle->pfn_sei_msg_cb_(handle->user_data_, sei_message_info);
+}
+
+rocDecStatus RocParserHandle::MarkFrameForReuse(int pic_idx) {
+    // not serialized with the parse: a surface release must not wait for the worker to finish a packet
+    return roc_parser_->MarkFrameForReuse(pic_idx);
+}
+
+rocDecStatus RocParserHandle::GetStats(RocdecParserStats *parser_stats) {
+    // the snapshot published at the end of each packet: no need to wait for a parse and its callbacks
+    roc_parser_->GetStats(parser_stats);
+    return ROCDEC_SUCCESS;
+}
+
+rocDecStatus RocParserHandle::GetMemoryUsage(RocdecMemoryUsage *memory_usage) {
+    // the account is atomic: no need to wait for the parser
+    memory_account_.GetUsage(memory_usage);
+    return ROCDEC_SUCCESS;
+}
+
+rocDecStatus RocParserHandle::Flush() {
+    if (!async_mode_) {
+        return ROCDEC_SUCCESS;
+    }
+    if (std::this_thread::get_id() == async_thread_.get_id()) {
+        // called from a parser callback: the worker would wait for itself
+        return ROCDEC_INVALID_PARAMETER;
+    }
+    std::unique_lock<std::mutex> lock(async_mutex_);
+    async_space_cv_.wait(lock, [&] { return async_count_ == 0; });
+    rocDecStatus status = async_status_;
+    async_status_ = ROCDEC_SUCCESS;
+    return status;
+}
+
+void RocParserHandle::StartAsyncWorker(uint32_t queue_depth) {
+    async_queue_.resize(queue_depth ? queue_depth : DEFAULT_ASYNC_QUEUE_DEPTH);
+    async_head_ = async_count_ = 0;
+    async_stop_ = false;
+    async_status_ = ROCDEC_SUCCESS;
+    async_mode_ = true;
+    async_thread_ = std::thread(&RocParserHandle::AsyncWorker, this);
+}
+
+void RocParserHandle::StopAsyncWorker() {
+    if (!async_mode_) {
+        return;
+    }
+    // the queued packets are still parsed: their callbacks may hand out pictures the application waits for
+    {
+        std::lock_guard<std::mutex> lock(async_mutex_);
+        async_stop_ = true;
+    }
+    async_work_cv_.notify_one();
+    if (async_thread_.joinable()) {
+        async_thread_.join();
+    }
+    async_mode_ = false;
+}
+
+void RocParserHandle::AsyncWorker() {
+    while (true) {
+        AsyncPacket *slot;
+        {
+            std::unique_lock<std::mutex> lock(async_mutex_);
+            async_work_cv_.wait(lock, [&] { return async_count_ > 0 || async_stop_; });
+            if (async_count_ == 0) {
+                break;
+            }
+            // the slot stays owned by the worker until async_count_ is decremented
+            slot = &async_queue_[async_head_];
+        }
+
+        RocdecSourceDataPacket packet = {};
+        packet.flags = slot->flags;
+        packet.payload_size = static_cast<uint32_t>(slot->payload.size());
+        packet.payload = slot->payload.empty() ? nullptr : slot->payload.data();
+        packet.pts = slot->pts;
+        rocDecStatus status;
+        try {
+            std::lock_guard<std::recursive_mutex> parser_lock(parser_mutex_);
+            status = ParsePacket(&packet);
+        }
+        catch(const std::exception& e) {
+            ERR(e.what())
+            CaptureError(e.what());
+            status = ROCDEC_RUNTIME_ERROR;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(async_mutex_);
+            if (status != ROCDEC_SUCCESS && async_status_ == ROCDEC_SUCCESS) {
+                async_status_ = status;
+            }
+            async_head_ = (async_head_ + 1) % async_queue_.size();
+            async_count_--;
+        }
+        async_space_cv_.notify_all();
+    }
+}
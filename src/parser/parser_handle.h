@@ -23,27 +23,117 @@ THE SOFTWARE.
 
 #include <memory>
 #include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
 #include "rocparser.h"
 #include "roc_video_parser.h"
 #include "avc_parser.h"
 #include "av1_parser.h"
 #include "hevc_parser.h"
 #include "vp9_parser.h"
+#include "../metrics/roc_memory_account.h"
+#include "../rocdecode/roc_slice_params.h"
 
 class RocParserHandle {
 public:
-    explicit RocParserHandle(RocdecParserParams *params) { CreateParser(params); };
-    ~RocParserHandle() { ClearErrors(); }
-    bool NoError() { return error_.empty(); }
-    const char* ErrorMsg() { return error_.c_str(); }
-    void CaptureError(const std::string& err_msg) { error_ = err_msg; }
-    rocDecStatus ParseVideoData(RocdecSourceDataPacket *packet) { return roc_parser_->ParseVideoData(packet); }
-    rocDecStatus MarkFrameForReuse(int pic_idx) { return roc_parser_->MarkFrameForReuse(pic_idx); }
-    rocDecStatus DestroyParser() { return DestroyParserInternal(); };
+    explicit RocParserHandle(RocdecParserParams *params) {
+        if (!params->pfn_sequence_callback && !params->pfn_decode_picture && !params->pfn_display_picture) {
+            if (params->async_mode) {
+                THROW("async_mode requires the parser callbacks to be set");
+            }
+            // event mode: route the callbacks to the handle, which queues them as events for ParseVideoDataEx
+            RocdecParserParams event_params = *params;
+            event_params.user_data = this;
+            event_params.pfn_sequence_callback = EventSequenceCallback;
+            event_params.pfn_decode_picture = EventDecodeCallback;
+            event_params.pfn_display_picture = EventDisplayCallback;
+            event_params.pfn_get_sei_msg = params->pfn_get_sei_msg ? EventSeiCallback : nullptr;
+            event_mode_ = true;
+            codec_type_ = params->codec_type;
+            user_data_ = params->user_data;
+            pfn_sei_msg_cb_ = params->pfn_get_sei_msg;
+            CreateParser(&event_params);
+        } else {
+            CreateParser(params);
+        }
+        metrics_ = RocDecMetricsPublisher::Create(rocDecMetricsSession_Parser, -1, params->codec_type);
+        memory_account_.Set(kMemParser, roc_parser_->GetMemoryUsage());
+        if (params->async_mode) {
+            StartAsyncWorker(params->async_queue_depth);
+        }
+    };
+    ~RocParserHandle() { StopAsyncWorker(); ClearErrors(); }
+    // the async worker captures errors too, so error_ is guarded by async_mutex_
+    bool NoError() { std::lock_guard<std::mutex> lock(async_mutex_); return error_.empty(); }
+    std::string ErrorMsg() { std::lock_guard<std::mutex> lock(async_mutex_); return error_; }
+    void CaptureError(const std::string& err_msg) { std::lock_guard<std::mutex> lock(async_mutex_); error_ = err_msg; }
+    rocDecStatus ParseVideoData(RocdecSourceDataPacket *packet);
+    rocDecStatus ParseVideoDataEx(RocdecSourceDataPacket *packet, RocdecParserEvent *events, uint32_t max_events, uint32_t *num_events);
+    rocDecStatus ReleasePicParams(RocdecPicParams *pic_params);
+    rocDecStatus MarkFrameForReuse(int pic_idx);
+    rocDecStatus Flush();
+    rocDecStatus GetStats(RocdecParserStats *parser_stats);
+    rocDecStatus GetMemoryUsage(RocdecMemoryUsage *memory_usage);
+    rocDecStatus DestroyParser() { StopAsyncWorker(); return DestroyParserInternal(); };
 
 private:
+    // A queued copy of a RocdecSourceDataPacket. Slots are reused so that the payload buffers keep their capacity.
+    struct AsyncPacket {
+        std::vector<uint8_t> payload;
+        uint32_t flags;
+        RocdecTimeStamp pts;
+    };
+    // A private copy of the picture parameters of a rocDecParserEvent_DecodePicture event. The slice parameters and the
+    // bitstream data point into parser buffers that are overwritten by the next picture, so the slot keeps its own copies.
+    struct PicParamsSlot {
+        RocdecPicParams pic_params;
+        std::vector<uint8_t> bitstream;
+        std::vector<uint8_t> slice_params;
+        bool in_use;
+    };
+    // An event waiting to be returned by ParseVideoDataEx; only the member matching event_type is valid
+    struct PendingEvent {
+        rocDecParserEventType event_type;
+        RocdecVideoFormat video_format;
+        PicParamsSlot *slot;
+        RocdecParserDispInfo disp_info;
+    };
+    static int ROCDECAPI EventSequenceCallback(void *user_data, RocdecVideoFormat *video_format);
+    static int ROCDECAPI EventDecodeCallback(void *user_data, RocdecPicParams *pic_params);
+    static int ROCDECAPI EventDisplayCallback(void *user_data, RocdecParserDispInfo *disp_info);
+    static int ROCDECAPI EventSeiCallback(void *user_data, RocdecSeiMessageInfo *sei_message_info);
+    PicParamsSlot *AcquirePicParamsSlot();
+    rocDecStatus ParsePacket(RocdecSourceDataPacket *packet);
+    void PacketParsed(rocDecStatus status);
     std::shared_ptr<RocVideoParser> roc_parser_ = nullptr;
-    void ClearErrors() { error_ = ""; }
+    void ClearErrors() { std::lock_guard<std::mutex> lock(async_mutex_); error_ = ""; }
+    void StartAsyncWorker(uint32_t queue_depth);
+    void StopAsyncWorker();
+    void AsyncWorker();
+    bool async_mode_ = false;
+    std::thread async_thread_;
+    std::mutex async_mutex_;                  // guards the queue, async_status_ and error_
+    std::condition_variable async_work_cv_;   // signalled when a packet is queued or the worker has to stop
+    std::condition_variable async_space_cv_;  // signalled when a queued packet has been parsed
+    std::vector<AsyncPacket> async_queue_;    // ring of packet slots, async_queue_depth entries
+    size_t async_head_ = 0;
+    size_t async_count_ = 0;
+    bool async_stop_ = false;
+    rocDecStatus async_status_ = ROCDEC_SUCCESS;  // first error of the worker since the last flush
+    std::unique_ptr<RocDecMetricsPublisher> metrics_;  // shared-memory metrics of the parser, null unless ROCDECODE_METRICS_SHM=1
+    RocDecMemoryAccount memory_account_;  // kMemParser is updated after every packet, kMemParserQueue as the queue slots grow
+    std::recursive_mutex parser_mutex_;  // serializes the parser between the worker and the API thread (callbacks may re-enter)
+    bool event_mode_ = false;
+    rocDecVideoCodec codec_type_ = rocDecVideoCodec_NumCodecs;
+    void *user_data_ = nullptr;
+    PFNVIDSEIMSGCALLBACK pfn_sei_msg_cb_ = nullptr;
+    std::deque<PendingEvent> pending_events_;             // events not yet returned by ParseVideoDataEx
+    std::vector<RocdecVideoFormat> returned_formats_;     // storage for the video_format of the events returned last
+    std::mutex slot_mutex_;                               // pic params slots may be released from any thread
+    std::vector<std::unique_ptr<PicParamsSlot>> pic_params_slots_;
     void CreateParser(RocdecParserParams *params) {
         switch(params->codec_type) {
             case rocDecVideoCodec_AVC:
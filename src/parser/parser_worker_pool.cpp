@@ -0,0 +1,97 @@
+/*
+Copyright (c) 2023 - 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#include "parser_worker_pool.h"
+
+ParserWorkerPool::ParserWorkerPool(int num_threads) {
+    for (int i = 0; i < num_threads; i++) {
+        threads_.emplace_back(&ParserWorkerPool::Worker, this);
+    }
+}
+
+ParserWorkerPool::~ParserWorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto &thread : threads_) {
+        thread.join();
+    }
+}
+
+void ParserWorkerPool::Run(int num_jobs, const std::function<void(int)> &job) {
+    if (num_jobs <= 0) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job_ = &job;
+        num_jobs_ = num_jobs;
+        num_jobs_done_ = 0;
+        next_job_.store(0, std::memory_order_relaxed);
+        step_++;
+    }
+    work_cv_.notify_all();
+    int num_done = RunJobs(job, num_jobs);
+    std::unique_lock<std::mutex> lock(mutex_);
+    num_jobs_done_ += num_done;
+    done_cv_.wait(lock, [&] { return num_jobs_done_ == num_jobs_ && num_active_workers_ == 0; });
+    job_ = nullptr;
+}
+
+void ParserWorkerPool::Worker() {
+    uint64_t last_step = 0;
+    while (true) {
+        const std::function<void(int)> *job;
+        int num_jobs;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            work_cv_.wait(lock, [&] { return stop_ || (step_ != last_step && job_ != nullptr); });
+            if (stop_) {
+                break;
+            }
+            last_step = step_;
+            job = job_;
+            num_jobs = num_jobs_;
+            num_active_workers_++;
+        }
+        int num_done = RunJobs(*job, num_jobs);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            num_jobs_done_ += num_done;
+            num_active_workers_--;
+        }
+        done_cv_.notify_one();
+    }
+}
+
+int ParserWorkerPool::RunJobs(const std::function<void(int)> &job, int num_jobs) {
+    int num_done = 0;
+    int i;
+    while ((i = next_job_.fetch_add(1, std::memory_order_relaxed)) < num_jobs) {
+        job(i);
+        num_done++;
+    }
+    return num_done;
+}
@@ -0,0 +1,73 @@
+/*
+Copyright (c) 2023 - 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*! \brief A small pool of threads that runs the independent jobs of one parsing step, e.g. the slice headers of a picture.
+ *
+ * Run() hands out the jobs by index to the workers and to the calling thread, and returns when all of them are done, so
+ * the jobs may use the state of the caller that does not change during the step. Only one Run() is in flight at a time.
+ */
+class ParserWorkerPool {
+public:
+    /*! \brief Starts num_threads worker threads
+     */
+    explicit ParserWorkerPool(int num_threads);
+    ~ParserWorkerPool();
+    ParserWorkerPool(const ParserWorkerPool&) = delete;
+    ParserWorkerPool& operator=(const ParserWorkerPool&) = delete;
+
+    /*! \brief Function to run job(0) ... job(num_jobs - 1) on the workers and the calling thread
+     * \param [in] num_jobs Number of jobs
+     * \param [in] job Function called once per job index, possibly concurrently with other indices
+     */
+    void Run(int num_jobs, const std::function<void(int)> &job);
+
+private:
+    void Worker();
+    /*! \brief Function to run jobs of the current step until none is left
+     * \return Number of jobs run
+     */
+    int RunJobs(const std::function<void(int)> &job, int num_jobs);
+
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    std::condition_variable work_cv_;  // signalled when a step starts or the workers have to stop
+    std::condition_variable done_cv_;  // signalled when a worker leaves a step
+    // The step in flight, guarded by mutex_. A worker joins a step only while job_ is set, and Run() returns only once the
+    // jobs are done and no worker is in the step any more, so no worker sees the jobs of a finished step.
+    const std::function<void(int)> *job_ = nullptr;
+    int num_jobs_ = 0;
+    int num_jobs_done_ = 0;
+    int num_active_workers_ = 0;
+    uint64_t step_ = 0;         // incremented by every Run() so that a worker joins each step once
+    bool stop_ = false;
+    std::atomic<int> next_job_{0};
+};
@@ -20,13 +20,27 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 */
 
+#include <algorithm>
+#include <cstdlib>
 #include "roc_video_parser.h"
 
+#define SLICE_HEADER_THREADS_ENV "ROCDECODE_SLICE_HEADER_THREADS"
+#define DEFAULT_SLICE_HEADER_THREADS 0
+
+static int GetNumSliceHeaderThreads() {
+    static const int num_threads = [] {
+        char *slice_header_threads = std::getenv(SLICE_HEADER_THREADS_ENV);
+        return slice_header_threads ? std::max(std::atoi(slice_header_threads), 0) : DEFAULT_SLICE_HEADER_THREADS;
+    }();
+    return num_threads;
+}
+
 RocVideoParser::RocVideoParser() {
     pic_count_ = 0;
     pic_width_ = 0;
     pic_height_ = 0;
     new_seq_activated_ = false;
+    pending_dec_buf_pool_size_ = 0;
     frame_rate_.numerator = 0;
     frame_rate_.denominator = 0;
     curr_pts_ = 0;
@@ -36,6 +50,7 @@ RocVideoParser::RocVideoParser() {
     sei_payload_buf_ = nullptr;
     sei_payload_buf_size_ = 0;
     sei_message_list_.assign(INIT_SEI_MESSAGE_COUNT, {0});
+    num_slice_header_threads_ = GetNumSliceHeaderThreads();
 }
 
 RocVideoParser::~RocVideoParser() {
@@ -64,6 +79,11 @@ rocDecStatus RocVideoParser::Initialize(RocdecParserParams *pParams) {
     pfn_get_sei_message_cb_ = pParams->pfn_get_sei_msg;           /**< Called when all SEI messages are parsed for particular frame        */
 
     parser_params_ = *pParams;
+    // With the automatic display delay the output is only held back by the DPB of each codec, for as long as the reordering
+    // of the sequence requires. In decode order nothing holds it back.
+    if (parser_params_.auto_display_delay || parser_params_.decode_order_output) {
+        parser_params_.max_display_delay = 0;
+    }
 
     dec_buf_pool_size_ = parser_params_.max_num_decode_surfaces;
     decode_buffer_pool_.resize(dec_buf_pool_size_, {0});
@@ -82,7 +102,8 @@ rocDecStatus RocVideoParser::MarkFrameForReuse(int pic_idx) {
 }
 
 void RocVideoParser::InitDecBufPool() {
-    for (int i = 0; i < dec_buf_pool_size_; i++) {
+    // a tight pool that shrank keeps its larger arrays, which stale DPB entries may still index
+    for (size_t i = 0; i < decode_buffer_pool_.size(); i++) {
         decode_buffer_pool_[i].use_status = kNotUsed;
         decode_buffer_pool_[i].pic_order_cnt = 0;
         output_pic_list_[i] = 0xFF;
@@ -90,7 +111,24 @@ void RocVideoParser::InitDecBufPool() {
     num_output_pics_ = 0;
 }
 
-void RocVideoParser::CheckAndAdjustDecBufPoolSize(int dpb_size) {
+void RocVideoParser::CheckAndAdjustDecBufPoolSize(int dpb_size, int min_pool_size) {
+    if (parser_params_.tight_surface_pool) {
+        // The pictures of the previous sequence keep their buffers until they are flushed, so the pool is neither reset here nor
+        // shrunk before those buffers are free
+        uint32_t tight_pool_size = min_pool_size + parser_params_.max_display_delay;
+        pending_dec_buf_pool_size_ = 0;
+        if (tight_pool_size > dec_buf_pool_size_) {
+            dec_buf_pool_size_ = tight_pool_size;
+            if (decode_buffer_pool_.size() < dec_buf_pool_size_) {
+                decode_buffer_pool_.resize(dec_buf_pool_size_, {0});
+                output_pic_list_.resize(dec_buf_pool_size_, 0xFF);
+            }
+        } else if (tight_pool_size < dec_buf_pool_size_) {
+            pending_dec_buf_pool_size_ = tight_pool_size;
+            ShrinkDecBufPool();
+        }
+        return;
+    }
     int min_dec_buf_pool_size = dpb_size + (parser_params_.max_display_delay > DECODE_BUF_POOL_EXTENSION ? parser_params_.max_display_delay : DECODE_BUF_POOL_EXTENSION);
     if ( dec_buf_pool_size_ < min_dec_buf_pool_size) {
         dec_buf_pool_size_ = min_dec_buf_pool_size;
@@ -100,6 +138,78 @@ void RocVideoParser::CheckAndAdjustDecBufPoolSize(int dpb_size) {
     }
 }
 
+void RocVideoParser::GetStats(RocdecParserStats *stats) {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    *stats = published_stats_;
+}
+
+void RocVideoParser::PublishStats() {
+    RocdecParserStats stats = stats_;
+    uint64_t callback_time_ns = stats_.sequence_callback_time_ns + stats_.decode_callback_time_ns + stats_.display_callback_time_ns + stats_.sei_callback_time_ns;
+    stats.parse_time_ns = parse_total_time_ns_ > callback_time_ns ? parse_total_time_ns_ - callback_time_ns : 0;
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    published_stats_ = stats;
+}
+
+void RocVideoParser::PublishMetrics(RocDecMetricsPublisher *metrics) {
+    uint32_t num_used = 0;
+    for (uint32_t i = 0; i < dec_buf_pool_size_; i++) {
+        num_used += decode_buffer_pool_[i].use_status != kNotUsed;
+    }
+    metrics->Store(&RocdecMetricsSegment::width, pic_width_);
+    metrics->Store(&RocdecMetricsSegment::height, pic_height_);
+    metrics->Store(&RocdecMetricsSegment::num_surfaces, dec_buf_pool_size_);
+    metrics->Store(&RocdecMetricsSegment::surfaces_in_use, num_used);
+    metrics->Store(&RocdecMetricsSegment::num_frames, stats_.num_pics_parsed);
+    metrics->Store(&RocdecMetricsSegment::num_frames_output, stats_.num_pics_displayed);
+    metrics->Store(&RocdecMetricsSegment::num_bytes, stats_.num_bytes);
+    metrics->Store(&RocdecMetricsSegment::num_reconfigurations, stats_.num_sequence_changes);
+    metrics->UpdateFrameRate();
+}
+
+size_t RocVideoParser::GetMemoryUsage() {
+    return sizeof(RocVideoParser) + sei_rbsp_buf_size_ + sei_payload_buf_size_ + sei_message_list_.capacity() * sizeof(RocdecSeiMessage) +
+           decode_buffer_pool_.capacity() * sizeof(DecodeFrameBuffer) + output_pic_list_.capacity() * sizeof(uint32_t) +
+           dpb_engine_.GetMemoryUsage();
+}
+
+void RocVideoParser::ShrinkDecBufPool() {
+    if (pending_dec_buf_pool_size_ == 0) {
+        return;
+    }
+    for (uint32_t i = pending_dec_buf_pool_size_; i < dec_buf_pool_size_; i++) {
+        if (decode_buffer_pool_[i].use_status != kNotUsed) {
+            return;
+        }
+    }
+    dec_buf_pool_size_ = pending_dec_buf_pool_size_;
+    pending_dec_buf_pool_size_ = 0;
+}
+
+int RocVideoParser::FindFreeDecodeBuffer() {
+    ShrinkDecBufPool();
+    int dec_buf_idx = DpbEngine::FindFreeSlot(dec_buf_pool_size_, [&](int i) { return decode_buffer_pool_[i].use_status == kNotUsed; });
+    if (dec_buf_idx >= 0) {
+        // the buffer found is about to be used by a new picture
+        uint32_t num_used = 1;
+        for (int i = 0; i < dec_buf_pool_size_; i++) {
+            num_used += decode_buffer_pool_[i].use_status != kNotUsed;
+        }
+        stats_.dpb_high_water_mark = std::max(stats_.dpb_high_water_mark, num_used);
+    }
+    return dec_buf_idx;
+}
+
+ParserResult RocVideoParser::InsertOutputPicture(int dec_buf_idx) {
+    if (num_output_pics_ >= dec_buf_pool_size_) {
+        ERR("Error! Decode buffer pool overflow!");
+        return PARSER_OUT_OF_RANGE;
+    }
+    output_pic_list_[num_output_pics_] = dec_buf_idx;
+    num_output_pics_++;
+    return PARSER_OK;
+}
+
 ParserResult RocVideoParser::OutputDecodedPictures(bool no_delay) {
     RocdecParserDispInfo disp_info = {0};
     disp_info.progressive_frame = 1; // not used
@@ -111,7 +221,12 @@ ParserResult RocVideoParser::OutputDecodedPictures(bool no_delay) {
         for (int i = 0; i < num_disp; i++) {
             disp_info.picture_index = output_pic_list_[i];
             disp_info.pts = decode_buffer_pool_[output_pic_list_[i]].pts;
-            pfn_display_picture_cb_(parser_params_.user_data, &disp_info);
+            {
+                ROCDEC_TRACE_SCOPE("RocVideoParser::DisplayPicture", disp_info.picture_index);
+                ParserStatsTimer callback_timer(stats_.display_callback_time_ns);
+                pfn_display_picture_cb_(parser_params_.user_data, &disp_info);
+            }
+            stats_.num_pics_displayed++;
             decode_buffer_pool_[output_pic_list_[i]].use_status &= ~kFrameUsedForDisplay;
         }
         num_output_pics_ = disp_delay;
@@ -125,6 +240,28 @@ ParserResult RocVideoParser::OutputDecodedPictures(bool no_delay) {
     return PARSER_OK;
 }
 
+int RocVideoParser::CallSequenceCallback() {
+    ParserStatsTimer callback_timer(stats_.sequence_callback_time_ns);
+    stats_.num_sequence_changes++;
+    return pfn_sequece_cb_(parser_params_.user_data, &video_format_params_);
+}
+
+int RocVideoParser::CallDecodePictureCallback() {
+    ParserStatsTimer callback_timer(stats_.decode_callback_time_ns);
+    int ret = pfn_decode_picture_cb_(parser_params_.user_data, &dec_pic_params_);
+    if (ret != 0) {
+        stats_.num_pics_submitted++;
+    }
+    return ret;
+}
+
+void RocVideoParser::CallSeiMessageCallback() {
+    if (pfn_get_sei_message_cb_) {
+        ParserStatsTimer callback_timer(stats_.sei_callback_time_ns);
+        pfn_get_sei_message_cb_(parser_params_.user_data, &sei_message_info_params_);
+    }
+}
+
 ParserResult RocVideoParser::GetNalUnit() {
     bool start_code_found = false;
 
@@ -167,7 +304,15 @@ ParserResult RocVideoParser::GetNalUnit() {
 }
 
 size_t RocVideoParser::EbspToRbsp(uint8_t *streamBuffer,size_t begin_bytepos, size_t end_bytepos) {
+    uint32_t num_removed_bytes;
+    size_t rbsp_size = ConvertEbspToRbsp(streamBuffer, begin_bytepos, end_bytepos, &num_removed_bytes);
+    stats_.num_emulation_prevention_bytes += num_removed_bytes;
+    return rbsp_size;
+}
+
+size_t RocVideoParser::ConvertEbspToRbsp(uint8_t *streamBuffer,size_t begin_bytepos, size_t end_bytepos, uint32_t *num_removed_bytes) {
     int count = 0;
+    *num_removed_bytes = 0;
     if (end_bytepos < begin_bytepos) {
         return end_bytepos;
     }
@@ -203,9 +348,23 @@ size_t RocVideoParser::EbspToRbsp(uint8_t *streamBuffer,size_t begin_bytepos, si
         }
         streamBuffer_i++;
     }
+    *num_removed_bytes = reduce_count;
     return end_bytepos - begin_bytepos + reduce_count;
 }
 
+void RocVideoParser::RunSliceHeaderJobs(int num_jobs, const std::function<void(int)> &job) {
+    if (num_slice_header_threads_ > 0 && num_jobs + 1 >= PARALLEL_SLICE_HEADER_MIN_SLICES) {
+        if (!slice_header_pool_) {
+            slice_header_pool_ = std::make_unique<ParserWorkerPool>(num_slice_header_threads_);
+        }
+        slice_header_pool_->Run(num_jobs, job);
+    } else {
+        for (int i = 0; i < num_jobs; i++) {
+            job(i);
+        }
+    }
+}
+
 void RocVideoParser::ParseSeiMessage(uint8_t *nalu, size_t size) {
     int offset = 0; // byte offset
     int payload_type;
@@ -252,6 +411,7 @@ void RocVideoParser::ParseSeiMessage(uint8_t *nalu, size_t size) {
 
         sei_payload_size_ += payload_size;
         sei_message_count_++;
+        stats_.num_sei_bytes += payload_size;
 
         offset += payload_size;
     } while (offset < size && nalu[offset] != 0x80);
@@ -21,11 +21,20 @@ THE SOFTWARE.
 */
 #pragma once
 
+#include <chrono>
+#include <cstring>
+#include <cmath>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 #include "rocparser.h"
+#include "dpb_engine.h"
+#include "parser_worker_pool.h"
 #include "../commons.h"
+#include "../metrics/roc_metrics_publisher.h"
+#include "../tracer/roc_pipeline_tracer.h"
 
 typedef enum ParserResult {
     PARSER_OK                                   = 0,
@@ -79,6 +88,7 @@ typedef struct {
 #define INIT_SEI_MESSAGE_COUNT 16  // initial SEI message count
 #define INIT_SEI_PAYLOAD_BUF_SIZE 1024 * 1024  // initial SEI payload buffer size, 1 MB
 #define DECODE_BUF_POOL_EXTENSION 2
+#define PARALLEL_SLICE_HEADER_MIN_SLICES 8  // fewest slice headers of a picture that are parsed on the worker pool
 
 #define CHECK_ALLOWED_RANGE(val, min, max) { \
     if (val < min || val > max) { \
@@ -103,6 +113,20 @@ enum {
     kFrameUsedForDisplay = 1 << 2
 } FrameBufUseStatus;
 
+/**
+ * @brief Adds the time spent in the enclosing scope to a parser statistics counter
+ */
+class ParserStatsTimer {
+public:
+    explicit ParserStatsTimer(uint64_t &time_ns) : time_ns_(time_ns), start_time_(std::chrono::steady_clock::now()) {}
+    ~ParserStatsTimer() {
+        time_ns_ += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_time_).count();
+    }
+private:
+    uint64_t &time_ns_;
+    std::chrono::steady_clock::time_point start_time_;
+};
+
 /**
  * @brief Base class for video parsing
  * 
@@ -119,12 +143,30 @@ public:
     virtual rocDecStatus UnInitialize() = 0;     // pure virtual: implemented by derived class
     /**
      * @brief function to to release surface with pic_idx and mark it for reuse, can be called from a different thread than decode thread
-     * @brief calling thread is responsible for syncronizing
+     * @brief it runs concurrently with ParseVideoData, so it may only touch state that is atomic or guarded by its own lock
      * \param [in] pic_idx surface index for the picture to be released
      * 
      * @return rocDecStatus 
      */
     virtual rocDecStatus MarkFrameForReuse(int pic_idx);
+    /**
+     * @brief function to get the parser statistics as of the last PublishStats call; it runs concurrently with ParseVideoData
+     * \param [out] stats Parser statistics
+     */
+    void GetStats(RocdecParserStats *stats);
+    /**
+     * @brief function to publish the cumulative parser statistics to GetStats, called at packet boundaries; the caller serializes it with ParseVideoData
+     */
+    void PublishStats();
+    /**
+     * @brief function to publish the parser counters and the decode buffer pool usage to a metrics segment; the caller serializes it with ParseVideoData
+     * \param [in] metrics Metrics segment of the parser session
+     */
+    void PublishMetrics(RocDecMetricsPublisher *metrics);
+    /**
+     * @brief function to get the bytes held by the parser: the parser object and its run-time allocated buffers; the caller serializes it with ParseVideoData
+     */
+    virtual size_t GetMemoryUsage();
 
 protected:
     RocdecParserParams parser_params_ = {};
@@ -149,13 +191,16 @@ protected:
     } DecodeFrameBuffer;
     uint32_t dec_buf_pool_size_;        /* Number of decoded frame surfaces in the pool which are recycled. The size should be greater
                                            than or equal to DPB size (normally greater to guarantee smooth operations). The value is
-                                           set to max_num_decode_surfaces from the decoder but parser checks and increases if needed. */
+                                           set to max_num_decode_surfaces from the decoder but parser checks and increases if needed.
+                                           With tight_surface_pool it is the minimum of the sequence plus the display delay. */
+    uint32_t pending_dec_buf_pool_size_;    /* Smaller tight pool size to switch to once the buffers above it are free, or 0 */
     /* This array maps to VA surface array allocated at VA-API layer. A frame in the pool is identified by its index in the array, which
      * is used to retrieve the VA surface Id.
      */
     std::vector<DecodeFrameBuffer> decode_buffer_pool_;
     uint32_t num_output_pics_;  // number of pictures that are ready to be ouput
     std::vector<uint32_t> output_pic_list_; // sorted output frame index to decode_buffer_pool_
+    DpbEngine dpb_engine_;  // output order heap and picture index maps shared by the codec DPBs
 
     RocdecTimeStamp curr_pts_;
     Rational frame_rate_;
@@ -190,10 +235,66 @@ protected:
     uint32_t            sei_payload_buf_size_;
     uint32_t            sei_payload_size_;  // total SEI payload size of the current frame
 
+    int                 num_slice_header_threads_;  // worker threads for the slice headers of a picture, 0 to parse them in NAL unit order
+    std::unique_ptr<ParserWorkerPool> slice_header_pool_;  // started with the first picture that has enough slices
+
+    RocdecParserStats   stats_ = {};  // updated by the parse; parse_time_ns is derived from parse_total_time_ns_ in PublishStats()
+    uint64_t            parse_total_time_ns_ = 0;  // time spent in ParseVideoData, including the callbacks
+    std::mutex          stats_mutex_;  // guards published_stats_ only, never held during the parse
+    RocdecParserStats   published_stats_ = {};  // snapshot of stats_ at the end of the last packet
+
+    /*! \brief Function to count a packet passed to ParseVideoData in the parser statistics
+     */
+    void CountPacket(const RocdecSourceDataPacket *p_data) {
+        stats_.num_packets++;
+        stats_.num_bytes += p_data->payload ? p_data->payload_size : 0;
+    }
+
+    /*! \brief Function to count a parsed NAL unit or OBU in the parser statistics
+     * \param [in] unit_type nal_unit_type or obu_type, or -1 if the unit has no type
+     */
+    void CountUnit(int unit_type) {
+        stats_.num_units++;
+        if (unit_type >= 0 && static_cast<size_t>(unit_type) < sizeof(stats_.num_units_by_type) / sizeof(stats_.num_units_by_type[0])) {
+            stats_.num_units_by_type[unit_type]++;
+        }
+    }
+
+    /*! \brief Function to call pfn_sequence_callback with video_format_params_, timed and counted in the parser statistics
+     * \return The return value of the callback
+     */
+    int CallSequenceCallback();
+
+    /*! \brief Function to call pfn_decode_picture with dec_pic_params_, timed and counted in the parser statistics
+     * \return The return value of the callback
+     */
+    int CallDecodePictureCallback();
+
+    /*! \brief Function to call pfn_get_sei_msg (if set) with sei_message_info_params_, timed in the parser statistics
+     */
+    void CallSeiMessageCallback();
+
     /*! \brief Function to check the initially set (by decoder) decode buffer pool size and adjust if needed
      *  \param dpb_size The DPB buffer size of the current sequence
+     *  \param min_pool_size The fewest buffers the current sequence can be decoded with at a display delay of 0: the pool size
+     *  with tight_surface_pool, which adds max_display_delay and may shrink the pool
+     */
+    void CheckAndAdjustDecBufPoolSize(int dpb_size, int min_pool_size);
+
+    /*! \brief Function to find a free surface in the decode buffer pool
+     * \return The index of the first unused buffer in decode_buffer_pool_, or -1 if all buffers are in use
      */
-    void CheckAndAdjustDecBufPoolSize(int dpb_size);
+    int FindFreeDecodeBuffer();
+
+    /*! \brief Function to apply a pending shrink of a tight decode buffer pool once no buffer beyond the new size is in use
+     */
+    void ShrinkDecBufPool();
+
+    /*! \brief Function to append a decoded picture to the output/display picture list
+     * \param [in] dec_buf_idx Index of the picture in the decode buffer pool
+     * \return <tt>ParserResult</tt>
+     */
+    ParserResult InsertOutputPicture(int dec_buf_idx);
 
     /*! \brief Callback function to output decoded pictures from DPB for post-processing.
      * \param [in] no_delay Indicator to override the display delay parameter wth no delay
@@ -215,6 +316,19 @@ protected:
      */
     size_t EbspToRbsp(uint8_t *stream_buffer, size_t begin_bytepos, size_t end_bytepos);
 
+    /*! \brief Function to convert from EBSP to RBSP without touching the parser state, for the slice header workers
+     * \param [out] num_removed_bytes Number of emulation prevention bytes removed
+     * \return Returns the size of the converted buffer in <tt>size_t</tt>
+     */
+    static size_t ConvertEbspToRbsp(uint8_t *stream_buffer, size_t begin_bytepos, size_t end_bytepos, uint32_t *num_removed_bytes);
+
+    /*! \brief Function to run the slice header jobs of a picture: on the slice header worker pool when there are at least
+     * PARALLEL_SLICE_HEADER_MIN_SLICES - 1 of them, else in order on the calling thread. Returns when all jobs are done.
+     * \param [in] num_jobs Number of jobs
+     * \param [in] job Function called once per job index
+     */
+    void RunSliceHeaderJobs(int num_jobs, const std::function<void(int)> &job);
+
     /*! \brief Function to parse Sei Message Info
      * \param [in] nalu A pointer of <tt>uint8_t</tt> for the input stream to be parsed
      * \param [in] size Size of the input stream
@@ -82,6 +82,54 @@ rocDecParseVideoData(RocdecVideoParser parser_handle, RocdecSourceDataPacket *pa
     return ret;  
 }
 
+/************************************************************************************************/
+//! \ingroup group_rocparser
+//! \fn rocDecStatus ROCDECAPI rocDecParseVideoDataEx(RocdecVideoParser parser_handle, RocdecSourceDataPacket *packet,
+//!                                                    RocdecParserEvent *events, uint32_t max_events, uint32_t *num_events)
+//! Parse the video data from source data packet in packet and return the resulting parser events in events
+/************************************************************************************************/
+rocDecStatus ROCDECAPI
+rocDecParseVideoDataEx(RocdecVideoParser parser_handle, RocdecSourceDataPacket *packet, RocdecParserEvent *events, uint32_t max_events, uint32_t *num_events) {
+    if (parser_handle == nullptr || num_events == nullptr || (events == nullptr && max_events > 0)) {
+        return ROCDEC_INVALID_PARAMETER;
+    }
+    *num_events = 0;
+    auto roc_parser_handle = static_cast<RocParserHandle *>(parser_handle);
+    rocDecStatus ret;
+    try {
+        ret = roc_parser_handle->ParseVideoDataEx(packet, events, max_events, num_events);
+    }
+    catch(const std::exception& e) {
+        roc_parser_handle->CaptureError(e.what());
+        ERR(e.what())
+        return ROCDEC_RUNTIME_ERROR;
+    }
+    return ret;
+}
+
+/************************************************************************************************/
+//! \ingroup group_rocparser
+//! \fn rocDecStatus ROCDECAPI rocDecParserReleasePicParams(RocdecVideoParser parser_handle, RocdecPicParams *pic_params)
+//! Return a pic_params slot handed out by rocDecParseVideoDataEx to the parser
+/************************************************************************************************/
+rocDecStatus ROCDECAPI
+rocDecParserReleasePicParams(RocdecVideoParser parser_handle, RocdecPicParams *pic_params) {
+    if (parser_handle == nullptr || pic_params == nullptr) {
+        return ROCDEC_INVALID_PARAMETER;
+    }
+    auto roc_parser_handle = static_cast<RocParserHandle *>(parser_handle);
+    rocDecStatus ret;
+    try {
+        ret = roc_parser_handle->ReleasePicParams(pic_params);
+    }
+    catch(const std::exception& e) {
+        roc_parser_handle->CaptureError(e.what());
+        ERR(e.what())
+        return ROCDEC_RUNTIME_ERROR;
+    }
+    return ret;
+}
+
 /************************************************************************************************/
 //! \ingroup group_rocparser
 //! \fn rocDecStatus ROCDECAPI rocDecParserMarkFrameForReuse(RocdecVideoParser parser_handle, int pic_idx)
@@ -106,6 +154,75 @@ rocDecParserMarkFrameForReuse(RocdecVideoParser parser_handle, int pic_idx) {
 
 }
 
+/************************************************************************************************/
+//! \ingroup group_rocparser
+//! \fn rocDecStatus ROCDECAPI rocDecFlushVideoParser(RocdecVideoParser parser_handle)
+//! Wait until all packets queued by an async_mode parser have been parsed and their callbacks have returned
+/************************************************************************************************/
+rocDecStatus ROCDECAPI
+rocDecFlushVideoParser(RocdecVideoParser parser_handle) {
+    if (parser_handle == nullptr) {
+        return ROCDEC_INVALID_PARAMETER;
+    }
+    auto roc_parser_handle = static_cast<RocParserHandle *>(parser_handle);
+    rocDecStatus ret;
+    try {
+        ret = roc_parser_handle->Flush();
+    }
+    catch(const std::exception& e) {
+        roc_parser_handle->CaptureError(e.what());
+        ERR(e.what())
+        return ROCDEC_RUNTIME_ERROR;
+    }
+    return ret;
+}
+
+/************************************************************************************************/
+//! \ingroup group_rocparser
+//! \fn rocDecStatus ROCDECAPI rocDecGetParserStats(RocdecVideoParser parser_handle, RocdecParserStats *parser_stats)
+//! Get the cumulative statistics of the parser
+/************************************************************************************************/
+rocDecStatus ROCDECAPI
+rocDecGetParserStats(RocdecVideoParser parser_handle, RocdecParserStats *parser_stats) {
+    if (parser_handle == nullptr || parser_stats == nullptr) {
+        return ROCDEC_INVALID_PARAMETER;
+    }
+    auto roc_parser_handle = static_cast<RocParserHandle *>(parser_handle);
+    rocDecStatus ret;
+    try {
+        ret = roc_parser_handle->GetStats(parser_stats);
+    }
+    catch(const std::exception& e) {
+        roc_parser_handle->CaptureError(e.what());
+        ERR(e.what())
+        return ROCDEC_RUNTIME_ERROR;
+    }
+    return ret;
+}
+
+/************************************************************************************************/
+//! \ingroup FUNCTS
+//! \fn rocDecStatus ROCDECAPI rocDecGetParserMemoryUsage(RocdecVideoParser parser_handle, RocdecMemoryUsage *memory_usage)
+//! Get the memory held by the parser
+/************************************************************************************************/
+rocDecStatus ROCDECAPI
+rocDecGetParserMemoryUsage(RocdecVideoParser parser_handle, RocdecMemoryUsage *memory_usage) {
+    if (parser_handle == nullptr || memory_usage == nullptr) {
+        return ROCDEC_INVALID_PARAMETER;
+    }
+    auto roc_parser_handle = static_cast<RocParserHandle *>(parser_handle);
+    rocDecStatus ret;
+    try {
+        ret = roc_parser_handle->GetMemoryUsage(memory_usage);
+    }
+    catch(const std::exception& e) {
+        roc_parser_handle->CaptureError(e.what());
+        ERR(e.what())
+        return ROCDEC_RUNTIME_ERROR;
+    }
+    return ret;
+}
+
 /************************************************************************************************/
 //! \ingroup FUNCTS
 //! \fn rocDecStatus ROCDECAPI rocDecDestroyVideoParser(RocdecVideoParser parser_handle)
@@ -45,11 +45,15 @@ rocDecStatus Vp9VideoParser::Initialize(RocdecParserParams *p_params) {
     if ((ret = RocVideoParser::Initialize(p_params)) != ROCDEC_SUCCESS) {
         return ret;
     }
-    // Set display delay to at least DECODE_BUF_POOL_EXTENSION (2) to prevent synchronous submission
-    if (parser_params_.max_display_delay < DECODE_BUF_POOL_EXTENSION) {
+    // Set display delay to at least DECODE_BUF_POOL_EXTENSION (2) to prevent synchronous submission, unless the pool is kept tight
+    // or the delay is automatic or decode order is requested: frames are shown in decode order, so they need none
+    if (!parser_params_.tight_surface_pool && !parser_params_.auto_display_delay && !parser_params_.decode_order_output &&
+        parser_params_.max_display_delay < DECODE_BUF_POOL_EXTENSION) {
         parser_params_.max_display_delay = DECODE_BUF_POOL_EXTENSION;
     }
-    CheckAndAdjustDecBufPoolSize(VP9_NUM_REF_FRAMES);
+    // The frame store has VP9_NUM_REF_FRAMES slots, one of which the new frame takes: at most VP9_NUM_REF_FRAMES - 1 reference
+    // frames hold a buffer when it is allocated
+    CheckAndAdjustDecBufPoolSize(VP9_NUM_REF_FRAMES, VP9_NUM_REF_FRAMES);
     return ROCDEC_SUCCESS;
 }
 
@@ -58,6 +62,9 @@ rocDecStatus Vp9VideoParser::UnInitialize() {
 }
 
 rocDecStatus Vp9VideoParser::ParseVideoData(RocdecSourceDataPacket *p_data) { 
+    ROCDEC_TRACE_SCOPE("RocVideoParser::ParseVideoData", -1);
+    ParserStatsTimer parse_timer(parse_total_time_ns_);
+    CountPacket(p_data);
     if (p_data->payload && p_data->payload_size) {
         curr_pts_ = p_data->pts;
         if (ParsePictureData(p_data->payload, p_data->payload_size) != PARSER_OK) {
@@ -86,6 +93,8 @@ ParserResult Vp9VideoParser::ParsePictureData(const uint8_t *p_stream, uint32_t
         if ((ret = ParseUncompressedHeader(pic_data_ptr, frame_sizes_[frame_index])) != PARSER_OK) {
             return ret;
         }
+        CountUnit(-1);
+        stats_.num_pics_parsed++;
         // Init Roc decoder for the first time or reconfigure the existing decoder
         if (new_seq_activated_) {
             if ((ret = NotifyNewSequence(&uncompressed_header_)) != PARSER_OK) {
@@ -105,11 +114,7 @@ ParserResult Vp9VideoParser::ParsePictureData(const uint8_t *p_stream, uint32_t
                 decode_buffer_pool_[disp_idx].use_status |= kFrameUsedForDisplay;
                 decode_buffer_pool_[disp_idx].pts = curr_pts_;
                 // Insert into output/display picture list
-                if (num_output_pics_ < dec_buf_pool_size_) {
-                    output_pic_list_[num_output_pics_] = disp_idx;
-                    num_output_pics_++;
-                } else {
-                    ERR("Display list size larger than decode buffer pool size!");
+                if (InsertOutputPicture(disp_idx) != PARSER_OK) {
                     return PARSER_OUT_OF_RANGE;
                 }
             }
@@ -227,7 +232,7 @@ ParserResult Vp9VideoParser::NotifyNewSequence(Vp9UncompressedHeader *p_uncomp_h
     video_format_params_.seqhdr_data_length = 0;
 
     // callback function with RocdecVideoFormat params filled out
-    if (pfn_sequece_cb_(parser_params_.user_data, &video_format_params_) == 0) {
+    if (CallSequenceCallback() == 0) {
         ERR("Sequence callback function failed.");
         return PARSER_FAIL;
     } else {
@@ -324,7 +329,8 @@ ParserResult Vp9VideoParser::SendPicForDecode() {
     PrintVaapiParams();
 #endif // DBGINFO
 
-    if (pfn_decode_picture_cb_(parser_params_.user_data, &dec_pic_params_) == 0) {
+    ROCDEC_TRACE_SCOPE("RocVideoParser::DecodePicture", dec_pic_params_.curr_pic_idx);
+    if (CallDecodePictureCallback() == 0) {
         ERR("Decode error occurred.");
         return PARSER_FAIL;
     } else {
@@ -372,14 +378,9 @@ ParserResult Vp9VideoParser::FlushDpb() {
 }
 
 ParserResult Vp9VideoParser::FindFreeInDecBufPool() {
-    int dec_buf_index;
     // Find a free buffer in decode/display buffer pool to store the decoded image
-    for (dec_buf_index = 0; dec_buf_index < dec_buf_pool_size_; dec_buf_index++) {
-        if (decode_buffer_pool_[dec_buf_index].use_status == kNotUsed) {
-            break;
-        }
-    }
-    if (dec_buf_index == dec_buf_pool_size_) {
+    int dec_buf_index = FindFreeDecodeBuffer();
+    if (dec_buf_index < 0) {
         ERR("Could not find a free buffer in decode buffer pool for decoded image.");
         return PARSER_NOT_FOUND;
     }
@@ -390,13 +391,8 @@ ParserResult Vp9VideoParser::FindFreeInDecBufPool() {
 }
 
 ParserResult Vp9VideoParser::FindFreeInDpbAndMark() {
-    int i;
-    for (i = 0; i < VP9_NUM_REF_FRAMES; i++ ) {
-        if (dpb_buffer_.dec_ref_count[i] == 0) {
-            break;
-        }
-    }
-    if (i == VP9_NUM_REF_FRAMES) {
+    int i = DpbEngine::FindFreeSlot(VP9_NUM_REF_FRAMES, [&](int i) { return dpb_buffer_.dec_ref_count[i] == 0; });
+    if (i < 0) {
         ERR("DPB buffer overflow!");
         return PARSER_NOT_FOUND;
     }
@@ -410,11 +406,7 @@ ParserResult Vp9VideoParser::FindFreeInDpbAndMark() {
         decode_buffer_pool_[disp_idx].use_status |= kFrameUsedForDisplay;
         decode_buffer_pool_[disp_idx].pts = curr_pts_;
         // Insert into output/display picture list
-        if (num_output_pics_ < dec_buf_pool_size_) {
-            output_pic_list_[num_output_pics_] = disp_idx;
-            num_output_pics_++;
-        } else {
-            ERR("Display list size larger than decode buffer pool size!");
+        if (InsertOutputPicture(disp_idx) != PARSER_OK) {
             return PARSER_OUT_OF_RANGE;
         }
     }
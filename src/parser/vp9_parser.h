@@ -53,6 +53,13 @@ public:
      */
     virtual rocDecStatus UnInitialize();     // derived method
 
+    /*! \brief Function to get the bytes held by the parser, including its parameter set tables and slice lists
+     */
+    size_t GetMemoryUsage() override {
+        return sizeof(*this) - sizeof(RocVideoParser) + RocVideoParser::GetMemoryUsage() +
+               frame_sizes_.capacity() * sizeof(uint32_t);
+    }
+
 protected:
     typedef struct {
         int      pic_idx;
@@ -33,6 +33,7 @@ THE SOFTWARE.
 struct DecHandle {
 
     explicit DecHandle(RocDecoderCreateInfo& decoder_create_info) : roc_decoder_(std::make_shared<RocDecoder>(decoder_create_info)) {};   //constructor
+    explicit DecHandle(std::shared_ptr<RocDecoder> roc_decoder) : roc_decoder_(roc_decoder) {};   // constructor for a pooled session
     ~DecHandle() { ClearErrors(); }
     std::shared_ptr<RocDecoder> roc_decoder_;
     bool NoError() { return error_.empty(); }
@@ -0,0 +1,204 @@
+/*
+Copyright (c) 2023 - 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <thread>
+#include <algorithm>
+#include "null_videodecoder.h"
+
+NullVideoDecoder::NullVideoDecoder(RocDecoderCreateInfo &decoder_create_info) : decoder_create_info_{decoder_create_info}, decode_delay_{0} {
+    char *decode_delay = std::getenv("ROCDECODE_NULL_DECODE_DELAY_US");
+    if (decode_delay != nullptr) {
+        decode_delay_ = std::chrono::microseconds(std::max(0, std::atoi(decode_delay)));
+    }
+}
+
+NullVideoDecoder::~NullVideoDecoder() {
+}
+
+rocDecStatus NullVideoDecoder::InitializeDecoder(std::string device_name, std::string gcn_arch_name) {
+    switch (decoder_create_info_.codec_type) {
+        case rocDecVideoCodec_HEVC:
+        case rocDecVideoCodec_AVC:
+        case rocDecVideoCodec_VP9:
+        case rocDecVideoCodec_AV1:
+            break;
+        default:
+            ERR("The codec type is not supported.");
+            return ROCDEC_NOT_SUPPORTED;
+    }
+    rocDecStatus rocdec_status = CreateSurfaces();
+    if (rocdec_status != ROCDEC_SUCCESS) {
+        ERR("Failed to create the null backend surfaces.");
+        return rocdec_status;
+    }
+    return rocdec_status;
+}
+
+rocDecStatus NullVideoDecoder::CreateSurfaces() {
+    if (decoder_create_info_.num_decode_surfaces < 1) {
+        ERR("Invalid number of decode surfaces.");
+        return ROCDEC_INVALID_PARAMETER;
+    }
+    // Mirror the layout of the VA-API surfaces: 256-byte aligned pitch, 16-line aligned planes, interleaved chroma for 4:2:0 and 4:2:2.
+    uint32_t surface_width = std::max(decoder_create_info_.width, decoder_create_info_.max_width);
+    uint32_t surface_height = std::max(decoder_create_info_.height, decoder_create_info_.max_height);
+    uint32_t byte_per_pixel = decoder_create_info_.bit_depth_minus_8 > 0 ? 2 : 1;
+    uint32_t pitch = (surface_width * byte_per_pixel + 255) & ~255;
+    uint32_t vstride = (surface_height + 15) & ~15;
+    uint32_t num_layers, chroma_vstride;
+    switch (decoder_create_info_.chroma_format) {
+        case rocDecVideoChromaFormat_Monochrome:
+            num_layers = 1;
+            chroma_vstride = 0;
+            break;
+        case rocDecVideoChromaFormat_420:
+            num_layers = 2;
+            chroma_vstride = vstride >> 1;
+            break;
+        case rocDecVideoChromaFormat_422:
+            num_layers = 2;
+            chroma_vstride = vstride;
+            break;
+        case rocDecVideoChromaFormat_444:
+            num_layers = 3;
+            chroma_vstride = vstride;
+            break;
+        default:
+            ERR("The surface type is not supported");
+            return ROCDEC_NOT_SUPPORTED;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    surface_width_ = surface_width;
+    surface_height_ = surface_height;
+    surfaces_.clear();
+    surfaces_.resize(decoder_create_info_.num_decode_surfaces);
+    for (auto &surface : surfaces_) {
+        surface.num_layers = num_layers;
+        for (int i = 0; i < 3; i++) {
+            surface.pitch[i] = i < num_layers ? pitch : 0;
+            surface.offset[i] = i < num_layers ? (i == 0 ? 0 : pitch * (vstride + (i - 1) * chroma_vstride)) : 0;
+        }
+        surface.host_mem.assign(static_cast<size_t>(pitch) * (vstride + (num_layers - 1) * chroma_vstride), 0);
+        surface.decode_pending = false;
+    }
+    return ROCDEC_SUCCESS;
+}
+
+rocDecStatus NullVideoDecoder::SubmitDecode(RocdecPicParams *pPicParams) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (pPicParams->curr_pic_idx >= surfaces_.size() || pPicParams->curr_pic_idx < 0) {
+        ERR("curr_pic_idx exceeded the null backend surface pool limit.");
+        return ROCDEC_INVALID_PARAMETER;
+    }
+    NullSurface &surface = surfaces_[pPicParams->curr_pic_idx];
+    surface.decode_pending = decode_delay_.count() > 0;
+    surface.ready_time = std::chrono::steady_clock::now() + decode_delay_;
+    return ROCDEC_SUCCESS;
+}
+
+rocDecStatus NullVideoDecoder::GetDecodeStatus(int pic_idx, RocdecDecodeStatus *decode_status) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (pic_idx >= surfaces_.size() || pic_idx < 0 || decode_status == nullptr) {
+        return ROCDEC_INVALID_PARAMETER;
+    }
+    NullSurface &surface = surfaces_[pic_idx];
+    if (surface.decode_pending && std::chrono::steady_clock::now() < surface.ready_time) {
+        decode_status->decode_status = rocDecodeStatus_InProgress;
+    } else {
+        surface.decode_pending = false;
+        decode_status->decode_status = rocDecodeStatus_Success;
+    }
+    return ROCDEC_SUCCESS;
+}
+
+rocDecStatus NullVideoDecoder::SyncSurface(int pic_idx) {
+    std::chrono::steady_clock::time_point ready_time;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (pic_idx >= surfaces_.size() || pic_idx < 0) {
+            return ROCDEC_INVALID_PARAMETER;
+        }
+        if (!surfaces_[pic_idx].decode_pending) {
+            return ROCDEC_SUCCESS;
+        }
+        ready_time = surfaces_[pic_idx].ready_time;
+    }
+    std::this_thread::sleep_until(ready_time);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (pic_idx < surfaces_.size() && surfaces_[pic_idx].ready_time <= std::chrono::steady_clock::now()) {
+        surfaces_[pic_idx].decode_pending = false;
+    }
+    return ROCDEC_SUCCESS;
+}
+
+rocDecStatus NullVideoDecoder::ReconfigureDecoder(RocdecReconfigureDecoderInfo *reconfig_params) {
+    if (reconfig_params == nullptr) {
+        return ROCDEC_INVALID_PARAMETER;
+    }
+    decoder_create_info_.width = reconfig_params->width;
+    decoder_create_info_.height = reconfig_params->height;
+    decoder_create_info_.num_decode_surfaces = reconfig_params->num_decode_surfaces;
+    decoder_create_info_.target_height = reconfig_params->target_height;
+    decoder_create_info_.target_width = reconfig_params->target_width;
+    if (CanReconfigureInPlace(*reconfig_params)) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto &surface : surfaces_) {
+            surface.decode_pending = false;
+        }
+        return ROCDEC_SUCCESS;
+    }
+
+    rocDecStatus rocdec_status = CreateSurfaces();
+    if (rocdec_status != ROCDEC_SUCCESS) {
+        ERR("Failed to create the null backend surfaces during the decoder reconfiguration.");
+        return rocdec_status;
+    }
+    return rocdec_status;
+}
+
+bool NullVideoDecoder::CanReconfigureInPlace(const RocdecReconfigureDecoderInfo &reconfig_params) {
+    return reconfig_params.num_decode_surfaces == surfaces_.size() &&
+           reconfig_params.width <= surface_width_ && reconfig_params.height <= surface_height_;
+}
+
+rocDecStatus NullVideoDecoder::GetHostSurface(int pic_idx, void *host_mem_ptr[3], uint32_t horizontal_pitch[3]) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (pic_idx >= surfaces_.size() || pic_idx < 0) {
+        return ROCDEC_INVALID_PARAMETER;
+    }
+    NullSurface &surface = surfaces_[pic_idx];
+    for (int i = 0; i < surface.num_layers; i++) {
+        host_mem_ptr[i] = surface.host_mem.data() + surface.offset[i];
+        horizontal_pitch[i] = surface.pitch[i];
+    }
+    return ROCDEC_SUCCESS;
+}
+
+uint64_t NullVideoDecoder::GetSurfaceMemoryUsage() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t bytes = 0;
+    for (auto &surface : surfaces_) {
+        bytes += surface.host_mem.capacity();
+    }
+    return bytes;
+}
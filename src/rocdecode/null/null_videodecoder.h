@@ -0,0 +1,69 @@
+/*
+Copyright (c) 2023 - 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <mutex>
+#include <chrono>
+#include <cstring>
+#include "../roc_decoder_backend.h"
+#include "../../commons.h"
+#include "../../../api/rocdecode.h"
+
+struct NullSurface {
+    std::vector<uint8_t> host_mem; // Host memory backing all the planes of the surface
+    uint32_t offset[3]; // Offset of each plane
+    uint32_t pitch[3]; // Pitch of each plane
+    uint32_t num_layers; // Number of planes making up the surface
+    bool decode_pending; // A decode has been submitted and its (simulated) completion time is in the future
+    std::chrono::steady_clock::time_point ready_time; // Time at which the submitted decode is reported as complete
+};
+
+/*! \brief Decode backend that does not decode. Submissions only update the surface state, which is reported as complete
+ * either immediately or after ROCDECODE_NULL_DECODE_DELAY_US microseconds, and the surfaces handed out are host memory.
+ * It lets the parse->decode->display pipeline run and be benchmarked on machines without a GPU/VCN.
+ */
+class NullVideoDecoder : public RocDecoderBackend {
+public:
+    NullVideoDecoder(RocDecoderCreateInfo &decoder_create_info);
+    ~NullVideoDecoder();
+    rocDecStatus InitializeDecoder(std::string device_name, std::string gcn_arch_name) override;
+    rocDecStatus SubmitDecode(RocdecPicParams *pPicParams) override;
+    rocDecStatus GetDecodeStatus(int pic_idx, RocdecDecodeStatus* decode_status) override;
+    rocDecStatus SyncSurface(int pic_idx) override;
+    rocDecStatus ReconfigureDecoder(RocdecReconfigureDecoderInfo *reconfig_params) override;
+    bool CanReconfigureInPlace(const RocdecReconfigureDecoderInfo &reconfig_params) override;
+    rocDecStatus GetHostSurface(int pic_idx, void *host_mem_ptr[3], uint32_t horizontal_pitch[3]) override;
+    bool HasHostSurfaces() override { return true; }
+    uint64_t GetSurfaceMemoryUsage() override;
+private:
+    RocDecoderCreateInfo decoder_create_info_;
+    std::chrono::microseconds decode_delay_;
+    std::mutex mutex_;
+    std::vector<NullSurface> surfaces_;
+    uint32_t surface_width_ = 0; // allocated surface size: max_width x max_height, as for the VA-API surfaces
+    uint32_t surface_height_ = 0;
+
+    rocDecStatus CreateSurfaces();
+};
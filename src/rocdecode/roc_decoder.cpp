@@ -21,11 +21,31 @@ THE SOFTWARE.
 */
 
 #include "../commons.h"
+#include <sys/eventfd.h>
 #include "roc_decoder.h"
 
-RocDecoder::RocDecoder(RocDecoderCreateInfo& decoder_create_info): va_video_decoder_{decoder_create_info}, decoder_create_info_{decoder_create_info} {}
+#define SUBMIT_QUEUE_DEPTH_ENV "ROCDECODE_SUBMIT_QUEUE_DEPTH"
+#define INTEROP_MAP_ENV "ROCDECODE_INTEROP_MAP"
+
+RocDecoder::RocDecoder(RocDecoderCreateInfo& decoder_create_info): num_devices_{0}, decoder_create_info_{decoder_create_info} {
+#if ROCDECODE_HOST_ONLY
+    video_decoder_ = std::make_unique<NullVideoDecoder>(decoder_create_info_);
+#else
+    hip_dev_prop_ = {};
+    if (GetBackendType(decoder_create_info_) == rocDecBackend_Null) {
+        video_decoder_ = std::make_unique<NullVideoDecoder>(decoder_create_info_);
+    } else {
+        video_decoder_ = std::make_unique<VaapiVideoDecoder>(decoder_create_info_);
+    }
+#endif
+}
 
  RocDecoder::~RocDecoder() {
+    // the queued pictures are still submitted before the backend goes away
+    StopSubmitWorker();
+    EndSession();
+#if !ROCDECODE_HOST_ONLY
+    StopInteropMap();
     // clean up the VA-API/HIP interop memories
     for(auto i = 0; i < hip_interop_.size(); i++) {
         if (hip_interop_[i].hip_mapped_device_mem != nullptr) {
@@ -41,48 +61,377 @@ RocDecoder::RocDecoder(RocDecoderCreateInfo& decoder_create_info): va_video_deco
             }
         }
     }
+#endif
  }
 
  rocDecStatus RocDecoder::InitializeDecoder() {
     rocDecStatus rocdec_status = ROCDEC_SUCCESS;
-    rocdec_status = InitHIP(decoder_create_info_.device_id);
-    if (rocdec_status != ROCDEC_SUCCESS) {
-        ERR("Failed to initilize the HIP.");
-        return rocdec_status;
-    }
     if (decoder_create_info_.num_decode_surfaces < 1) {
         ERR("Invalid number of decode surfaces.");
         return ROCDEC_INVALID_PARAMETER;
     }
+#if ROCDECODE_HOST_ONLY
+    rocdec_status = video_decoder_->InitializeDecoder("", "");
+#else
+    // Backends with host-memory surfaces neither decode on the GPU nor need the HIP interop
+    if (!video_decoder_->HasHostSurfaces()) {
+        rocdec_status = InitHIP(decoder_create_info_.device_id);
+        if (rocdec_status != ROCDEC_SUCCESS) {
+            ERR("Failed to initilize the HIP.");
+            return rocdec_status;
+        }
+    }
     hip_interop_.resize(decoder_create_info_.num_decode_surfaces);
     for (auto i = 0; i < hip_interop_.size(); i++) {
         memset((void *)&hip_interop_[i], 0, sizeof(hip_interop_[i]));
     }
 
-    rocdec_status = va_video_decoder_.InitializeDecoder(hip_dev_prop_.name, hip_dev_prop_.gcnArchName);
+    rocdec_status = video_decoder_->InitializeDecoder(hip_dev_prop_.name, hip_dev_prop_.gcnArchName);
+#endif
     if (rocdec_status != ROCDEC_SUCCESS) {
-        ERR("Failed to initilize the VAAPI Video decoder.");
+        ERR("Failed to initilize the video decoder backend.");
         return rocdec_status;
     }
+    UpdateSurfaceMemoryUsage();
+
+    uint32_t submit_queue_depth = decoder_create_info_.submit_queue_depth;
+    char *queue_depth = std::getenv(SUBMIT_QUEUE_DEPTH_ENV);
+    if (submit_queue_depth == 0 && queue_depth != nullptr) {
+        submit_queue_depth = std::atoi(queue_depth);
+    }
+    if (submit_queue_depth > 0) {
+        StartSubmitWorker(submit_queue_depth);
+    }
+
+    interop_map_mode_ = GetInteropMapMode(decoder_create_info_);
+#if !ROCDECODE_HOST_ONLY
+    rocdec_status = StartInteropMap();
+    if (rocdec_status != ROCDEC_SUCCESS) {
+        ERR("Failed to map the decode surfaces for HIP.");
+        return rocdec_status;
+    }
+#endif
+    initialized_ = true;
+    BeginSession();
 
      return rocdec_status;
  }
 
+bool RocDecoder::IsReusable() {
+    if (!initialized_) {
+        return false;
+    }
+    WaitForAllSubmissions();
+    std::lock_guard<std::mutex> lock(submit_mutex_);
+    return submit_status_ == ROCDEC_SUCCESS;
+}
+
+bool RocDecoder::MatchesSession(const RocDecoderCreateInfo &decoder_create_info) {
+    // the VA context and the surface format are fixed by these; the rest can be changed by a reconfiguration
+    return decoder_create_info.device_id == decoder_create_info_.device_id &&
+           decoder_create_info.codec_type == decoder_create_info_.codec_type &&
+           decoder_create_info.chroma_format == decoder_create_info_.chroma_format &&
+           decoder_create_info.bit_depth_minus_8 == decoder_create_info_.bit_depth_minus_8 &&
+           decoder_create_info.max_width == decoder_create_info_.max_width &&
+           decoder_create_info.max_height == decoder_create_info_.max_height &&
+           decoder_create_info.output_format == decoder_create_info_.output_format &&
+           decoder_create_info.submit_queue_depth == decoder_create_info_.submit_queue_depth &&
+           GetBackendType(decoder_create_info) == GetBackendType(decoder_create_info_);
+}
+
+rocDecStatus RocDecoder::ReuseSession(RocDecoderCreateInfo &decoder_create_info) {
+    rocDecStatus rocdec_status = ROCDEC_SUCCESS;
+    // the parked session keeps the HIP mapping mode it was created with: switch it to the requested mode, and map its surfaces
+    // as that mode asks once any reconfiguration is done
+    rocDecInteropMapMode interop_map_mode = GetInteropMapMode(decoder_create_info);
+    bool interop_map_mode_changed = interop_map_mode != interop_map_mode_;
+#if !ROCDECODE_HOST_ONLY
+    if (interop_map_mode_changed) {
+        StopInteropMap();
+    }
+#endif
+    interop_map_mode_ = interop_map_mode;
+    if (decoder_create_info.width != decoder_create_info_.width || decoder_create_info.height != decoder_create_info_.height ||
+        decoder_create_info.num_decode_surfaces != decoder_create_info_.num_decode_surfaces ||
+        decoder_create_info.target_width != decoder_create_info_.target_width ||
+        decoder_create_info.target_height != decoder_create_info_.target_height) {
+        RocdecReconfigureDecoderInfo reconfig_params = {};
+        reconfig_params.width = decoder_create_info.width;
+        reconfig_params.height = decoder_create_info.height;
+        reconfig_params.target_width = decoder_create_info.target_width;
+        reconfig_params.target_height = decoder_create_info.target_height;
+        reconfig_params.num_decode_surfaces = decoder_create_info.num_decode_surfaces;
+        rocdec_status = ReconfigureDecoder(&reconfig_params);
+        if (rocdec_status != ROCDEC_SUCCESS) {
+            ERR("Failed to reconfigure the pooled decoder session.");
+            return rocdec_status;
+        }
+    }
+#if !ROCDECODE_HOST_ONLY
+    if (interop_map_mode_changed) {
+        // a reconfiguration may have started mapping already; the surfaces that are mapped are skipped
+        StopInteropMap();
+        rocdec_status = StartInteropMap();
+        if (rocdec_status != ROCDEC_SUCCESS) {
+            ERR("Failed to map the pooled decoder session for HIP.");
+            return rocdec_status;
+        }
+    }
+#endif
+    // the remaining fields are only informational to the decoder
+    decoder_create_info_ = decoder_create_info;
+    BeginSession();
+    return rocdec_status;
+}
+
+void RocDecoder::BeginSession() {
+    EndSession();
+    // the frame rate comes from the placement rocDecSelectDevice reserved on the device, if any
+    session_load_ = RocDecScheduler::GetInstance().RegisterSession(decoder_create_info_.device_id,
+                                                                   static_cast<uint64_t>(decoder_create_info_.width) * decoder_create_info_.height);
+    metrics_ = RocDecMetricsPublisher::Create(rocDecMetricsSession_Decoder, decoder_create_info_.device_id, decoder_create_info_.codec_type);
+    if (metrics_) {
+        metrics_->Store(&RocdecMetricsSegment::width, decoder_create_info_.width);
+        metrics_->Store(&RocdecMetricsSegment::height, decoder_create_info_.height);
+        metrics_->Store(&RocdecMetricsSegment::num_surfaces, decoder_create_info_.num_decode_surfaces);
+    }
+}
+
+void RocDecoder::EndSession() {
+    if (session_load_) {
+        RocDecScheduler::GetInstance().UnregisterSession(session_load_);
+        session_load_.reset();
+    }
+    metrics_.reset();
+    // the notifications belong to the handle of the session
+    std::lock_guard<std::mutex> lock(completion_mutex_);
+    if (completion_target_) {
+        completion_target_->Close();
+        completion_target_.reset();
+    }
+}
+
+rocDecStatus RocDecoder::SetDecodeCompleteNotify(RocdecDecodeCompleteNotifyParams *notify_params) {
+    if (notify_params == nullptr) {
+        return ROCDEC_INVALID_PARAMETER;
+    }
+    notify_params->event_fd = -1;
+    std::lock_guard<std::mutex> lock(completion_mutex_);
+    if (completion_target_) {
+        completion_target_->Close();
+        completion_target_.reset();
+    }
+    if (notify_params->pfn_decode_complete == nullptr && !notify_params->enable_event_fd) {
+        return ROCDEC_SUCCESS;
+    }
+    int event_fd = -1;
+    if (notify_params->enable_event_fd) {
+        event_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if (event_fd < 0) {
+            ERR("Failed to create the decode completion eventfd.");
+            return ROCDEC_RUNTIME_ERROR;
+        }
+    }
+    completion_target_ = std::make_shared<RocDecCompletionTarget>(video_decoder_.get(), notify_params->pfn_decode_complete,
+                                                                  notify_params->user_data, event_fd);
+    notify_params->event_fd = event_fd;
+    return ROCDEC_SUCCESS;
+}
+
+void RocDecoder::WatchCompletion(int pic_idx) {
+    std::shared_ptr<RocDecCompletionTarget> completion_target;
+    {
+        std::lock_guard<std::mutex> lock(completion_mutex_);
+        completion_target = completion_target_;
+    }
+    if (completion_target) {
+        RocDecCompletionService::GetInstance().Watch(completion_target, pic_idx);
+    }
+}
+
+void RocDecoder::CountSubmittedPixels() {
+    // only pictures the backend accepted load the device
+    if (session_load_) {
+        session_load_->pixels_submitted += static_cast<uint64_t>(decoder_create_info_.width) * decoder_create_info_.height;
+    }
+}
+
 rocDecStatus RocDecoder::DecodeFrame(RocdecPicParams *pic_params) {
+    ROCDEC_TRACE_SCOPE("RocDecoder::DecodeFrame", pic_params->curr_pic_idx);
+    if (metrics_) {
+        metrics_->Add(&RocdecMetricsSegment::num_frames, 1);
+        metrics_->Add(&RocdecMetricsSegment::num_bytes, pic_params->bitstream_data_len);
+        metrics_->SurfaceSubmitted(pic_params->curr_pic_idx);
+        metrics_->UpdateFrameRate();
+    }
+    if (async_submit_) {
+        return QueueDecode(pic_params);
+    }
     rocDecStatus rocdec_status = ROCDEC_SUCCESS;
-    rocdec_status = va_video_decoder_.SubmitDecode(pic_params);
+    rocdec_status = video_decoder_->SubmitDecode(pic_params);
     if (rocdec_status != ROCDEC_SUCCESS) {
         ERR("Decode submission is not successful.");
+        if (metrics_) {
+            metrics_->Add(&RocdecMetricsSegment::num_errors, 1);
+        }
+    } else {
+        CountSubmittedPixels();
+        WatchCompletion(pic_params->curr_pic_idx);
     }
 
      return rocdec_status;
 }
 
+rocDecStatus RocDecoder::QueueDecode(RocdecPicParams *pic_params) {
+    if (pic_params->curr_pic_idx < 0 || pic_params->curr_pic_idx >= surface_fences_.size()) {
+        ERR("curr_pic_idx exceeded the decode surface pool limit.");
+        return ROCDEC_INVALID_PARAMETER;
+    }
+    std::unique_lock<std::mutex> lock(submit_mutex_);
+    // back-pressure: wait for the worker when the ring is full
+    submit_done_cv_.wait(lock, [&] { return submit_count_ < submit_queue_.size(); });
+    PendingPicture &slot = submit_queue_[(submit_head_ + submit_count_) % submit_queue_.size()];
+    size_t slot_capacity = slot.bitstream.capacity() + slot.slice_params.capacity() + slot.anchor_frames.capacity() * sizeof(int);
+    slot.pic_params = *pic_params;
+    if (pic_params->bitstream_data && pic_params->bitstream_data_len) {
+        slot.bitstream.assign(pic_params->bitstream_data, pic_params->bitstream_data + pic_params->bitstream_data_len);
+        slot.pic_params.bitstream_data = slot.bitstream.data();
+    }
+    // all slice_params members of the union alias the same pointer
+    size_t slice_params_size = GetSliceParamsSize(decoder_create_info_.codec_type) * pic_params->num_slices;
+    if (pic_params->slice_params.avc && slice_params_size) {
+        const uint8_t *src = reinterpret_cast<const uint8_t *>(pic_params->slice_params.avc);
+        slot.slice_params.assign(src, src + slice_params_size);
+        slot.pic_params.slice_params.avc = reinterpret_cast<RocdecAvcSliceParams *>(slot.slice_params.data());
+    }
+    if (decoder_create_info_.codec_type == rocDecVideoCodec_AV1 && pic_params->pic_params.av1.anchor_frames_list &&
+        pic_params->pic_params.av1.anchor_frames_num > 0) {
+        const int *src = pic_params->pic_params.av1.anchor_frames_list;
+        slot.anchor_frames.assign(src, src + pic_params->pic_params.av1.anchor_frames_num);
+        slot.pic_params.pic_params.av1.anchor_frames_list = slot.anchor_frames.data();
+    }
+    // the slots keep their capacity, so the queue only grows to its high-water mark
+    memory_account_.Add(kMemDecodeQueue, static_cast<int64_t>(slot.bitstream.capacity() + slot.slice_params.capacity() +
+                        slot.anchor_frames.capacity() * sizeof(int)) - static_cast<int64_t>(slot_capacity));
+    surface_fences_[pic_params->curr_pic_idx]++;
+    submit_count_++;
+    if (session_load_) {
+        session_load_->queue_depth = submit_count_;
+    }
+    // report an error of a previously queued picture once
+    rocDecStatus status = submit_status_;
+    submit_status_ = ROCDEC_SUCCESS;
+    lock.unlock();
+    submit_work_cv_.notify_one();
+    return status;
+}
+
+rocDecStatus RocDecoder::WaitForSubmission(int pic_idx) {
+    if (!async_submit_) {
+        return ROCDEC_SUCCESS;
+    }
+    if (pic_idx < 0 || pic_idx >= surface_fences_.size()) {
+        return ROCDEC_INVALID_PARAMETER;
+    }
+    std::unique_lock<std::mutex> lock(submit_mutex_);
+    submit_done_cv_.wait(lock, [&] { return surface_fences_[pic_idx] == 0; });
+    return ROCDEC_SUCCESS;
+}
+
+void RocDecoder::WaitForAllSubmissions() {
+    if (!async_submit_) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(submit_mutex_);
+    submit_done_cv_.wait(lock, [&] { return submit_count_ == 0; });
+}
+
+void RocDecoder::StartSubmitWorker(uint32_t queue_depth) {
+    submit_queue_.resize(queue_depth);
+    surface_fences_.assign(decoder_create_info_.num_decode_surfaces, 0);
+    submit_head_ = submit_count_ = 0;
+    submit_stop_ = false;
+    submit_status_ = ROCDEC_SUCCESS;
+    async_submit_ = true;
+    submit_thread_ = std::thread(&RocDecoder::SubmitWorker, this);
+}
+
+void RocDecoder::StopSubmitWorker() {
+    if (!async_submit_) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(submit_mutex_);
+        submit_stop_ = true;
+    }
+    submit_work_cv_.notify_one();
+    if (submit_thread_.joinable()) {
+        submit_thread_.join();
+    }
+    async_submit_ = false;
+}
+
+void RocDecoder::SubmitWorker() {
+    while (true) {
+        PendingPicture *slot;
+        {
+            std::unique_lock<std::mutex> lock(submit_mutex_);
+            submit_work_cv_.wait(lock, [&] { return submit_count_ > 0 || submit_stop_; });
+            if (submit_count_ == 0) {
+                break;
+            }
+            // the slot stays owned by the worker until submit_count_ is decremented
+            slot = &submit_queue_[submit_head_];
+        }
+
+        // pictures are submitted in the order they were queued, which is the decode order of the parser
+        rocDecStatus status;
+        {
+            ROCDEC_TRACE_SCOPE("RocDecoder::SubmitWorker", slot->pic_params.curr_pic_idx);
+            status = video_decoder_->SubmitDecode(&slot->pic_params);
+        }
+        if (status != ROCDEC_SUCCESS) {
+            ERR("Decode submission is not successful.");
+            if (metrics_) {
+                metrics_->Add(&RocdecMetricsSegment::num_errors, 1);
+            }
+        } else {
+            CountSubmittedPixels();
+            WatchCompletion(slot->pic_params.curr_pic_idx);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(submit_mutex_);
+            if (status != ROCDEC_SUCCESS && submit_status_ == ROCDEC_SUCCESS) {
+                submit_status_ = status;
+            }
+            // the surface fence is released on failure too, so that the waiters see the backend status of the surface
+            surface_fences_[slot->pic_params.curr_pic_idx]--;
+            submit_head_ = (submit_head_ + 1) % submit_queue_.size();
+            submit_count_--;
+            if (session_load_) {
+                session_load_->queue_depth = submit_count_;
+            }
+        }
+        submit_done_cv_.notify_all();
+    }
+}
+
 rocDecStatus RocDecoder::GetDecodeStatus(int pic_idx, RocdecDecodeStatus* decode_status) {
     rocDecStatus rocdec_status = ROCDEC_SUCCESS;
-    rocdec_status = va_video_decoder_.GetDecodeStatus(pic_idx, decode_status);
+    // a decode that is still queued for submission is in progress as far as the caller is concerned
+    if (async_submit_ && decode_status != nullptr && pic_idx >= 0 && pic_idx < surface_fences_.size()) {
+        std::lock_guard<std::mutex> lock(submit_mutex_);
+        if (surface_fences_[pic_idx] > 0) {
+            decode_status->decode_status = rocDecodeStatus_InProgress;
+            return ROCDEC_SUCCESS;
+        }
+    }
+    rocdec_status = video_decoder_->GetDecodeStatus(pic_idx, decode_status);
     if (rocdec_status != ROCDEC_SUCCESS) {
         ERR("Failed to query the decode status.");
+    } else if (metrics_) {
+        metrics_->SurfaceStatus(pic_idx, decode_status->decode_status);
     }
     return rocdec_status;
 }
@@ -92,70 +441,118 @@ rocDecStatus RocDecoder::ReconfigureDecoder(RocdecReconfigureDecoderInfo *reconf
         return ROCDEC_INVALID_PARAMETER;
     }
     rocDecStatus rocdec_status;
-    for (int pic_idx = 0; pic_idx < hip_interop_.size(); pic_idx++) {
-        rocdec_status = FreeVideoFrame(pic_idx);
-        if (rocdec_status != ROCDEC_SUCCESS) {
-            ERR("Releasing the video frame for picture idx = " + TOSTR(pic_idx) + " failed during reconfiguration.");
-            return rocdec_status;
+    // the queued pictures belong to the old configuration
+    WaitForAllSubmissions();
+    {
+        // the pictures watched for completion may be on surfaces that are about to be reallocated
+        std::lock_guard<std::mutex> lock(completion_mutex_);
+        if (completion_target_) {
+            completion_target_->Cancel();
         }
     }
-    rocdec_status = va_video_decoder_.ReconfigureDecoder(reconfig_params);
+#if !ROCDECODE_HOST_ONLY
+    // a resolution change within the allocated surface size keeps the surfaces and with them the HIP interop mappings
+    bool keep_surfaces = video_decoder_->CanReconfigureInPlace(*reconfig_params);
+    if (!keep_surfaces) {
+        StopInteropMap();
+        for (int pic_idx = 0; pic_idx < hip_interop_.size(); pic_idx++) {
+            rocdec_status = FreeVideoFrame(pic_idx);
+            if (rocdec_status != ROCDEC_SUCCESS) {
+                ERR("Releasing the video frame for picture idx = " + TOSTR(pic_idx) + " failed during reconfiguration.");
+                return rocdec_status;
+            }
+        }
+    }
+#endif
+    rocdec_status = video_decoder_->ReconfigureDecoder(reconfig_params);
     if (rocdec_status != ROCDEC_SUCCESS) {
         ERR("Reconfiguration of the decoder failed.");
         return rocdec_status;
     }
+    UpdateSurfaceMemoryUsage();
+    decoder_create_info_.width = reconfig_params->width;
+    decoder_create_info_.height = reconfig_params->height;
+    decoder_create_info_.target_width = reconfig_params->target_width;
+    decoder_create_info_.target_height = reconfig_params->target_height;
+    decoder_create_info_.num_decode_surfaces = reconfig_params->num_decode_surfaces;
+    if (session_load_) {
+        RocDecScheduler::GetInstance().UpdateSession(session_load_, static_cast<uint64_t>(reconfig_params->width) * reconfig_params->height);
+    }
+    if (metrics_) {
+        metrics_->Add(&RocdecMetricsSegment::num_reconfigurations, 1);
+        metrics_->Store(&RocdecMetricsSegment::width, reconfig_params->width);
+        metrics_->Store(&RocdecMetricsSegment::height, reconfig_params->height);
+        metrics_->Store(&RocdecMetricsSegment::num_surfaces, reconfig_params->num_decode_surfaces);
+    }
+#if !ROCDECODE_HOST_ONLY
+    // the surface pool may have changed size; all entries were released above
+    if (!keep_surfaces) {
+        hip_interop_.resize(reconfig_params->num_decode_surfaces);
+    }
+#endif
+    if (async_submit_) {
+        std::lock_guard<std::mutex> lock(submit_mutex_);
+        surface_fences_.assign(reconfig_params->num_decode_surfaces, 0);
+    }
+#if !ROCDECODE_HOST_ONLY
+    if (!keep_surfaces) {
+        rocdec_status = StartInteropMap();
+        if (rocdec_status != ROCDEC_SUCCESS) {
+            ERR("Failed to map the reconfigured decode surfaces for HIP.");
+        }
+    }
+#endif
     return rocdec_status;
 }
 
 rocDecStatus RocDecoder::GetVideoFrame(int pic_idx, void *dev_mem_ptr[3], uint32_t horizontal_pitch[3], RocdecProcParams *vid_postproc_params) {
-    if (pic_idx >= hip_interop_.size() || &dev_mem_ptr[0] == nullptr || vid_postproc_params == nullptr) {
+    if (pic_idx < 0 || &dev_mem_ptr[0] == nullptr || vid_postproc_params == nullptr) {
         return ROCDEC_INVALID_PARAMETER;
     }
+    ROCDEC_TRACE_SCOPE("RocDecoder::GetVideoFrame", pic_idx);
     rocDecStatus rocdec_status = ROCDEC_SUCCESS;
 
+    // wait for the queued decodes into this surface to reach the backend before syncing on it
+    rocdec_status = WaitForSubmission(pic_idx);
+    if (rocdec_status != ROCDEC_SUCCESS) {
+        return rocdec_status;
+    }
     // wait on current surface to make sure that it is ready for the HIP interop
-    rocdec_status = va_video_decoder_.SyncSurface(pic_idx);
+    {
+        ROCDEC_TRACE_SCOPE("RocDecoder::SyncSurface", pic_idx);
+        rocdec_status = video_decoder_->SyncSurface(pic_idx);
+    }
     if (rocdec_status != ROCDEC_SUCCESS) {
         ERR("Failed to export surface for picture idx = " + TOSTR(pic_idx));
         return rocdec_status;
     }
+    if (metrics_) {
+        metrics_->Add(&RocdecMetricsSegment::num_frames_output, 1);
+        metrics_->SurfaceMapped(pic_idx);
+    }
 
-    // do the VA-API/HIP interop once per surface and save it for reusing
-    if (hip_interop_[pic_idx].hip_mapped_device_mem == nullptr) {
-        hipExternalMemoryHandleDesc external_mem_handle_desc = {};
-        hipExternalMemoryBufferDesc external_mem_buffer_desc = {};
-        VADRMPRIMESurfaceDescriptor va_drm_prime_surface_desc = {};
-
-        rocdec_status = va_video_decoder_.ExportSurface(pic_idx, va_drm_prime_surface_desc);
+    // host-memory surfaces are handed out as is
+    if (video_decoder_->HasHostSurfaces()) {
+        rocdec_status = video_decoder_->GetHostSurface(pic_idx, dev_mem_ptr, horizontal_pitch);
         if (rocdec_status != ROCDEC_SUCCESS) {
-            ERR("Failed to export surface for picture idx = " + TOSTR(pic_idx));
-            return rocdec_status;
+            ERR("Failed to get the host surface for picture idx = " + TOSTR(pic_idx));
         }
+        return rocdec_status;
+    }
 
-        external_mem_handle_desc.type = hipExternalMemoryHandleTypeOpaqueFd;
-        external_mem_handle_desc.handle.fd = va_drm_prime_surface_desc.objects[0].fd;
-        external_mem_handle_desc.size = va_drm_prime_surface_desc.objects[0].size;
-
-        CHECK_HIP(hipImportExternalMemory(&hip_interop_[pic_idx].hip_ext_mem, &external_mem_handle_desc));
-
-        external_mem_buffer_desc.size = va_drm_prime_surface_desc.objects[0].size;
-        CHECK_HIP(hipExternalMemoryGetMappedBuffer((void**)&hip_interop_[pic_idx].hip_mapped_device_mem, hip_interop_[pic_idx].hip_ext_mem, &external_mem_buffer_desc));
-
-        hip_interop_[pic_idx].width = va_drm_prime_surface_desc.width;
-        hip_interop_[pic_idx].height = va_drm_prime_surface_desc.height;
-
-        hip_interop_[pic_idx].offset[0] = va_drm_prime_surface_desc.layers[0].offset[0];
-        hip_interop_[pic_idx].offset[1] = va_drm_prime_surface_desc.layers[1].offset[0];
-        hip_interop_[pic_idx].offset[2] = va_drm_prime_surface_desc.layers[2].offset[0];
-
-        hip_interop_[pic_idx].pitch[0] = va_drm_prime_surface_desc.layers[0].pitch[0];
-        hip_interop_[pic_idx].pitch[1] = va_drm_prime_surface_desc.layers[1].pitch[0];
-        hip_interop_[pic_idx].pitch[2] = va_drm_prime_surface_desc.layers[2].pitch[0];
-
-        hip_interop_[pic_idx].num_layers = va_drm_prime_surface_desc.num_layers;
+#if ROCDECODE_HOST_ONLY
+    return ROCDEC_NOT_SUPPORTED;
+#else
+    if (pic_idx >= hip_interop_.size()) {
+        return ROCDEC_INVALID_PARAMETER;
+    }
 
-        for (auto i = 0; i < va_drm_prime_surface_desc.num_objects; ++i) {
-            close(va_drm_prime_surface_desc.objects[i].fd);
+    // do the VA-API/HIP interop once per surface and save it for reusing
+    std::lock_guard<std::mutex> lock(interop_mutex_);
+    if (hip_interop_[pic_idx].hip_mapped_device_mem == nullptr) {
+        rocdec_status = MapSurface(pic_idx);
+        if (rocdec_status != ROCDEC_SUCCESS) {
+            return rocdec_status;
         }
     }
 
@@ -170,6 +567,111 @@ rocDecStatus RocDecoder::GetVideoFrame(int pic_idx, void *dev_mem_ptr[3], uint32
     }
 
     return rocdec_status;
+#endif
+}
+
+#if !ROCDECODE_HOST_ONLY
+rocDecStatus RocDecoder::MapSurface(int pic_idx) {
+    ROCDEC_TRACE_SCOPE("RocDecoder::MapSurface", pic_idx);
+    rocDecStatus rocdec_status = ROCDEC_SUCCESS;
+    hipExternalMemoryHandleDesc external_mem_handle_desc = {};
+    hipExternalMemoryBufferDesc external_mem_buffer_desc = {};
+    VADRMPRIMESurfaceDescriptor va_drm_prime_surface_desc = {};
+
+    rocdec_status = video_decoder_->ExportSurface(pic_idx, va_drm_prime_surface_desc);
+    if (rocdec_status != ROCDEC_SUCCESS) {
+        ERR("Failed to export surface for picture idx = " + TOSTR(pic_idx));
+        return rocdec_status;
+    }
+
+    external_mem_handle_desc.type = hipExternalMemoryHandleTypeOpaqueFd;
+    external_mem_handle_desc.handle.fd = va_drm_prime_surface_desc.objects[0].fd;
+    external_mem_handle_desc.size = va_drm_prime_surface_desc.objects[0].size;
+
+    CHECK_HIP(hipImportExternalMemory(&hip_interop_[pic_idx].hip_ext_mem, &external_mem_handle_desc));
+
+    external_mem_buffer_desc.size = va_drm_prime_surface_desc.objects[0].size;
+    CHECK_HIP(hipExternalMemoryGetMappedBuffer((void**)&hip_interop_[pic_idx].hip_mapped_device_mem, hip_interop_[pic_idx].hip_ext_mem, &external_mem_buffer_desc));
+
+    hip_interop_[pic_idx].width = va_drm_prime_surface_desc.width;
+    hip_interop_[pic_idx].height = va_drm_prime_surface_desc.height;
+
+    hip_interop_[pic_idx].offset[0] = va_drm_prime_surface_desc.layers[0].offset[0];
+    hip_interop_[pic_idx].offset[1] = va_drm_prime_surface_desc.layers[1].offset[0];
+    hip_interop_[pic_idx].offset[2] = va_drm_prime_surface_desc.layers[2].offset[0];
+
+    hip_interop_[pic_idx].pitch[0] = va_drm_prime_surface_desc.layers[0].pitch[0];
+    hip_interop_[pic_idx].pitch[1] = va_drm_prime_surface_desc.layers[1].pitch[0];
+    hip_interop_[pic_idx].pitch[2] = va_drm_prime_surface_desc.layers[2].pitch[0];
+
+    hip_interop_[pic_idx].num_layers = va_drm_prime_surface_desc.num_layers;
+    hip_interop_[pic_idx].size = va_drm_prime_surface_desc.objects[0].size;
+    memory_account_.Add(kMemInterop, hip_interop_[pic_idx].size);
+
+    for (auto i = 0; i < va_drm_prime_surface_desc.num_objects; ++i) {
+        close(va_drm_prime_surface_desc.objects[i].fd);
+    }
+
+    return ROCDEC_SUCCESS;
+}
+
+rocDecStatus RocDecoder::StartInteropMap() {
+    if (interop_map_mode_ == rocDecInteropMap_Lazy || video_decoder_->HasHostSurfaces()) {
+        return ROCDEC_SUCCESS;
+    }
+    if (interop_map_mode_ == rocDecInteropMap_Eager) {
+        std::lock_guard<std::mutex> lock(interop_mutex_);
+        for (int pic_idx = 0; pic_idx < hip_interop_.size(); pic_idx++) {
+            if (hip_interop_[pic_idx].hip_mapped_device_mem == nullptr) {
+                interop_map_status_ = MapSurface(pic_idx);
+                if (interop_map_status_ != ROCDEC_SUCCESS) {
+                    return interop_map_status_;
+                }
+            }
+        }
+        return ROCDEC_SUCCESS;
+    }
+    {
+        std::lock_guard<std::mutex> lock(interop_mutex_);
+        interop_map_pending_ = true;
+        interop_map_status_ = ROCDEC_SUCCESS;
+    }
+    interop_map_stop_ = false;
+    interop_map_thread_ = std::thread(&RocDecoder::InteropMapWorker, this);
+    return ROCDEC_SUCCESS;
+}
+
+void RocDecoder::StopInteropMap() {
+    interop_map_stop_ = true;
+    if (interop_map_thread_.joinable()) {
+        interop_map_thread_.join();
+    }
+    std::lock_guard<std::mutex> lock(interop_mutex_);
+    interop_map_pending_ = false;
+}
+
+void RocDecoder::InteropMapWorker() {
+    // the current HIP device is per thread
+    rocDecStatus status = hipSetDevice(decoder_create_info_.device_id) == hipSuccess ? ROCDEC_SUCCESS : ROCDEC_DEVICE_INVALID;
+    for (int pic_idx = 0; status == ROCDEC_SUCCESS && !interop_map_stop_; pic_idx++) {
+        // the lock is taken per surface, so that rocDecGetVideoFrame on a mapped surface is not held up
+        std::lock_guard<std::mutex> lock(interop_mutex_);
+        if (pic_idx >= hip_interop_.size()) {
+            break;
+        }
+        if (hip_interop_[pic_idx].hip_mapped_device_mem == nullptr) {
+            status = MapSurface(pic_idx);
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(interop_mutex_);
+        if (status != ROCDEC_SUCCESS) {
+            ERR("Background mapping of the decode surfaces failed, the remaining surfaces are mapped on first use.");
+            interop_map_status_ = status;
+        }
+        interop_map_pending_ = false;
+    }
+    interop_done_cv_.notify_all();
 }
 
 rocDecStatus RocDecoder::FreeVideoFrame(int pic_idx) {
@@ -181,13 +683,97 @@ rocDecStatus RocDecoder::FreeVideoFrame(int pic_idx) {
         CHECK_HIP(hipFree(hip_interop_[pic_idx].hip_mapped_device_mem));
     if (hip_interop_[pic_idx].hip_ext_mem != nullptr)
         CHECK_HIP(hipDestroyExternalMemory(hip_interop_[pic_idx].hip_ext_mem));
+    memory_account_.Add(kMemInterop, -static_cast<int64_t>(hip_interop_[pic_idx].size));
 
     memset((void *)&hip_interop_[pic_idx], 0, sizeof(hip_interop_[pic_idx]));
 
     return ROCDEC_SUCCESS;
 }
+#endif
+
+void RocDecoder::UpdateSurfaceMemoryUsage() {
+    uint64_t surface_bytes = video_decoder_->GetSurfaceMemoryUsage();
+    if (video_decoder_->HasHostSurfaces()) {
+        memory_account_.Set(kMemHostSurfaces, surface_bytes);
+    } else {
+        memory_account_.Set(kMemDeviceSurfaces, surface_bytes);
+    }
+}
+
+rocDecStatus RocDecoder::GetMemoryUsage(RocdecMemoryUsage *memory_usage) {
+    if (memory_usage == nullptr) {
+        return ROCDEC_INVALID_PARAMETER;
+    }
+    memory_account_.GetUsage(memory_usage);
+    return ROCDEC_SUCCESS;
+}
+
+rocDecStatus RocDecoder::GetInteropMapStatus(RocdecInteropMapStatus *map_status) {
+    if (map_status == nullptr) {
+        return ROCDEC_INVALID_PARAMETER;
+    }
+    map_status->num_surfaces = decoder_create_info_.num_decode_surfaces;
+    map_status->num_mapped = map_status->num_surfaces;
+    map_status->is_complete = 1;
+    map_status->status = ROCDEC_SUCCESS;
+#if !ROCDECODE_HOST_ONLY
+    // host-memory surfaces need no mapping
+    if (!video_decoder_->HasHostSurfaces()) {
+        std::unique_lock<std::mutex> lock(interop_mutex_);
+        if (map_status->wait) {
+            interop_done_cv_.wait(lock, [&] { return !interop_map_pending_; });
+        }
+        map_status->num_mapped = 0;
+        for (auto &interop : hip_interop_) {
+            map_status->num_mapped += interop.hip_mapped_device_mem != nullptr;
+        }
+        map_status->is_complete = !interop_map_pending_;
+        map_status->status = interop_map_status_;
+    }
+#endif
+    return ROCDEC_SUCCESS;
+}
+
+rocDecBackendType RocDecoder::GetBackendType(const RocDecoderCreateInfo &decoder_create_info) {
+#if ROCDECODE_HOST_ONLY
+    // VA-API is not built into the host-only library
+    return rocDecBackend_Null;
+#else
+    if (decoder_create_info.backend_type != rocDecBackend_Default) {
+        return decoder_create_info.backend_type;
+    }
+    char *backend = std::getenv("ROCDECODE_BACKEND");
+    if (backend != nullptr) {
+        std::string backend_name(backend);
+        if (backend_name.compare("null") == 0 || backend_name.compare("NULL") == 0) {
+            return rocDecBackend_Null;
+        } else if (backend_name.compare("vaapi") != 0 && backend_name.compare("VAAPI") != 0) {
+            ERR("Unknown ROCDECODE_BACKEND " + backend_name + ", using VA-API.");
+        }
+    }
+    return rocDecBackend_VAAPI;
+#endif
+}
 
+rocDecInteropMapMode RocDecoder::GetInteropMapMode(const RocDecoderCreateInfo &decoder_create_info) {
+    if (decoder_create_info.interop_map_mode != rocDecInteropMap_Default) {
+        return decoder_create_info.interop_map_mode;
+    }
+    char *interop_map = std::getenv(INTEROP_MAP_ENV);
+    if (interop_map != nullptr) {
+        std::string interop_map_name(interop_map);
+        if (interop_map_name.compare("eager") == 0) {
+            return rocDecInteropMap_Eager;
+        } else if (interop_map_name.compare("background") == 0) {
+            return rocDecInteropMap_Background;
+        } else if (interop_map_name.compare("lazy") != 0) {
+            ERR("Unknown " + STR(INTEROP_MAP_ENV) + " " + interop_map_name + ", mapping the surfaces on first use.");
+        }
+    }
+    return rocDecInteropMap_Lazy;
+}
 
+#if !ROCDECODE_HOST_ONLY
 rocDecStatus RocDecoder::InitHIP(int device_id) {
     CHECK_HIP(hipGetDeviceCount(&num_devices_));
     if (num_devices_ < 1) {
@@ -199,3 +785,4 @@ rocDecStatus RocDecoder::InitHIP(int device_id) {
 
     return ROCDEC_SUCCESS;
 }
+#endif
@@ -30,7 +30,20 @@ THE SOFTWARE.
 #include <sstream>
 #include <string.h>
 #include <map>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
 #include "../api/rocdecode.h"
+#include "null/null_videodecoder.h"
+#include "roc_decoder_scheduler.h"
+#include "roc_decoder_completion.h"
+#include "../tracer/roc_pipeline_tracer.h"
+#include "../metrics/roc_metrics_publisher.h"
+#include "../metrics/roc_memory_account.h"
+#include "roc_slice_params.h"
+#if !ROCDECODE_HOST_ONLY
 #include <hip/hip_runtime.h>
 #include "vaapi/vaapi_videodecoder.h"
 
@@ -50,7 +63,9 @@ struct HipInteropDeviceMem {
     uint32_t offset[3]; // Offset of each plane
     uint32_t pitch[3]; // Pitch of each plane
     uint32_t num_layers; // Number of layers making up the surface
+    uint64_t size; // Size of the mapped surface in bytes
 };
+#endif
 
 class RocDecoder {
 public:
@@ -61,13 +76,70 @@ public:
     rocDecStatus GetDecodeStatus(int pic_idx, RocdecDecodeStatus* decode_status);
     rocDecStatus ReconfigureDecoder(RocdecReconfigureDecoderInfo *reconfig_params);
     rocDecStatus GetVideoFrame(int pic_idx, void *dev_mem_ptr[3], uint32_t horizontal_pitch[3], RocdecProcParams *vid_postproc_params);
+    static rocDecBackendType GetBackendType(const RocDecoderCreateInfo &decoder_create_info);
+    static rocDecInteropMapMode GetInteropMapMode(const RocDecoderCreateInfo &decoder_create_info);
+    bool IsReusable();
+    bool MatchesSession(const RocDecoderCreateInfo &decoder_create_info);
+    rocDecStatus GetInteropMapStatus(RocdecInteropMapStatus *map_status);
+    rocDecStatus SetDecodeCompleteNotify(RocdecDecodeCompleteNotifyParams *notify_params);
+    rocDecStatus ReuseSession(RocDecoderCreateInfo &decoder_create_info);
+    void EndSession();
+    rocDecStatus GetMemoryUsage(RocdecMemoryUsage *memory_usage);
 
 private:
-    rocDecStatus InitHIP(int device_id);
-    rocDecStatus FreeVideoFrame(int pic_idx);
+    // A queued copy of the picture parameters of rocDecDecodeFrame. The bitstream and the slice parameters belong to the
+    // caller only for the duration of the call, so the slot keeps its own copies. Slots are reused to keep their capacity.
+    struct PendingPicture {
+        RocdecPicParams pic_params;
+        std::vector<uint8_t> bitstream;
+        std::vector<uint8_t> slice_params;
+        std::vector<int> anchor_frames;
+    };
     int num_devices_;
     RocDecoderCreateInfo decoder_create_info_;
-    VaapiVideoDecoder va_video_decoder_;
+    std::unique_ptr<RocDecoderBackend> video_decoder_;
+    bool initialized_ = false;
+    std::shared_ptr<RocDecSessionLoad> session_load_; // load of the session as seen by RocDecScheduler, null while parked
+    std::unique_ptr<RocDecMetricsPublisher> metrics_; // shared-memory metrics of the session, null unless ROCDECODE_METRICS_SHM=1
+    RocDecMemoryAccount memory_account_;
+    void UpdateSurfaceMemoryUsage();
+    void BeginSession();
+    void WatchCompletion(int pic_idx);
+    void CountSubmittedPixels();
+    std::mutex completion_mutex_;
+    std::shared_ptr<RocDecCompletionTarget> completion_target_; // set by rocDecSetDecodeCompleteNotify, null otherwise
+    rocDecStatus QueueDecode(RocdecPicParams *pic_params);
+    rocDecStatus WaitForSubmission(int pic_idx);
+    void WaitForAllSubmissions();
+    void StartSubmitWorker(uint32_t queue_depth);
+    void StopSubmitWorker();
+    void SubmitWorker();
+    bool async_submit_ = false;
+    std::thread submit_thread_;
+    std::mutex submit_mutex_;
+    std::condition_variable submit_work_cv_;   // signalled when a picture is queued or the worker has to stop
+    std::condition_variable submit_done_cv_;   // signalled when a queued picture has been submitted to the backend
+    std::vector<PendingPicture> submit_queue_; // ring of picture slots, submit_queue_depth entries
+    size_t submit_head_ = 0;
+    size_t submit_count_ = 0;
+    bool submit_stop_ = false;
+    rocDecStatus submit_status_ = ROCDEC_SUCCESS;  // first submission error not yet reported
+    std::vector<uint32_t> surface_fences_;        // per pic_idx: # of queued decodes into the surface not yet submitted
+    rocDecInteropMapMode interop_map_mode_ = rocDecInteropMap_Lazy;
+#if !ROCDECODE_HOST_ONLY
+    rocDecStatus InitHIP(int device_id);
+    rocDecStatus FreeVideoFrame(int pic_idx);
+    rocDecStatus MapSurface(int pic_idx);
+    rocDecStatus StartInteropMap();
+    void StopInteropMap();
+    void InteropMapWorker();
     hipDeviceProp_t hip_dev_prop_;
     std::vector<HipInteropDeviceMem> hip_interop_;
+    std::mutex interop_mutex_;              // guards hip_interop_ against the background mapping
+    std::condition_variable interop_done_cv_; // signalled when the background mapping is done
+    std::thread interop_map_thread_;
+    std::atomic<bool> interop_map_stop_{false};
+    bool interop_map_pending_ = false;      // an eager or background mapping has not finished yet
+    rocDecStatus interop_map_status_ = ROCDEC_SUCCESS; // first error of the eager or background mapping
+#endif
 };
\ No newline at end of file
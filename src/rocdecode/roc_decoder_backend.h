@@ -0,0 +1,61 @@
+/*
+Copyright (c) 2023 - 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <string>
+#if !ROCDECODE_HOST_ONLY
+#include <va/va_drmcommon.h>
+#endif
+#include "../../api/rocdecode.h"
+
+/*! \brief Interface implemented by every decode backend driven by RocDecoder.
+ *
+ * Surfaces are addressed by the picture index handed out by the parser; a backend owns the surface pool and
+ * either exports it for the VA-API/HIP interop (device surfaces) or exposes it directly as host memory.
+ */
+class RocDecoderBackend {
+public:
+    virtual ~RocDecoderBackend() {};
+    virtual rocDecStatus InitializeDecoder(std::string device_name, std::string gcn_arch_name) = 0;
+    virtual rocDecStatus SubmitDecode(RocdecPicParams *pPicParams) = 0;
+    virtual rocDecStatus GetDecodeStatus(int pic_idx, RocdecDecodeStatus* decode_status) = 0;
+    virtual rocDecStatus SyncSurface(int pic_idx) = 0;
+    virtual rocDecStatus ReconfigureDecoder(RocdecReconfigureDecoderInfo *reconfig_params) = 0;
+    /*! \brief True if ReconfigureDecoder keeps the current surfaces for reconfig_params, so that their HIP interop mappings stay valid.
+     */
+    virtual bool CanReconfigureInPlace(const RocdecReconfigureDecoderInfo &reconfig_params) { return false; }
+    /*! \brief Exports a device surface as a DRM PRIME descriptor for the HIP interop. Only used when HasHostSurfaces() is false.
+     */
+#if !ROCDECODE_HOST_ONLY
+    virtual rocDecStatus ExportSurface(int pic_idx, VADRMPRIMESurfaceDescriptor &va_drm_prime_surface_desc) { return ROCDEC_NOT_SUPPORTED; }
+#endif
+    /*! \brief Returns the plane pointers and pitches of a host-memory surface. Only used when HasHostSurfaces() is true.
+     */
+    virtual rocDecStatus GetHostSurface(int pic_idx, void *host_mem_ptr[3], uint32_t horizontal_pitch[3]) { return ROCDEC_NOT_SUPPORTED; }
+    /*! \brief True if the backend surfaces live in host memory, i.e. neither HIP nor the VA-API/HIP interop is needed.
+     */
+    virtual bool HasHostSurfaces() { return false; }
+    /*! \brief Bytes held by the surface pool. Device surfaces are estimated from their size and format.
+     */
+    virtual uint64_t GetSurfaceMemoryUsage() { return 0; }
+};
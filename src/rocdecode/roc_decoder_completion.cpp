@@ -0,0 +1,132 @@
+/*
+Copyright (c) 2023 - 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <unistd.h>
+#include <algorithm>
+#include "../commons.h"
+#include "roc_decoder_completion.h"
+
+#define DEFAULT_COMPLETION_POLL_US 200
+
+RocDecCompletionTarget::RocDecCompletionTarget(RocDecoderBackend *backend, PFNVIDDECODECOMPLETECALLBACK pfn_decode_complete, void *user_data, int event_fd) :
+    backend_{backend}, pfn_decode_complete_{pfn_decode_complete}, user_data_{user_data}, event_fd_{event_fd} {}
+
+RocDecCompletionTarget::~RocDecCompletionTarget() {
+    if (event_fd_ >= 0) {
+        close(event_fd_);
+    }
+}
+
+void RocDecCompletionTarget::Cancel() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    generation_++;
+}
+
+void RocDecCompletionTarget::Close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    backend_ = nullptr;
+}
+
+uint32_t RocDecCompletionTarget::Generation() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return generation_;
+}
+
+RocDecCompletionService::RocDecCompletionService() : poll_interval_{DEFAULT_COMPLETION_POLL_US} {
+    char *poll_us = std::getenv("ROCDECODE_COMPLETION_POLL_US");
+    if (poll_us != nullptr) {
+        poll_interval_ = std::chrono::microseconds(std::max(1, std::atoi(poll_us)));
+    }
+}
+
+RocDecCompletionService::~RocDecCompletionService() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    watch_cv_.notify_one();
+    if (completion_thread_.joinable()) {
+        completion_thread_.join();
+    }
+}
+
+void RocDecCompletionService::Watch(const std::shared_ptr<RocDecCompletionTarget> &target, int pic_idx) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        watched_.push_back({target, pic_idx, target->Generation()});
+        if (!completion_thread_.joinable()) {
+            completion_thread_ = std::thread(&RocDecCompletionService::CompletionWorker, this);
+        }
+    }
+    watch_cv_.notify_one();
+}
+
+void RocDecCompletionService::CompletionWorker() {
+    // the pictures still in progress, in submission order; only this thread touches them
+    std::vector<WatchedPicture> in_progress;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (in_progress.empty()) {
+                watch_cv_.wait(lock, [&] { return stop_ || !watched_.empty(); });
+            }
+            if (stop_) {
+                break;
+            }
+            in_progress.insert(in_progress.end(), std::make_move_iterator(watched_.begin()), std::make_move_iterator(watched_.end()));
+            watched_.clear();
+        }
+        size_t num_watched = in_progress.size();
+        in_progress.erase(std::remove_if(in_progress.begin(), in_progress.end(), [&](WatchedPicture &picture) { return Poll(picture); }),
+                          in_progress.end());
+        if (!in_progress.empty() && in_progress.size() == num_watched) {
+            // nothing finished in this pass: back off, but wake up for new pictures to keep their latency low
+            std::unique_lock<std::mutex> lock(mutex_);
+            watch_cv_.wait_for(lock, poll_interval_, [&] { return stop_ || !watched_.empty(); });
+        }
+    }
+}
+
+bool RocDecCompletionService::Poll(WatchedPicture &picture) {
+    RocDecCompletionTarget &target = *picture.target;
+    std::lock_guard<std::mutex> lock(target.mutex_);
+    if (target.closed_ || picture.generation != target.generation_) {
+        return true;
+    }
+    RocdecDecodeStatus decode_status = {};
+    if (target.backend_->GetDecodeStatus(picture.pic_idx, &decode_status) != ROCDEC_SUCCESS) {
+        decode_status.decode_status = rocDecodeStatus_Error;
+    } else if (decode_status.decode_status == rocDecodeStatus_InProgress) {
+        return false;
+    }
+    if (target.pfn_decode_complete_) {
+        target.pfn_decode_complete_(target.user_data_, picture.pic_idx, decode_status.decode_status);
+    }
+    if (target.event_fd_ >= 0) {
+        uint64_t count = 1;
+        if (write(target.event_fd_, &count, sizeof(count)) != sizeof(count)) {
+            ERR("Failed to signal the decode completion eventfd.");
+        }
+    }
+    return true;
+}
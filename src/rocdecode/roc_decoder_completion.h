@@ -0,0 +1,94 @@
+/*
+Copyright (c) 2023 - 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <condition_variable>
+#include "roc_decoder_backend.h"
+
+/*! \brief Decode completion notification of one decoder, see rocDecSetDecodeCompleteNotify.
+ *
+ * The completion thread queries the backend and calls back under mutex_, so Cancel() and Close() return only once no
+ * query or callback of the decoder is in flight.
+ */
+class RocDecCompletionTarget {
+public:
+    RocDecCompletionTarget(RocDecoderBackend *backend, PFNVIDDECODECOMPLETECALLBACK pfn_decode_complete, void *user_data, int event_fd);
+    ~RocDecCompletionTarget();
+    /*! \brief Drops the pictures watched so far, e.g. before the surfaces are reallocated.
+     */
+    void Cancel();
+    /*! \brief Stops all notifications; the backend is not accessed afterwards.
+     */
+    void Close();
+    uint32_t Generation();
+
+private:
+    friend class RocDecCompletionService;
+    std::mutex mutex_;
+    RocDecoderBackend *backend_;
+    PFNVIDDECODECOMPLETECALLBACK pfn_decode_complete_;
+    void *user_data_;
+    int event_fd_;
+    uint32_t generation_ = 0; // incremented by Cancel(); pictures watched with an older generation are dropped
+    bool closed_ = false;
+};
+
+/*! \brief Process-wide completion thread for the pictures of all decoders that asked for notifications.
+ *
+ * The thread polls the (non-blocking) decode status of the watched pictures and notifies the finished ones. It sleeps
+ * for ROCDECODE_COMPLETION_POLL_US (default 200 us) after a pass without completions, so that one thread serves all
+ * the streams of the process instead of one thread blocking in vaSyncSurface per stream.
+ */
+class RocDecCompletionService {
+public:
+    static RocDecCompletionService& GetInstance() {
+        static RocDecCompletionService instance;
+        return instance;
+    }
+    void Watch(const std::shared_ptr<RocDecCompletionTarget> &target, int pic_idx);
+
+private:
+    struct WatchedPicture {
+        std::shared_ptr<RocDecCompletionTarget> target;
+        int pic_idx;
+        uint32_t generation;
+    };
+    RocDecCompletionService();
+    ~RocDecCompletionService();
+    RocDecCompletionService(const RocDecCompletionService&) = delete;
+    RocDecCompletionService& operator=(const RocDecCompletionService&) = delete;
+    void CompletionWorker();
+    bool Poll(WatchedPicture &picture);
+
+    std::mutex mutex_;
+    std::condition_variable watch_cv_;
+    std::thread completion_thread_;
+    std::vector<WatchedPicture> watched_; // pictures added since the last pass of the completion thread
+    std::chrono::microseconds poll_interval_;
+    bool stop_ = false;
+};
@@ -0,0 +1,129 @@
+/*
+Copyright (c) 2023 - 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include "../commons.h"
+#include "roc_decoder_pool.h"
+
+#define DEFAULT_DECODER_POOL_IDLE_MS 10000
+
+RocDecoderPool::RocDecoderPool() : max_sessions_{0}, idle_timeout_{DEFAULT_DECODER_POOL_IDLE_MS} {
+    char *pool_size = std::getenv("ROCDECODE_DECODER_POOL_SIZE");
+    if (pool_size != nullptr) {
+        max_sessions_ = std::atoi(pool_size);
+    }
+    char *idle_ms = std::getenv("ROCDECODE_DECODER_POOL_IDLE_MS");
+    if (idle_ms != nullptr) {
+        idle_timeout_ = std::chrono::milliseconds(std::atoi(idle_ms));
+    }
+}
+
+void RocDecoderPool::ShutdownAtExit() {
+    GetInstance().Shutdown();
+}
+
+void RocDecoderPool::Shutdown() {
+    std::vector<ParkedSession> parked;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+        parked.swap(parked_);
+    }
+    eviction_cv_.notify_one();
+    if (eviction_thread_.joinable()) {
+        eviction_thread_.join();
+    }
+    // the sessions are destroyed while the VA display pool and the HIP runtime are still alive
+    parked.clear();
+}
+
+std::shared_ptr<RocDecoder> RocDecoderPool::Acquire(RocDecoderCreateInfo &decoder_create_info) {
+    std::shared_ptr<RocDecoder> decoder;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // take the most recently parked match: its interop mappings are the most likely to still be warm
+        for (auto it = parked_.rbegin(); it != parked_.rend(); it++) {
+            if (it->decoder->MatchesSession(decoder_create_info)) {
+                decoder = std::move(it->decoder);
+                parked_.erase(std::next(it).base());
+                break;
+            }
+        }
+    }
+    if (decoder && decoder->ReuseSession(decoder_create_info) != ROCDEC_SUCCESS) {
+        // the caller falls back to a new session
+        decoder.reset();
+    }
+    return decoder;
+}
+
+bool RocDecoderPool::Release(std::shared_ptr<RocDecoder> &decoder) {
+    if (max_sessions_ == 0 || !decoder || !decoder->IsReusable()) {
+        return false;
+    }
+    // a parked session does not load its device
+    decoder->EndSession();
+    // registered after the singletons the sessions depend on were constructed, so that it runs before they are destroyed
+    std::call_once(at_exit_flag_, [] { std::atexit(&RocDecoderPool::ShutdownAtExit); });
+    std::shared_ptr<RocDecoder> evicted;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stop_) {
+            // the process is exiting: the caller destroys the session
+            return false;
+        }
+        if (parked_.size() >= max_sessions_) {
+            evicted = std::move(parked_.front().decoder);
+            parked_.erase(parked_.begin());
+        }
+        parked_.push_back({decoder, std::chrono::steady_clock::now()});
+        if (!eviction_thread_.joinable()) {
+            eviction_thread_ = std::thread(&RocDecoderPool::EvictionWorker, this);
+        }
+    }
+    eviction_cv_.notify_one();
+    // the evicted session, if any, is destroyed here outside of the lock
+    return true;
+}
+
+void RocDecoderPool::EvictionWorker() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_) {
+        if (parked_.empty()) {
+            eviction_cv_.wait(lock, [&] { return stop_ || !parked_.empty(); });
+            continue;
+        }
+        auto deadline = parked_.front().parked_time + idle_timeout_;
+        if (eviction_cv_.wait_until(lock, deadline, [&] { return stop_; })) {
+            break;
+        }
+        std::vector<std::shared_ptr<RocDecoder>> evicted;
+        auto now = std::chrono::steady_clock::now();
+        while (!parked_.empty() && parked_.front().parked_time + idle_timeout_ <= now) {
+            evicted.push_back(std::move(parked_.front().decoder));
+            parked_.erase(parked_.begin());
+        }
+        // destroying a session releases VA and HIP resources, which must not block Acquire/Release
+        lock.unlock();
+        evicted.clear();
+        lock.lock();
+    }
+}
@@ -0,0 +1,75 @@
+/*
+Copyright (c) 2023 - 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <condition_variable>
+#include "roc_decoder.h"
+
+/*! \brief Process-wide pool of idle decoder sessions.
+ *
+ * rocDecDestroyDecoder parks a healthy decoder here instead of destroying it, with its VA context, surfaces and HIP
+ * interop mappings. rocDecCreateDecoder hands a parked session back if it matches the device, codec, chroma format,
+ * bit depth and max dimensions of the request, and reconfigures it if the coded size or surface count differ.
+ * The pool is off unless ROCDECODE_DECODER_POOL_SIZE sets the max # of parked sessions. When the pool is full the
+ * session parked the longest is destroyed, and sessions idle for longer than ROCDECODE_DECODER_POOL_IDLE_MS
+ * (default 10000 ms) are destroyed by a background thread.
+ * The pool itself is never destroyed: a static destructor would run after the VA display pool and the HIP runtime it
+ * depends on are gone. The parked sessions are destroyed instead by an atexit hook that is registered when the first
+ * session is parked, which is after those singletons were constructed, so the hook runs before they are torn down.
+ */
+class RocDecoderPool {
+public:
+    static RocDecoderPool& GetInstance() {
+        static RocDecoderPool *instance = new RocDecoderPool();
+        return *instance;
+    }
+    std::shared_ptr<RocDecoder> Acquire(RocDecoderCreateInfo &decoder_create_info);
+    bool Release(std::shared_ptr<RocDecoder> &decoder);
+
+private:
+    struct ParkedSession {
+        std::shared_ptr<RocDecoder> decoder;
+        std::chrono::steady_clock::time_point parked_time;
+    };
+    RocDecoderPool();
+    ~RocDecoderPool() = delete;
+    RocDecoderPool(const RocDecoderPool&) = delete;
+    RocDecoderPool& operator=(const RocDecoderPool&) = delete;
+    void EvictionWorker();
+    void Shutdown();
+    static void ShutdownAtExit();
+
+    uint32_t max_sessions_;
+    std::chrono::milliseconds idle_timeout_;
+    std::mutex mutex_;
+    std::condition_variable eviction_cv_; // signalled when a session is parked or the pool is shutting down
+    std::vector<ParkedSession> parked_;   // in parking order, the oldest first
+    std::thread eviction_thread_;
+    bool stop_ = false;              // set at exit; no session is parked after that
+    std::once_flag at_exit_flag_;
+};
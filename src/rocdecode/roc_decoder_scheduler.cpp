@@ -0,0 +1,137 @@
+/*
+Copyright (c) 2023 - 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <algorithm>
+#include "roc_decoder_scheduler.h"
+
+#define SCHEDULER_MIN_SAMPLE_MS 1000 // shortest interval over which the pixel rate of a session is measured
+#define SCHEDULER_RESERVATION_MS 5000 // time a placement is held for a decoder to be created on the device
+#define SCHEDULER_LOAD_TIE 0.01 // relative load difference under which devices count as equally loaded
+#define SCHEDULER_DEFAULT_FRAME_RATE 30 // frame rate assumed for streams that do not tell theirs
+
+int RocDecScheduler::SelectDevice(const std::vector<uint32_t> &num_vcn_per_device, uint64_t pixels_per_frame, uint32_t frame_rate) {
+    if (frame_rate == 0) {
+        frame_rate = SCHEDULER_DEFAULT_FRAME_RATE;
+    }
+    uint64_t pixel_rate = pixels_per_frame * frame_rate;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto now = std::chrono::steady_clock::now();
+    while (!reservations_.empty() && reservations_.front().expiry_time <= now) {
+        reservations_.pop_front();
+    }
+
+    int num_devices = static_cast<int>(num_vcn_per_device.size());
+    std::vector<double> device_load(num_devices, 0);
+    std::vector<uint32_t> device_queue_depth(num_devices, 0);
+    std::vector<uint32_t> device_sessions(num_devices, 0);
+    for (auto &session_load : sessions_) {
+        if (session_load->device_id >= 0 && session_load->device_id < num_devices) {
+            device_load[session_load->device_id] += SampleSessionLoad(*session_load, now);
+            device_queue_depth[session_load->device_id] += session_load->queue_depth.load();
+            device_sessions[session_load->device_id]++;
+        }
+    }
+    for (auto &reservation : reservations_) {
+        if (reservation.device_id < num_devices) {
+            device_load[reservation.device_id] += reservation.pixels_per_frame * reservation.frame_rate;
+            device_sessions[reservation.device_id]++;
+        }
+    }
+
+    int selected = -1;
+    double selected_load = 0;
+    for (int i = 0; i < num_devices; i++) {
+        if (num_vcn_per_device[i] == 0) {
+            continue;
+        }
+        // the load per VCN instance once the new stream is added
+        double load = (device_load[i] + pixel_rate) / num_vcn_per_device[i];
+        if (selected < 0) {
+            selected = i;
+            selected_load = load;
+            continue;
+        }
+        double tie = std::max(load, selected_load) * SCHEDULER_LOAD_TIE;
+        bool better;
+        if (load < selected_load - tie) {
+            better = true;
+        } else if (load > selected_load + tie) {
+            better = false;
+        } else if (device_queue_depth[i] != device_queue_depth[selected]) {
+            better = device_queue_depth[i] < device_queue_depth[selected];
+        } else {
+            better = device_sessions[i] < device_sessions[selected];
+        }
+        if (better) {
+            selected = i;
+            selected_load = load;
+        }
+    }
+    if (selected >= 0) {
+        reservations_.push_back({selected, pixels_per_frame, frame_rate, now + std::chrono::milliseconds(SCHEDULER_RESERVATION_MS)});
+    }
+    return selected;
+}
+
+std::shared_ptr<RocDecSessionLoad> RocDecScheduler::RegisterSession(int device_id, uint64_t pixels_per_frame) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // the session takes over the oldest placement reserved on its device, with the frame rate the caller gave for it
+    uint32_t frame_rate = SCHEDULER_DEFAULT_FRAME_RATE;
+    for (auto it = reservations_.begin(); it != reservations_.end(); it++) {
+        if (it->device_id == device_id) {
+            frame_rate = it->frame_rate;
+            reservations_.erase(it);
+            break;
+        }
+    }
+    auto session_load = std::make_shared<RocDecSessionLoad>(device_id, pixels_per_frame, frame_rate);
+    sessions_.push_back(session_load);
+    return session_load;
+}
+
+void RocDecScheduler::UpdateSession(const std::shared_ptr<RocDecSessionLoad> &session_load, uint64_t pixels_per_frame) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // the rate measured at the old size no longer applies
+    session_load->pixels_per_frame = pixels_per_frame;
+    session_load->sample_time = std::chrono::steady_clock::now();
+    session_load->sample_pixels = session_load->pixels_submitted.load();
+    session_load->measured_pixel_rate = 0;
+    session_load->has_measured_rate = false;
+}
+
+void RocDecScheduler::UnregisterSession(const std::shared_ptr<RocDecSessionLoad> &session_load) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sessions_.erase(std::remove(sessions_.begin(), sessions_.end(), session_load), sessions_.end());
+}
+
+double RocDecScheduler::SampleSessionLoad(RocDecSessionLoad &session_load, std::chrono::steady_clock::time_point now) {
+    double elapsed = std::chrono::duration<double>(now - session_load.sample_time).count();
+    if (elapsed * 1000 >= SCHEDULER_MIN_SAMPLE_MS) {
+        uint64_t pixels = session_load.pixels_submitted.load();
+        double rate = (pixels - session_load.sample_pixels) / elapsed;
+        session_load.measured_pixel_rate = session_load.has_measured_rate ? (session_load.measured_pixel_rate + rate) / 2 : rate;
+        session_load.has_measured_rate = true;
+        session_load.sample_pixels = pixels;
+        session_load.sample_time = now;
+    }
+    return session_load.has_measured_rate ? session_load.measured_pixel_rate : static_cast<double>(session_load.pixels_per_frame * session_load.frame_rate);
+}
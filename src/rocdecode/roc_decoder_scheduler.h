@@ -0,0 +1,94 @@
+/*
+Copyright (c) 2023 - 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <map>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <chrono>
+#include <vector>
+#include <cstdint>
+
+/*! \brief Load counters of one decoder session, updated by the session and sampled by RocDecScheduler.
+ */
+struct RocDecSessionLoad {
+    RocDecSessionLoad(int device, uint64_t pixels, uint32_t rate) : device_id{device}, frame_rate{rate}, pixels_per_frame{pixels} {};
+    const int device_id;
+    const uint32_t frame_rate; // frame rate reserved by rocDecSelectDevice, or the default if the device was not selected
+    std::atomic<uint64_t> pixels_submitted{0}; // total pixels of the pictures submitted successfully
+    std::atomic<uint32_t> queue_depth{0}; // pictures waiting for submission to the backend
+    // estimate and sampling state, guarded by the scheduler lock
+    uint64_t pixels_per_frame; // coded size of the session, updated on reconfiguration
+    std::chrono::steady_clock::time_point registered_time = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point sample_time = registered_time;
+    uint64_t sample_pixels = 0;
+    double measured_pixel_rate = 0; // exponential moving average of the submitted pixel rate
+    bool has_measured_rate = false;
+};
+
+/*! \brief Process-wide scheduler that places new decode sessions on the least-loaded device.
+ *
+ * Every decoder session registers its RocDecSessionLoad. The load of a session is its measured pixel rate, or the
+ * estimate from its coded size and frame rate until one second of decoding has been measured. A session created on a
+ * selected device takes the frame rate of the oldest placement reserved there. The load of a device is the sum of the
+ * loads of its sessions and of the placements handed out but not yet taken by a decoder, divided by its number of VCN
+ * instances. The VCN instance a session runs on is picked by the driver, so the instances of a device are modelled as
+ * one pool of that capacity. Ties are broken by the queue depth, then by the session count, then by the device id.
+ */
+class RocDecScheduler {
+public:
+    static RocDecScheduler& GetInstance() {
+        static RocDecScheduler instance;
+        return instance;
+    }
+    /*! \brief Picks the device for a new stream and reserves its load there until a decoder is created on it.
+     * \param [in] num_vcn_per_device Number of VCN instances of each candidate device that can decode the stream; 0 skips the device
+     * \param [in] pixels_per_frame Coded size of the new stream
+     * \param [in] frame_rate Expected frames per second of the new stream, 0 for the default
+     * \return The selected device id, or -1 if no device can decode the stream
+     */
+    int SelectDevice(const std::vector<uint32_t> &num_vcn_per_device, uint64_t pixels_per_frame, uint32_t frame_rate);
+    std::shared_ptr<RocDecSessionLoad> RegisterSession(int device_id, uint64_t pixels_per_frame);
+    /*! \brief Replaces the coded size of a session after a reconfiguration and restarts the measurement of its rate.
+     */
+    void UpdateSession(const std::shared_ptr<RocDecSessionLoad> &session_load, uint64_t pixels_per_frame);
+    void UnregisterSession(const std::shared_ptr<RocDecSessionLoad> &session_load);
+
+private:
+    struct Reservation {
+        int device_id;
+        uint64_t pixels_per_frame;
+        uint32_t frame_rate;
+        std::chrono::steady_clock::time_point expiry_time;
+    };
+    RocDecScheduler() {};
+    RocDecScheduler(const RocDecScheduler&) = delete;
+    RocDecScheduler& operator=(const RocDecScheduler&) = delete;
+    double SampleSessionLoad(RocDecSessionLoad &session_load, std::chrono::steady_clock::time_point now);
+
+    std::mutex mutex_;
+    std::vector<std::shared_ptr<RocDecSessionLoad>> sessions_;
+    std::deque<Reservation> reservations_; // in reservation order, so the oldest of a device is taken first
+};
@@ -0,0 +1,249 @@
+/*
+Copyright (c) 2023 - 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <fstream>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#if __cplusplus >= 201703L && __has_include(<filesystem>)
+    #include <filesystem>
+    namespace fs = std::filesystem;
+#else
+    #include <experimental/filesystem>
+    namespace fs = std::experimental::filesystem;
+#endif
+#include "roc_device_topology.h"
+
+void RocDecDeviceTopology::SetSysfsRoot(const std::string &sysfs_root, const std::string &dri_dir) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sysfs_root_ = sysfs_root;
+    dri_dir_ = dri_dir;
+    discovered_ = false;
+    visible_devices_.clear();
+    compute_partitions_.clear();
+    render_nodes_.clear();
+}
+
+std::string RocDecDeviceTopology::GetRenderNode(int device_id, const std::string &device_name, const std::string &gcn_arch_name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = render_nodes_.find(device_id);
+    if (it != render_nodes_.end()) {
+        return it->second;
+    }
+    DiscoverLocked();
+
+    std::size_t pos = gcn_arch_name.find_first_of(":");
+    std::string gcn_arch_name_base = (pos != std::string::npos) ? gcn_arch_name.substr(0, pos) : gcn_arch_name;
+    int offset = 0;
+    if (gcn_arch_name_base.compare("gfx942") == 0) {
+        if (compute_partitions_.empty()) {
+            //if the current_compute_partitions is empty then the default SPX mode is assumed.
+            if (IsVisibleDeviceIndex(device_id)) {
+                offset = visible_devices_[device_id] * 7;
+            } else {
+                offset = device_id * 7;
+            }
+        } else {
+            offset = GetDrmNodeOffset(device_name, device_id);
+        }
+    }
+
+    std::string drm_node = dri_dir_ + "/renderD";
+    if (IsVisibleDeviceIndex(device_id)) {
+        drm_node += std::to_string(128 + offset + visible_devices_[device_id]);
+    } else {
+        drm_node += std::to_string(128 + offset + device_id);
+    }
+    render_nodes_[device_id] = drm_node;
+    return drm_node;
+}
+
+std::map<int, std::string> RocDecDeviceTopology::GetRenderNodeMap() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return render_nodes_;
+}
+
+std::vector<int> RocDecDeviceTopology::GetVisibleDevices() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    DiscoverLocked();
+    return visible_devices_;
+}
+
+std::vector<ComputePartition> RocDecDeviceTopology::GetComputePartitions() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    DiscoverLocked();
+    return compute_partitions_;
+}
+
+bool RocDecDeviceTopology::IsVisibleDeviceIndex(int device_id) const {
+    return device_id >= 0 && static_cast<size_t>(device_id) < visible_devices_.size();
+}
+
+void RocDecDeviceTopology::DiscoverLocked() {
+    if (discovered_) {
+        return;
+    }
+    DiscoverVisibleDevices();
+    DiscoverComputePartitions();
+    discovered_ = true;
+}
+
+void RocDecDeviceTopology::DiscoverVisibleDevices() {
+    // First, check if the ROCR_VISIBLE_DEVICES environment variable is present
+    char *visible_devices = std::getenv("ROCR_VISIBLE_DEVICES");
+    // If ROCR_VISIBLE_DEVICES is not present, check if HIP_VISIBLE_DEVICES is present
+    if (visible_devices == nullptr) {
+        visible_devices = std::getenv("HIP_VISIBLE_DEVICES");
+    }
+    if (visible_devices != nullptr) {
+        // tokenize a copy: strtok would otherwise modify the environment
+        std::string devices(visible_devices);
+        char *token = std::strtok(&devices[0], ",");
+        while (token != nullptr) {
+            visible_devices_.push_back(std::atoi(token));
+            token = std::strtok(nullptr, ",");
+        }
+        std::sort(visible_devices_.begin(), visible_devices_.end());
+    }
+}
+
+static bool ReadComputePartition(const fs::path &partition_path, std::vector<ComputePartition> &compute_partitions) {
+    std::ifstream file(partition_path);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::string partition;
+    std::getline(file, partition);
+    if (partition.compare("SPX") == 0 || partition.compare("spx") == 0) {
+        compute_partitions.push_back(kSpx);
+    } else if (partition.compare("DPX") == 0 || partition.compare("dpx") == 0) {
+        compute_partitions.push_back(kDpx);
+    } else if (partition.compare("TPX") == 0 || partition.compare("tpx") == 0) {
+        compute_partitions.push_back(kTpx);
+    } else if (partition.compare("QPX") == 0 || partition.compare("qpx") == 0) {
+        compute_partitions.push_back(kQpx);
+    } else if (partition.compare("CPX") == 0 || partition.compare("cpx") == 0) {
+        compute_partitions.push_back(kCpx);
+    }
+    return true;
+}
+
+void RocDecDeviceTopology::DiscoverComputePartitions() {
+    std::string partition_file = "current_compute_partition";
+    std::error_code ec;
+    // The partition file sits in the PCI device directory of each GPU, which the DRM class links to. Looking there
+    // first avoids walking all of /sys/devices.
+    fs::path drm_class_path = fs::path(sysfs_root_) / "class" / "drm";
+    if (fs::exists(drm_class_path, ec)) {
+        std::vector<fs::path> device_paths;
+        for (auto &entry : fs::directory_iterator(drm_class_path, ec)) {
+            std::string name = entry.path().filename().string();
+            if (name.compare(0, 4, "card") != 0 || name.find('-') != std::string::npos) {
+                continue; // connectors such as card0-DP-1
+            }
+            fs::path device_path = fs::canonical(entry.path() / "device", ec);
+            if (ec || std::find(device_paths.begin(), device_paths.end(), device_path) != device_paths.end()) {
+                ec.clear();
+                continue;
+            }
+            device_paths.push_back(device_path);
+        }
+        // order by PCI path, which is the order of the recursive walk below
+        std::sort(device_paths.begin(), device_paths.end());
+        for (auto &device_path : device_paths) {
+            ReadComputePartition(device_path / partition_file, compute_partitions_);
+        }
+        if (!compute_partitions_.empty()) {
+            return;
+        }
+    }
+
+    std::string search_path = (fs::path(sysfs_root_) / "devices").string();
+    if (fs::exists(search_path, ec)) {
+        for (auto it = fs::recursive_directory_iterator(search_path, fs::directory_options::skip_permission_denied); it != fs::recursive_directory_iterator(); ) {
+            try {
+                if (it->path().filename() == partition_file) {
+                    ReadComputePartition(it->path(), compute_partitions_);
+                }
+                ++it;
+            } catch (fs::filesystem_error& e) {
+                it.increment(ec);
+            }
+        }
+    }
+}
+
+int RocDecDeviceTopology::GetDrmNodeOffset(const std::string &device_name, int device_id) {
+    int offset = 0;
+    std::vector<int> &visible_devices = visible_devices_;
+    switch (compute_partitions_[0]) {
+        case kSpx:
+            if (IsVisibleDeviceIndex(device_id)) {
+                offset = visible_devices[device_id] * 7;
+            } else {
+                offset = device_id * 7;
+            }
+            break;
+        case kDpx:
+            if (IsVisibleDeviceIndex(device_id)) {
+                offset = (visible_devices[device_id] / 2) * 6;
+            } else {
+                offset = (device_id / 2) * 6;
+            }
+            break;
+        case kTpx:
+            // Please note that although there are only 6 XCCs per socket on MI300A,
+            // there are two dummy render nodes added by the driver.
+            // This needs to be taken into account when creating drm_node on each socket in TPX mode.
+            if (IsVisibleDeviceIndex(device_id)) {
+                offset = (visible_devices[device_id] / 3) * 5;
+            } else {
+                offset = (device_id / 3) * 5;
+            }
+            break;
+        case kQpx:
+            if (IsVisibleDeviceIndex(device_id)) {
+                offset = (visible_devices[device_id] / 4) * 4;
+            } else {
+                offset = (device_id / 4) * 4;
+            }
+            break;
+        case kCpx: {
+            // Please note that both MI300A and MI300X have the same gfx_arch_name which is
+            // gfx942. Therefore we cannot use the gfx942 to identify MI300A.
+            // instead use the device name and look for MI300A
+            // Also, as explained aboe in the TPX mode section, we need to be taken into account
+            // the extra two dummy nodes when creating drm_node on each socket in CPX mode as well.
+            std::string mi300a = "MI300A";
+            size_t found_mi300a = device_name.find(mi300a);
+            if (found_mi300a != std::string::npos) {
+                if (IsVisibleDeviceIndex(device_id)) {
+                    offset = (visible_devices[device_id] / 6) * 2;
+                } else {
+                    offset = (device_id / 6) * 2;
+                }
+            }
+            break;
+        }
+    }
+    return offset;
+}
@@ -0,0 +1,83 @@
+/*
+Copyright (c) 2023 - 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+typedef enum {
+    kSpx = 0, // Single Partition Accelerator
+    kDpx = 1, // Dual Partition Accelerator
+    kTpx = 2, // Triple Partition Accelerator
+    kQpx = 3, // Quad Partition Accelerator
+    kCpx = 4, // Core Partition Accelerator
+} ComputePartition;
+
+/*! \brief Process-wide cache of the device topology used to map a device id to its DRM render node.
+ *
+ * The visible device list (ROCR_VISIBLE_DEVICES/HIP_VISIBLE_DEVICES) and the compute partition modes from sysfs are
+ * discovered once, lazily and under a lock, on the first lookup. The render node of each device is cached as well.
+ * The sysfs root can be replaced, e.g. by a fake tree in a test, which drops everything discovered so far.
+ */
+class RocDecDeviceTopology {
+public:
+    static RocDecDeviceTopology& GetInstance() {
+        static RocDecDeviceTopology instance;
+        return instance;
+    }
+    /*! \brief Replaces the sysfs root ("/sys" by default) and the /dev/dri directory, and clears the cached topology.
+     */
+    void SetSysfsRoot(const std::string &sysfs_root, const std::string &dri_dir = "/dev/dri");
+    /*! \brief Returns the render node path (e.g. /dev/dri/renderD128) of a device.
+     * \param [in] device_id HIP device id as passed in RocDecoderCreateInfo
+     * \param [in] device_name HIP device name, used to tell MI300A from MI300X
+     * \param [in] gcn_arch_name HIP gcnArchName of the device
+     */
+    std::string GetRenderNode(int device_id, const std::string &device_name, const std::string &gcn_arch_name);
+    /*! \brief Returns a copy of the cached device id to render node mapping built by GetRenderNode so far.
+     */
+    std::map<int, std::string> GetRenderNodeMap();
+    std::vector<int> GetVisibleDevices();
+    std::vector<ComputePartition> GetComputePartitions();
+
+private:
+    RocDecDeviceTopology() {};
+    RocDecDeviceTopology(const RocDecDeviceTopology&) = delete;
+    RocDecDeviceTopology& operator=(const RocDecDeviceTopology&) = delete;
+    void DiscoverLocked();
+    void DiscoverVisibleDevices();
+    void DiscoverComputePartitions();
+    int GetDrmNodeOffset(const std::string &device_name, int device_id);
+    bool IsVisibleDeviceIndex(int device_id) const; // whether device_id indexes visible_devices_
+
+    std::mutex mutex_;
+    std::string sysfs_root_ = "/sys";
+    std::string dri_dir_ = "/dev/dri";
+    bool discovered_ = false;
+    std::vector<int> visible_devices_; // sorted ids from ROCR_VISIBLE_DEVICES or HIP_VISIBLE_DEVICES
+    std::vector<ComputePartition> compute_partitions_; // one entry per current_compute_partition file found
+    std::map<int, std::string> render_nodes_; // device id to render node path
+};
@@ -0,0 +1,44 @@
+/*
+Copyright (c) 2023 - 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include "../../api/rocdecode.h"
+
+/*! \brief Size of one element of the RocdecPicParams::slice_params array of a codec, or 0 for codecs without slice parameters.
+ * Used wherever the picture parameters are deep-copied: the decoder submission queue and the event-mode parser slots.
+ */
+inline size_t GetSliceParamsSize(rocDecVideoCodec codec_type) {
+    switch (codec_type) {
+        case rocDecVideoCodec_AVC:
+            return sizeof(RocdecAvcSliceParams);
+        case rocDecVideoCodec_HEVC:
+            return sizeof(RocdecHevcSliceParams);
+        case rocDecVideoCodec_VP9:
+            return sizeof(RocdecVp9SliceParams);
+        case rocDecVideoCodec_AV1:
+            return sizeof(RocdecAv1SliceParams);
+        default:
+            return 0;
+    }
+}
@@ -19,9 +19,15 @@ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
 OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 */
+#include <map>
+#include <mutex>
+#include <tuple>
 #include "dec_handle.h"
+#include "roc_decoder_pool.h"
+#include "roc_decoder_scheduler.h"
 #include "rocdecode.h"
 #include "roc_decoder_caps.h"
+#include "../tracer/roc_pipeline_tracer.h"
 #include "../commons.h"
 
 namespace rocdecode {
@@ -36,6 +42,12 @@ rocDecCreateDecoder(rocDecDecoderHandle *decoder_handle, RocDecoderCreateInfo *d
     }
     rocDecDecoderHandle handle = nullptr;
     try {
+        // a matching idle session from the decoder pool skips the decoder initialization
+        std::shared_ptr<RocDecoder> pooled_decoder = RocDecoderPool::GetInstance().Acquire(*decoder_create_info);
+        if (pooled_decoder) {
+            *decoder_handle = new DecHandle(pooled_decoder);
+            return ROCDEC_SUCCESS;
+        }
         handle = new DecHandle(*decoder_create_info);
     }
     catch(const std::exception& e) {
@@ -56,6 +68,8 @@ rocDecDestroyDecoder(rocDecDecoderHandle decoder_handle) {
         return ROCDEC_INVALID_PARAMETER;
     }
     auto handle = static_cast<DecHandle *>(decoder_handle);
+    // with the decoder pool enabled the session is parked for reuse instead of being destroyed with the handle
+    RocDecoderPool::GetInstance().Release(handle->roc_decoder_);
     delete handle;
     return ROCDEC_SUCCESS;
 }
@@ -72,6 +86,14 @@ rocDecGetDecoderCaps(RocdecDecodeCaps *pdc) {
     if (pdc == nullptr) {
         return ROCDEC_INVALID_PARAMETER;
     }
+    RocDecVcnCodecSpec& vcn_codec_spec = RocDecVcnCodecSpec::GetInstance();
+#if ROCDECODE_HOST_ONLY
+    return vcn_codec_spec.GetDecoderCaps("null", pdc);
+#else
+    RocDecoderCreateInfo default_create_info = {};
+    if (RocDecoder::GetBackendType(default_create_info) == rocDecBackend_Null) {
+        return vcn_codec_spec.GetDecoderCaps("null", pdc);
+    }
     hipError_t hip_status = hipSuccess;
     int num_devices = 0;
     hipDeviceProp_t hip_dev_prop;
@@ -94,8 +116,72 @@ rocDecGetDecoderCaps(RocdecDecodeCaps *pdc) {
         return ROCDEC_DEVICE_INVALID;
     }
 
-    RocDecVcnCodecSpec& vcn_codec_spec = RocDecVcnCodecSpec::GetInstance();
     return vcn_codec_spec.GetDecoderCaps(hip_dev_prop.gcnArchName, pdc);
+#endif
+}
+
+/*! \brief rocDecGetDecoderCaps through a process-wide cache. The caps of a device do not change while the process runs,
+ * and rocDecSelectDevice would otherwise query every device with hipGetDeviceProperties on every call.
+ */
+static rocDecStatus GetCachedDecoderCaps(RocdecDecodeCaps *decode_caps) {
+    static std::mutex mutex;
+    static std::map<std::tuple<uint8_t, int, int, uint32_t>, std::pair<rocDecStatus, RocdecDecodeCaps>> cache;
+    auto key = std::make_tuple(decode_caps->device_id, static_cast<int>(decode_caps->codec_type),
+                               static_cast<int>(decode_caps->chroma_format), decode_caps->bit_depth_minus_8);
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = cache.find(key);
+    if (it == cache.end()) {
+        rocDecStatus status = rocdecode::rocDecGetDecoderCaps(decode_caps);
+        it = cache.emplace(key, std::make_pair(status, *decode_caps)).first;
+    }
+    *decode_caps = it->second.second;
+    return it->second.first;
+}
+
+/**********************************************************************************************************************/
+//! \fn rocDecStatus ROCDECAPI rocDecSelectDevice(RocdecDeviceSelectInfo *select_info)
+//! Selects the least-loaded device that supports the IN params of select_info, based on the pixel rate of the active
+//! decoder sessions per VCN instance of each device
+/**********************************************************************************************************************/
+rocDecStatus ROCDECAPI
+rocDecSelectDevice(RocdecDeviceSelectInfo *select_info) {
+    if (select_info == nullptr || select_info->width == 0 || select_info->height == 0) {
+        return ROCDEC_INVALID_PARAMETER;
+    }
+    int num_devices = 1;
+#if !ROCDECODE_HOST_ONLY
+    RocDecoderCreateInfo default_create_info = {};
+    if (RocDecoder::GetBackendType(default_create_info) != rocDecBackend_Null) {
+        hipError_t hip_status = hipGetDeviceCount(&num_devices);
+        if (hip_status != hipSuccess) {
+            ERR("ERROR: hipGetDeviceCount failed!" + TOSTR(hip_status));
+            return ROCDEC_DEVICE_INVALID;
+        }
+    }
+#endif
+    if (select_info->num_devices > 0) {
+        num_devices = std::min(num_devices, static_cast<int>(select_info->num_devices));
+    }
+    std::vector<uint32_t> num_vcn_per_device(num_devices, 0);
+    for (int i = 0; i < num_devices; i++) {
+        RocdecDecodeCaps decode_caps = {};
+        decode_caps.device_id = i;
+        decode_caps.codec_type = select_info->codec_type;
+        decode_caps.chroma_format = select_info->chroma_format;
+        decode_caps.bit_depth_minus_8 = select_info->bit_depth_minus_8;
+        if (GetCachedDecoderCaps(&decode_caps) == ROCDEC_SUCCESS && decode_caps.is_supported &&
+            select_info->width <= decode_caps.max_width && select_info->height <= decode_caps.max_height) {
+            num_vcn_per_device[i] = std::max<uint32_t>(decode_caps.num_decoders, 1);
+        }
+    }
+    // the frame rate is reserved along with the device and taken over by the decoder created on it
+    int device_id = RocDecScheduler::GetInstance().SelectDevice(num_vcn_per_device, static_cast<uint64_t>(select_info->width) * select_info->height,
+                                                                select_info->frame_rate);
+    if (device_id < 0) {
+        return ROCDEC_NOT_SUPPORTED;
+    }
+    select_info->device_id = static_cast<uint8_t>(device_id);
+    return ROCDEC_SUCCESS;
 }
 
 /*****************************************************************************************************/
@@ -145,6 +231,85 @@ rocDecGetDecodeStatus(rocDecDecoderHandle decoder_handle, int pic_idx, RocdecDec
     return ret;
 }
 
+/*****************************************************************************************************/
+//! \fn rocDecStatus ROCDECAPI rocDecGetInteropMapStatus(rocDecDecoderHandle decoder_handle, RocdecInteropMapStatus *map_status)
+//! Reports the progress of the HIP interop mapping of the decode surfaces, optionally waiting for it to finish
+/*****************************************************************************************************/
+rocDecStatus ROCDECAPI
+rocDecGetInteropMapStatus(rocDecDecoderHandle decoder_handle, RocdecInteropMapStatus *map_status) {
+    if (decoder_handle == nullptr || map_status == nullptr) {
+        return ROCDEC_INVALID_PARAMETER;
+    }
+    auto handle = static_cast<DecHandle *>(decoder_handle);
+    rocDecStatus ret;
+    try {
+        ret = handle->roc_decoder_->GetInteropMapStatus(map_status);
+    }
+    catch(const std::exception& e) {
+        handle->CaptureError(e.what());
+        ERR(e.what())
+        return ROCDEC_RUNTIME_ERROR;
+    }
+    return ret;
+}
+
+/*****************************************************************************************************/
+//! \fn rocDecStatus ROCDECAPI rocDecSetDecodeCompleteNotify(rocDecDecoderHandle decoder_handle, RocdecDecodeCompleteNotifyParams *notify_params)
+//! Requests a callback and/or an eventfd notification for the pictures that finish decoding
+/*****************************************************************************************************/
+rocDecStatus ROCDECAPI
+rocDecSetDecodeCompleteNotify(rocDecDecoderHandle decoder_handle, RocdecDecodeCompleteNotifyParams *notify_params) {
+    if (decoder_handle == nullptr || notify_params == nullptr) {
+        return ROCDEC_INVALID_PARAMETER;
+    }
+    auto handle = static_cast<DecHandle *>(decoder_handle);
+    rocDecStatus ret;
+    try {
+        ret = handle->roc_decoder_->SetDecodeCompleteNotify(notify_params);
+    }
+    catch(const std::exception& e) {
+        handle->CaptureError(e.what());
+        ERR(e.what())
+        return ROCDEC_RUNTIME_ERROR;
+    }
+    return ret;
+}
+
+/*****************************************************************************************************/
+//! \fn rocDecStatus ROCDECAPI rocDecGetDecoderMemoryUsage(rocDecDecoderHandle decoder_handle, RocdecMemoryUsage *memory_usage)
+//! Returns the memory held by a decoder
+/*****************************************************************************************************/
+rocDecStatus ROCDECAPI
+rocDecGetDecoderMemoryUsage(rocDecDecoderHandle decoder_handle, RocdecMemoryUsage *memory_usage) {
+    if (decoder_handle == nullptr || memory_usage == nullptr) {
+        return ROCDEC_INVALID_PARAMETER;
+    }
+    auto handle = static_cast<DecHandle *>(decoder_handle);
+    rocDecStatus ret;
+    try {
+        ret = handle->roc_decoder_->GetMemoryUsage(memory_usage);
+    }
+    catch(const std::exception& e) {
+        handle->CaptureError(e.what());
+        ERR(e.what())
+        return ROCDEC_RUNTIME_ERROR;
+    }
+    return ret;
+}
+
+/*****************************************************************************************************/
+//! \fn rocDecStatus ROCDECAPI rocDecGetMemoryUsage(RocdecMemoryUsage *memory_usage)
+//! Returns the memory held by all decoders, parsers and bitstream readers of the process
+/*****************************************************************************************************/
+rocDecStatus ROCDECAPI
+rocDecGetMemoryUsage(RocdecMemoryUsage *memory_usage) {
+    if (memory_usage == nullptr) {
+        return ROCDEC_INVALID_PARAMETER;
+    }
+    RocDecMemoryAccount::GetProcessUsage(memory_usage);
+    return ROCDEC_SUCCESS;
+}
+
 /*********************************************************************************************************/
 //! \fn rocDecStatus ROCDECAPI rocDecReconfigureDecoder(rocDecDecoderHandle decoder_handle, RocdecReconfigureDecoderInfo *reconfig_params)
 //! Used to reuse single decoder for multiple clips. Currently supports resolution change, resize params
@@ -193,6 +358,48 @@ rocDecGetVideoFrame(rocDecDecoderHandle decoder_handle, int pic_idx,
     return ret;
 }
 
+/*****************************************************************************************************/
+//! \fn rocDecStatus ROCDECAPI rocDecTraceEvent(const char *name, rocDecTracePhase phase, int pic_idx)
+//! Records an application event into the pipeline trace
+/*****************************************************************************************************/
+rocDecStatus ROCDECAPI
+rocDecTraceEvent(const char *name, rocDecTracePhase phase, int pic_idx) {
+    RocPipelineTracer &tracer = RocPipelineTracer::GetInstance();
+    if (!tracer.IsEnabled()) {
+        return ROCDEC_SUCCESS;
+    }
+    if (name == nullptr) {
+        return ROCDEC_INVALID_PARAMETER;
+    }
+    switch (phase) {
+        case rocDecTracePhase_Begin:
+            tracer.Record(name, 'B', pic_idx);
+            break;
+        case rocDecTracePhase_End:
+            tracer.Record(name, 'E', pic_idx);
+            break;
+        case rocDecTracePhase_Instant:
+            tracer.Record(name, 'i', pic_idx);
+            break;
+        default:
+            return ROCDEC_INVALID_PARAMETER;
+    }
+    return ROCDEC_SUCCESS;
+}
+
+/*****************************************************************************************************/
+//! \fn rocDecStatus ROCDECAPI rocDecTraceDump(const char *file_path)
+//! Writes the pipeline trace events recorded so far as Chrome trace JSON
+/*****************************************************************************************************/
+rocDecStatus ROCDECAPI
+rocDecTraceDump(const char *file_path) {
+    RocPipelineTracer &tracer = RocPipelineTracer::GetInstance();
+    if (!tracer.IsEnabled()) {
+        return ROCDEC_NOT_SUPPORTED;
+    }
+    return tracer.Dump(file_path) ? ROCDEC_SUCCESS : ROCDEC_RUNTIME_ERROR;
+}
+
 /*****************************************************************************************************/
 //! \fn const char* ROCDECAPI rocDecGetErrorName(rocDecStatus rocdec_status)
 //! \ingroup group_amd_rocdecode
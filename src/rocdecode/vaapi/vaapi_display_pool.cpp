@@ -0,0 +1,121 @@
+/*
+Copyright (c) 2023 - 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include "vaapi_videodecoder.h"
+#include "vaapi_display_pool.h"
+
+rocDecStatus VaapiDisplayPool::AcquireDisplay(const std::string &drm_node, VADisplay &va_display) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = displays_.find(drm_node);
+    if (it != displays_.end()) {
+        it->second.ref_count++;
+        va_display = it->second.va_display;
+        return ROCDEC_SUCCESS;
+    }
+
+    int drm_fd = open(drm_node.c_str(), O_RDWR);
+    if (drm_fd < 0) {
+        ERR("Failed to open drm node." + drm_node);
+        return ROCDEC_NOT_INITIALIZED;
+    }
+    VADisplay display = vaGetDisplayDRM(drm_fd);
+    if (!display) {
+        ERR("Failed to create va_display.");
+        close(drm_fd);
+        return ROCDEC_NOT_INITIALIZED;
+    }
+    vaSetInfoCallback(display, NULL, NULL);
+    int major_version = 0, minor_version = 0;
+    VAStatus va_status = vaInitialize(display, &major_version, &minor_version);
+    if (va_status != VA_STATUS_SUCCESS) {
+        ERR("vaInitialize failed with status: " + std::string(vaErrorStr(va_status)));
+        vaTerminate(display);
+        close(drm_fd);
+        return ROCDEC_RUNTIME_ERROR;
+    }
+    PooledDisplay &pooled_display = displays_[drm_node];
+    pooled_display.drm_fd = drm_fd;
+    pooled_display.va_display = display;
+    pooled_display.ref_count = 1;
+    va_display = display;
+    return ROCDEC_SUCCESS;
+}
+
+void VaapiDisplayPool::ReleaseDisplay(VADisplay va_display) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = displays_.begin(); it != displays_.end(); it++) {
+        if (it->second.va_display != va_display) {
+            continue;
+        }
+        if (--it->second.ref_count == 0) {
+            // vaTerminate also releases the cached configs
+            VAStatus va_status = vaTerminate(it->second.va_display);
+            if (va_status != VA_STATUS_SUCCESS) {
+                ERR("vaTerminate failed");
+            }
+            close(it->second.drm_fd);
+            displays_.erase(it);
+        }
+        return;
+    }
+    ERR("Releasing a VA display that is not in the display pool.");
+}
+
+rocDecStatus VaapiDisplayPool::GetConfigInfo(VADisplay va_display, VAProfile va_profile, VaapiConfigInfo &config_info) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    PooledDisplay *pooled_display = FindDisplay(va_display);
+    if (pooled_display == nullptr) {
+        return ROCDEC_INVALID_PARAMETER;
+    }
+    auto it = pooled_display->configs.find(va_profile);
+    if (it != pooled_display->configs.end()) {
+        config_info = it->second;
+        return ROCDEC_SUCCESS;
+    }
+
+    VaapiConfigInfo info = {};
+    info.rt_format_attrib.type = VAConfigAttribRTFormat;
+    CHECK_VAAPI(vaGetConfigAttributes(va_display, va_profile, VAEntrypointVLD, &info.rt_format_attrib, 1));
+    CHECK_VAAPI(vaCreateConfig(va_display, va_profile, VAEntrypointVLD, &info.rt_format_attrib, 1, &info.config_id));
+    unsigned int num_attribs = 0;
+    CHECK_VAAPI(vaQuerySurfaceAttributes(va_display, info.config_id, nullptr, &num_attribs));
+    std::vector<VASurfaceAttrib> attribs(num_attribs);
+    CHECK_VAAPI(vaQuerySurfaceAttributes(va_display, info.config_id, attribs.data(), &num_attribs));
+    for (auto attrib : attribs) {
+        if (attrib.type == VASurfaceAttribDRMFormatModifiers) {
+            info.supports_modifiers = true;
+            break;
+        }
+    }
+    pooled_display->configs[va_profile] = info;
+    config_info = info;
+    return ROCDEC_SUCCESS;
+}
+
+VaapiDisplayPool::PooledDisplay *VaapiDisplayPool::FindDisplay(VADisplay va_display) {
+    for (auto &it : displays_) {
+        if (it.second.va_display == va_display) {
+            return &it.second;
+        }
+    }
+    return nullptr;
+}
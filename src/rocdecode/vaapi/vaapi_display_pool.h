@@ -0,0 +1,71 @@
+/*
+Copyright (c) 2023 - 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <va/va.h>
+#include "../../../api/rocdecode.h"
+
+/*! \brief Cached result of the config queries for one VA profile on a display.
+ */
+struct VaapiConfigInfo {
+    VAConfigAttrib rt_format_attrib; // VAConfigAttribRTFormat as returned by vaGetConfigAttributes
+    VAConfigID config_id; // VLD config shared by every decoder of this profile on the display
+    bool supports_modifiers; // The config reports VASurfaceAttribDRMFormatModifiers
+};
+
+/*! \brief Process-wide pool of initialized VA displays, one per DRM render node.
+ *
+ * The first decoder on a render node opens it and initializes the display. Later decoders on the same node share the
+ * display, and the last one to release it terminates it. The per-profile config attribute query, config and surface
+ * attribute query are done once per display and cached with it, so a new session only creates its surfaces and context.
+ */
+class VaapiDisplayPool {
+public:
+    static VaapiDisplayPool& GetInstance() {
+        static VaapiDisplayPool instance;
+        return instance;
+    }
+    rocDecStatus AcquireDisplay(const std::string &drm_node, VADisplay &va_display);
+    void ReleaseDisplay(VADisplay va_display);
+    rocDecStatus GetConfigInfo(VADisplay va_display, VAProfile va_profile, VaapiConfigInfo &config_info);
+
+private:
+    struct PooledDisplay {
+        int drm_fd;
+        VADisplay va_display;
+        uint32_t ref_count;
+        std::map<VAProfile, VaapiConfigInfo> configs;
+    };
+    VaapiDisplayPool() {};
+    // The displays are intentionally not terminated on exit: decoders may still be destroyed after the pool
+    ~VaapiDisplayPool() {};
+    VaapiDisplayPool(const VaapiDisplayPool&) = delete;
+    VaapiDisplayPool& operator=(const VaapiDisplayPool&) = delete;
+    PooledDisplay *FindDisplay(VADisplay va_display);
+
+    std::mutex mutex_;
+    std::map<std::string, PooledDisplay> displays_; // keyed by render node path
+};
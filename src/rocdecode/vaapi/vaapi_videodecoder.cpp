@@ -23,14 +23,17 @@ THE SOFTWARE.
 #include "vaapi_videodecoder.h"
 
 VaapiVideoDecoder::VaapiVideoDecoder(RocDecoderCreateInfo &decoder_create_info) : decoder_create_info_{decoder_create_info},
-    drm_fd_{-1}, va_display_{0}, va_config_attrib_{{}}, va_config_id_{0}, va_profile_ {VAProfileNone}, va_context_id_{0}, va_surface_ids_{{}},
-    supports_modifiers_{false}, pic_params_buf_id_{0}, iq_matrix_buf_id_{0}, num_slices_{0}, slice_data_buf_id_{0} {
+    va_display_{0}, va_config_attrib_{{}}, va_config_id_{0}, va_profile_ {VAProfileNone}, va_context_id_{0}, va_surface_ids_{{}},
+    surface_width_{0}, surface_height_{0}, supports_modifiers_{false}, reuse_data_buffers_{true}, pic_params_buf_id_{0}, iq_matrix_buf_id_{0}, num_slices_{0}, num_slice_params_bufs_{0},
+    multi_slice_params_buf_{false}, slice_params_buf_num_elements_{0}, slice_data_buf_id_{0}, slice_data_buf_size_{0} {
+    // Data buffer reuse is on by default; ROCDECODE_VA_BUFFER_REUSE=0 restores create/destroy per picture
+    char *buffer_reuse = std::getenv("ROCDECODE_VA_BUFFER_REUSE");
+    if (buffer_reuse != nullptr && std::atoi(buffer_reuse) == 0) {
+        reuse_data_buffers_ = false;
+    }
 };
 
 VaapiVideoDecoder::~VaapiVideoDecoder() {
-    if (drm_fd_ != -1) {
-        close(drm_fd_);
-    }
     if (va_display_) {
         rocDecStatus rocdec_status = ROCDEC_SUCCESS;
         rocdec_status = DestroyDataBuffers();
@@ -47,15 +50,8 @@ VaapiVideoDecoder::~VaapiVideoDecoder() {
             if (va_status != VA_STATUS_SUCCESS) {
                 ERR("vaDestroyContext failed");
             }
-        if (va_config_id_)
-            va_status = vaDestroyConfig(va_display_, va_config_id_);
-            if (va_status != VA_STATUS_SUCCESS) {
-                ERR("vaDestroyConfig failed");
-            }
-        va_status = vaTerminate(va_display_);
-        if (va_status != VA_STATUS_SUCCESS) {
-            ERR("vaTerminate failed");
-        }
+        // the config belongs to the display pool, which terminates the display with its last user
+        VaapiDisplayPool::GetInstance().ReleaseDisplay(va_display_);
     }
 }
 
@@ -70,34 +66,8 @@ rocDecStatus VaapiVideoDecoder::InitializeDecoder(std::string device_name, std::
         return ROCDEC_NOT_SUPPORTED;
     }
 
-    std::size_t pos = gcn_arch_name.find_first_of(":");
-    std::string gcn_arch_name_base = (pos != std::string::npos) ? gcn_arch_name.substr(0, pos) : gcn_arch_name;
-
-    std::vector<int> visible_devices;
-    GetVisibleDevices(visible_devices);
-
-    int offset = 0;
-    if (gcn_arch_name_base.compare("gfx942") == 0) {
-            std::vector<ComputePartition> current_compute_partitions;
-            GetCurrentComputePartition(current_compute_partitions);
-            if (current_compute_partitions.empty()) {
-                //if the current_compute_partitions is empty then the default SPX mode is assumed.
-                if (decoder_create_info_.device_id < visible_devices.size()) {
-                    offset = visible_devices[decoder_create_info_.device_id] * 7;
-                } else {
-                    offset = decoder_create_info_.device_id * 7;
-                }
-            } else {
-                GetDrmNodeOffset(device_name, decoder_create_info_.device_id, visible_devices, current_compute_partitions, offset);
-            }
-        }
-
-    std::string drm_node = "/dev/dri/renderD";
-    if (decoder_create_info_.device_id < visible_devices.size()) {
-        drm_node += std::to_string(128 + offset + visible_devices[decoder_create_info_.device_id]);
-    } else {
-        drm_node += std::to_string(128 + offset + decoder_create_info_.device_id);
-    }
+    // the render node mapping is discovered once per process
+    std::string drm_node = RocDecDeviceTopology::GetInstance().GetRenderNode(decoder_create_info_.device_id, device_name, gcn_arch_name);
     rocdec_status = InitVAAPI(drm_node);
     if (rocdec_status != ROCDEC_SUCCESS) {
         ERR("Failed to initilize the VAAPI.");
@@ -122,22 +92,40 @@ rocDecStatus VaapiVideoDecoder::InitializeDecoder(std::string device_name, std::
 }
 
 rocDecStatus VaapiVideoDecoder::InitVAAPI(std::string drm_node) {
-    drm_fd_ = open(drm_node.c_str(), O_RDWR);
-    if (drm_fd_ < 0) {
-        ERR("Failed to open drm node." + drm_node);
-        return ROCDEC_NOT_INITIALIZED;
-    }
-    va_display_ = vaGetDisplayDRM(drm_fd_);
-    if (!va_display_) {
-        ERR("Failed to create va_display.");
-        return ROCDEC_NOT_INITIALIZED;
-    }
-    vaSetInfoCallback(va_display_, NULL, NULL);
-    int major_version = 0, minor_version = 0;
-    CHECK_VAAPI(vaInitialize(va_display_, &major_version, &minor_version));
+    // decoders on the same render node share an initialized display
+    rocDecStatus rocdec_status = VaapiDisplayPool::GetInstance().AcquireDisplay(drm_node, va_display_);
+    if (rocdec_status != ROCDEC_SUCCESS) {
+        va_display_ = 0;
+        return rocdec_status;
+    }
+    multi_slice_params_buf_ = DriverSupportsMultiSliceParams();
     return ROCDEC_SUCCESS;
 }
 
+bool VaapiVideoDecoder::DriverSupportsMultiSliceParams() {
+    // ROCDECODE_VA_MULTI_SLICE_PARAMS=0/1 overrides the driver check
+    char *multi_slice_params = std::getenv("ROCDECODE_VA_MULTI_SLICE_PARAMS");
+    if (multi_slice_params != nullptr) {
+        return std::atoi(multi_slice_params) != 0;
+    }
+    // Mesa reads every element of a slice parameter buffer for all the codecs we support from 23.2 on. Older drivers
+    // only use the first element, so they get one buffer per slice.
+    const char *vendor = vaQueryVendorString(va_display_);
+    if (vendor == nullptr) {
+        return false;
+    }
+    std::string vendor_string(vendor);
+    size_t pos = vendor_string.find("Mesa Gallium driver ");
+    if (pos == std::string::npos) {
+        return false;
+    }
+    int mesa_major = 0, mesa_minor = 0;
+    if (sscanf(vendor_string.c_str() + pos + strlen("Mesa Gallium driver "), "%d.%d", &mesa_major, &mesa_minor) != 2) {
+        return false;
+    }
+    return mesa_major > 23 || (mesa_major == 23 && mesa_minor >= 2);
+}
+
 rocDecStatus VaapiVideoDecoder::CreateDecoderConfig() {
     switch (decoder_create_info_.codec_type) {
         case rocDecVideoCodec_HEVC:
@@ -168,19 +156,15 @@ rocDecStatus VaapiVideoDecoder::CreateDecoderConfig() {
             ERR("The codec type is not supported.");
             return ROCDEC_NOT_SUPPORTED;
     }
-    va_config_attrib_.type = VAConfigAttribRTFormat;
-    CHECK_VAAPI(vaGetConfigAttributes(va_display_, va_profile_, VAEntrypointVLD, &va_config_attrib_, 1));
-    CHECK_VAAPI(vaCreateConfig(va_display_, va_profile_, VAEntrypointVLD, &va_config_attrib_, 1, &va_config_id_));
-    unsigned int num_attribs = 0;
-    CHECK_VAAPI(vaQuerySurfaceAttributes(va_display_, va_config_id_, nullptr, &num_attribs));
-    std::vector<VASurfaceAttrib> attribs(num_attribs);
-    CHECK_VAAPI(vaQuerySurfaceAttributes(va_display_, va_config_id_, attribs.data(), &num_attribs));
-    for (auto attrib : attribs) {
-        if (attrib.type == VASurfaceAttribDRMFormatModifiers) {
-            supports_modifiers_ = true;
-            break;
-        }
+    // the config and the attribute queries are cached per display and profile
+    VaapiConfigInfo config_info;
+    rocDecStatus rocdec_status = VaapiDisplayPool::GetInstance().GetConfigInfo(va_display_, va_profile_, config_info);
+    if (rocdec_status != ROCDEC_SUCCESS) {
+        return rocdec_status;
     }
+    va_config_attrib_ = config_info.rt_format_attrib;
+    va_config_id_ = config_info.config_id;
+    supports_modifiers_ = config_info.supports_modifiers;
     return ROCDEC_SUCCESS;
 }
 
@@ -239,8 +223,11 @@ rocDecStatus VaapiVideoDecoder::CreateSurfaces() {
         surf_attrib.value.value.p = &modifier_list;
         surf_attribs.push_back(surf_attrib);
     }
-    CHECK_VAAPI(vaCreateSurfaces(va_display_, surface_format, decoder_create_info_.width,
-        decoder_create_info_.height, va_surface_ids_.data(), va_surface_ids_.size(), surf_attribs.data(), surf_attribs.size()));
+    // a reconfiguration within max_width x max_height decodes into the same surfaces
+    surface_width_ = std::max(decoder_create_info_.width, decoder_create_info_.max_width);
+    surface_height_ = std::max(decoder_create_info_.height, decoder_create_info_.max_height);
+    CHECK_VAAPI(vaCreateSurfaces(va_display_, surface_format, surface_width_,
+        surface_height_, va_surface_ids_.data(), va_surface_ids_.size(), surf_attribs.data(), surf_attribs.size()));
     return ROCDEC_SUCCESS;
 }
 
@@ -259,20 +246,104 @@ rocDecStatus VaapiVideoDecoder::DestroyDataBuffers() {
         CHECK_VAAPI(vaDestroyBuffer(va_display_, iq_matrix_buf_id_));
         iq_matrix_buf_id_ = 0;
     }
-    for (int i = 0; i < num_slices_; i++) {
+    for (int i = 0; i < num_slice_params_bufs_; i++) {
         if (slice_params_buf_id_[i]) {
             CHECK_VAAPI(vaDestroyBuffer(va_display_, slice_params_buf_id_[i]));
             slice_params_buf_id_[i] = 0;
         }
     }
+    num_slice_params_bufs_ = 0;
+    slice_params_buf_num_elements_ = 0;
     if (slice_data_buf_id_) {
         CHECK_VAAPI(vaDestroyBuffer(va_display_, slice_data_buf_id_));
         slice_data_buf_id_ = 0;
     }
+    slice_data_buf_size_ = 0;
+    return ROCDEC_SUCCESS;
+}
+
+rocDecStatus VaapiVideoDecoder::UploadDataBuffer(VABufferType buf_type, uint32_t size, void *data, VABufferID &buf_id) {
+    if (!buf_id) {
+        CHECK_VAAPI(vaCreateBuffer(va_display_, va_context_id_, buf_type, size, 1, data, &buf_id));
+        return ROCDEC_SUCCESS;
+    }
+    // The parameter buffer sizes are fixed per codec, so an existing buffer is refilled in place
+    void *buf_ptr = nullptr;
+    CHECK_VAAPI(vaMapBuffer(va_display_, buf_id, &buf_ptr));
+    memcpy(buf_ptr, data, size);
+    CHECK_VAAPI(vaUnmapBuffer(va_display_, buf_id));
+    return ROCDEC_SUCCESS;
+}
+
+rocDecStatus VaapiVideoDecoder::UploadSliceParams(uint32_t size, uint32_t num_elements, void *data) {
+    if (!multi_slice_params_buf_) {
+        // One buffer per slice
+        if (num_elements > slice_params_buf_id_.size()) {
+            slice_params_buf_id_.resize(num_elements, {0});
+        }
+        rocDecStatus rocdec_status;
+        for (int i = 0; i < num_elements; i++) {
+            if ((rocdec_status = UploadDataBuffer(VASliceParameterBufferType, size, data, slice_params_buf_id_[i])) != ROCDEC_SUCCESS) {
+                return rocdec_status;
+            }
+            data = (void*)((uint8_t*)data + size);
+        }
+        num_slice_params_bufs_ = std::max(num_slice_params_bufs_, num_elements);
+        return ROCDEC_SUCCESS;
+    }
+
+    // One buffer with an element per slice
+    if (num_elements == 0) {
+        return ROCDEC_SUCCESS;
+    }
+    if (!reuse_data_buffers_) {
+        CHECK_VAAPI(vaCreateBuffer(va_display_, va_context_id_, VASliceParameterBufferType, size, num_elements, data, &slice_params_buf_id_[0]));
+        num_slice_params_bufs_ = 1;
+        return ROCDEC_SUCCESS;
+    }
+    if (num_elements > slice_params_buf_num_elements_) {
+        if (slice_params_buf_id_[0]) {
+            CHECK_VAAPI(vaDestroyBuffer(va_display_, slice_params_buf_id_[0]));
+            slice_params_buf_id_[0] = 0;
+        }
+        slice_params_buf_num_elements_ = std::max(num_elements, static_cast<uint32_t>(INIT_SLICE_PARAM_LIST_NUM));
+        CHECK_VAAPI(vaCreateBuffer(va_display_, va_context_id_, VASliceParameterBufferType, size, slice_params_buf_num_elements_, nullptr, &slice_params_buf_id_[0]));
+        num_slice_params_bufs_ = 1;
+    }
+    // The driver walks num_elements entries, so trim the element count to the slice count of the picture
+    CHECK_VAAPI(vaBufferSetNumElements(va_display_, slice_params_buf_id_[0], num_elements));
+    void *buf_ptr = nullptr;
+    CHECK_VAAPI(vaMapBuffer(va_display_, slice_params_buf_id_[0], &buf_ptr));
+    memcpy(buf_ptr, data, size * num_elements);
+    CHECK_VAAPI(vaUnmapBuffer(va_display_, slice_params_buf_id_[0]));
+    return ROCDEC_SUCCESS;
+}
+
+rocDecStatus VaapiVideoDecoder::UploadSliceData(uint32_t size, void *data) {
+    if (!reuse_data_buffers_) {
+        CHECK_VAAPI(vaCreateBuffer(va_display_, va_context_id_, VASliceDataBufferType, size, 1, data, &slice_data_buf_id_));
+        return ROCDEC_SUCCESS;
+    }
+    if (size > slice_data_buf_size_) {
+        if (slice_data_buf_id_) {
+            CHECK_VAAPI(vaDestroyBuffer(va_display_, slice_data_buf_id_));
+            slice_data_buf_id_ = 0;
+        }
+        // Grow with 50% headroom so that the buffer settles at a high-water mark after a few large pictures
+        slice_data_buf_size_ = std::max(size + size / 2, static_cast<uint32_t>(MIN_SLICE_DATA_BUF_SIZE));
+        CHECK_VAAPI(vaCreateBuffer(va_display_, va_context_id_, VASliceDataBufferType, 1, slice_data_buf_size_, nullptr, &slice_data_buf_id_));
+    }
+    // The driver takes the bitstream size from the buffer size, so trim the element count to the picture size
+    CHECK_VAAPI(vaBufferSetNumElements(va_display_, slice_data_buf_id_, size));
+    void *buf_ptr = nullptr;
+    CHECK_VAAPI(vaMapBuffer(va_display_, slice_data_buf_id_, &buf_ptr));
+    memcpy(buf_ptr, data, size);
+    CHECK_VAAPI(vaUnmapBuffer(va_display_, slice_data_buf_id_));
     return ROCDEC_SUCCESS;
 }
 
 rocDecStatus VaapiVideoDecoder::SubmitDecode(RocdecPicParams *pPicParams) {
+    ROCDEC_TRACE_SCOPE("VaapiVideoDecoder::SubmitDecode", pPicParams->curr_pic_idx);
     void *pic_params_ptr, *iq_matrix_ptr, *slice_params_ptr;
     uint32_t pic_params_size, iq_matrix_size, slice_params_size;
     bool scaling_list_enabled = false;
@@ -422,35 +493,41 @@ rocDecStatus VaapiVideoDecoder::SubmitDecode(RocdecPicParams *pPicParams) {
         }
     }
 
-    // Destroy the data buffers of the previous frame
-    rocDecStatus rocdec_status = DestroyDataBuffers();
-    if (rocdec_status != ROCDEC_SUCCESS) {
-        ERR("Failed to destroy VAAPI buffer.");
-        return rocdec_status;
+    // Destroy the data buffers of the previous frame, unless they are reused
+    rocDecStatus rocdec_status;
+    if (!reuse_data_buffers_) {
+        rocdec_status = DestroyDataBuffers();
+        if (rocdec_status != ROCDEC_SUCCESS) {
+            ERR("Failed to destroy VAAPI buffer.");
+            return rocdec_status;
+        }
     }
 
-    CHECK_VAAPI(vaCreateBuffer(va_display_, va_context_id_, VAPictureParameterBufferType, pic_params_size, 1, pic_params_ptr, &pic_params_buf_id_));
+    if ((rocdec_status = UploadDataBuffer(VAPictureParameterBufferType, pic_params_size, pic_params_ptr, pic_params_buf_id_)) != ROCDEC_SUCCESS) {
+        return rocdec_status;
+    }
     if (scaling_list_enabled) {
-        CHECK_VAAPI(vaCreateBuffer(va_display_, va_context_id_, VAIQMatrixBufferType, iq_matrix_size, 1, iq_matrix_ptr, &iq_matrix_buf_id_));
+        if ((rocdec_status = UploadDataBuffer(VAIQMatrixBufferType, iq_matrix_size, iq_matrix_ptr, iq_matrix_buf_id_)) != ROCDEC_SUCCESS) {
+            return rocdec_status;
+        }
     }
-    // Resize if needed
+    // Slice parameters, or AV1 tile parameters
     num_slices_ = pPicParams->num_slices;
-    if (num_slices_ > slice_params_buf_id_.size()) {
-        slice_params_buf_id_.resize(num_slices_, {0});
+    if ((rocdec_status = UploadSliceParams(slice_params_size, num_slices_, slice_params_ptr)) != ROCDEC_SUCCESS) {
+        return rocdec_status;
     }
-    for (int i = 0; i < num_slices_; i++) {
-        CHECK_VAAPI(vaCreateBuffer(va_display_, va_context_id_, VASliceParameterBufferType, slice_params_size, 1, slice_params_ptr, &slice_params_buf_id_[i]));
-        slice_params_ptr = (void*)((uint8_t*)slice_params_ptr + slice_params_size);
+    if ((rocdec_status = UploadSliceData(pPicParams->bitstream_data_len, (void*)pPicParams->bitstream_data)) != ROCDEC_SUCCESS) {
+        return rocdec_status;
     }
-    CHECK_VAAPI(vaCreateBuffer(va_display_, va_context_id_, VASliceDataBufferType, pPicParams->bitstream_data_len, 1, (void*)pPicParams->bitstream_data, &slice_data_buf_id_));
 
     // Sumbmit buffers to VAAPI driver
+    ROCDEC_TRACE_SCOPE("vaRenderPicture", pPicParams->curr_pic_idx);
     CHECK_VAAPI(vaBeginPicture(va_display_, va_context_id_, curr_surface_id));
     CHECK_VAAPI(vaRenderPicture(va_display_, va_context_id_, &pic_params_buf_id_, 1));
     if (scaling_list_enabled) {
         CHECK_VAAPI(vaRenderPicture(va_display_, va_context_id_, &iq_matrix_buf_id_, 1));
     }
-    CHECK_VAAPI(vaRenderPicture(va_display_, va_context_id_, slice_params_buf_id_.data(), num_slices_));
+    CHECK_VAAPI(vaRenderPicture(va_display_, va_context_id_, slice_params_buf_id_.data(), multi_slice_params_buf_ ? std::min(num_slices_, 1u) : num_slices_));
     CHECK_VAAPI(vaRenderPicture(va_display_, va_context_id_, &slice_data_buf_id_, 1));
     CHECK_VAAPI(vaEndPicture(va_display_, va_context_id_));
 
@@ -480,6 +557,7 @@ rocDecStatus VaapiVideoDecoder::GetDecodeStatus(int pic_idx, RocdecDecodeStatus
 }
 
 rocDecStatus VaapiVideoDecoder::ExportSurface(int pic_idx, VADRMPRIMESurfaceDescriptor &va_drm_prime_surface_desc) {
+    ROCDEC_TRACE_SCOPE("vaExportSurfaceHandle", pic_idx);
     if (pic_idx >= va_surface_ids_.size()) {
         return ROCDEC_INVALID_PARAMETER;
     }
@@ -500,20 +578,32 @@ rocDecStatus VaapiVideoDecoder::ReconfigureDecoder(RocdecReconfigureDecoderInfo
         ERR("VAAPI decoder has not been initialized but reconfiguration of the decoder has been requested.");
         return ROCDEC_NOT_SUPPORTED;
     }
-    CHECK_VAAPI(vaDestroySurfaces(va_display_, va_surface_ids_.data(), va_surface_ids_.size()));
+    // The data buffers belong to the context, so release them before it is destroyed
+    rocDecStatus rocdec_status = DestroyDataBuffers();
+    if (rocdec_status != ROCDEC_SUCCESS) {
+        ERR("Failed to destroy VAAPI buffer during the decoder reconfiguration.");
+        return rocdec_status;
+    }
+    // Only the context depends on the coded size when the surfaces are large enough, so they are kept
+    bool keep_surfaces = CanReconfigureInPlace(*reconfig_params);
+    if (!keep_surfaces) {
+        CHECK_VAAPI(vaDestroySurfaces(va_display_, va_surface_ids_.data(), va_surface_ids_.size()));
+    }
     CHECK_VAAPI(vaDestroyContext(va_display_, va_context_id_));
 
-    va_surface_ids_.clear();
     decoder_create_info_.width = reconfig_params->width;
     decoder_create_info_.height = reconfig_params->height;
     decoder_create_info_.num_decode_surfaces = reconfig_params->num_decode_surfaces;
     decoder_create_info_.target_height = reconfig_params->target_height;
     decoder_create_info_.target_width = reconfig_params->target_width;
 
-    rocDecStatus rocdec_status = CreateSurfaces();
-    if (rocdec_status != ROCDEC_SUCCESS) {
-        ERR("Failed to create VAAPI surfaces during the decoder reconfiguration.");
-        return rocdec_status;
+    if (!keep_surfaces) {
+        va_surface_ids_.clear();
+        rocdec_status = CreateSurfaces();
+        if (rocdec_status != ROCDEC_SUCCESS) {
+            ERR("Failed to create VAAPI surfaces during the decoder reconfiguration.");
+            return rocdec_status;
+        }
     }
     rocdec_status = CreateContext();
     if (rocdec_status != ROCDEC_SUCCESS) {
@@ -523,6 +613,26 @@ rocDecStatus VaapiVideoDecoder::ReconfigureDecoder(RocdecReconfigureDecoderInfo
     return rocdec_status;
 }
 
+bool VaapiVideoDecoder::CanReconfigureInPlace(const RocdecReconfigureDecoderInfo &reconfig_params) {
+    return reconfig_params.num_decode_surfaces == va_surface_ids_.size() &&
+           reconfig_params.width <= surface_width_ && reconfig_params.height <= surface_height_;
+}
+
+uint64_t VaapiVideoDecoder::GetSurfaceMemoryUsage() {
+    // VA-API does not report the allocation size of a surface; estimate it from the linear layout the driver uses
+    uint64_t bytes_per_sample = decoder_create_info_.bit_depth_minus_8 > 0 ? 2 : 1;
+    uint64_t pitch = (surface_width_ * bytes_per_sample + 255) & ~255ull;
+    uint64_t luma_lines = (surface_height_ + 15) & ~15u;
+    uint64_t chroma_lines;
+    switch (decoder_create_info_.chroma_format) {
+        case rocDecVideoChromaFormat_Monochrome: chroma_lines = 0; break;
+        case rocDecVideoChromaFormat_420: chroma_lines = luma_lines / 2; break;
+        case rocDecVideoChromaFormat_422: chroma_lines = luma_lines; break;
+        default: chroma_lines = 2 * luma_lines; break;
+    }
+    return pitch * (luma_lines + chroma_lines) * va_surface_ids_.size();
+}
+
 rocDecStatus VaapiVideoDecoder::SyncSurface(int pic_idx) {
     if (pic_idx >= va_surface_ids_.size()) {
         return ROCDEC_INVALID_PARAMETER;
@@ -530,114 +640,8 @@ rocDecStatus VaapiVideoDecoder::SyncSurface(int pic_idx) {
     VASurfaceStatus surface_status;
     CHECK_VAAPI(vaQuerySurfaceStatus(va_display_, va_surface_ids_[pic_idx], &surface_status));
     if (surface_status != VASurfaceReady) {
+        ROCDEC_TRACE_SCOPE("vaSyncSurface", pic_idx);
         CHECK_VAAPI(vaSyncSurface(va_display_, va_surface_ids_[pic_idx]));
     }
     return ROCDEC_SUCCESS;
 }
-
-void VaapiVideoDecoder::GetVisibleDevices(std::vector<int>& visible_devices_vetor) {
-    // First, check if the ROCR_VISIBLE_DEVICES environment variable is present
-    char *visible_devices = std::getenv("ROCR_VISIBLE_DEVICES");
-    // If ROCR_VISIBLE_DEVICES is not present, check if HIP_VISIBLE_DEVICES is present
-    if (visible_devices == nullptr) {
-        visible_devices = std::getenv("HIP_VISIBLE_DEVICES");
-    }
-    if (visible_devices != nullptr) {
-        char *token = std::strtok(visible_devices,",");
-        while (token != nullptr) {
-            visible_devices_vetor.push_back(std::atoi(token));
-            token = std::strtok(nullptr,",");
-        }
-    std::sort(visible_devices_vetor.begin(), visible_devices_vetor.end());
-    }
-}
-
-void VaapiVideoDecoder::GetCurrentComputePartition(std::vector<ComputePartition> &current_compute_partitions) {
-    std::string search_path = "/sys/devices/";
-    std::string partition_file = "current_compute_partition";
-    std::error_code ec;
-    if (fs::exists(search_path)) {
-        for (auto it = fs::recursive_directory_iterator(search_path, fs::directory_options::skip_permission_denied); it != fs::recursive_directory_iterator(); ) {
-            try {
-                if (it->path().filename() == partition_file) {
-                    std::ifstream file(it->path());
-                    if (file.is_open()) {
-                        std::string partition;
-                        std::getline(file, partition);
-                        if (partition.compare("SPX") == 0 || partition.compare("spx") == 0) {
-                            current_compute_partitions.push_back(kSpx);
-                        } else if (partition.compare("DPX") == 0 || partition.compare("dpx") == 0) {
-                            current_compute_partitions.push_back(kDpx);
-                        } else if (partition.compare("TPX") == 0 || partition.compare("tpx") == 0) {
-                            current_compute_partitions.push_back(kTpx);
-                        } else if (partition.compare("QPX") == 0 || partition.compare("qpx") == 0) {
-                            current_compute_partitions.push_back(kQpx);
-                        } else if (partition.compare("CPX") == 0 || partition.compare("cpx") == 0) {
-                            current_compute_partitions.push_back(kCpx);
-                        }
-                        file.close();
-                    }
-                }
-                ++it;
-            } catch (fs::filesystem_error& e) {
-                it.increment(ec);
-            }
-        }
-    }
-}
-
-void VaapiVideoDecoder::GetDrmNodeOffset(std::string device_name, uint8_t device_id, std::vector<int>& visible_devices,
-                                                   std::vector<ComputePartition> &current_compute_partitions, int &offset) {
-
-    if (!current_compute_partitions.empty()) {
-        switch (current_compute_partitions[0]) {
-            case kSpx:
-                if (device_id < visible_devices.size()) {
-                    offset = visible_devices[device_id] * 7;
-                } else {
-                    offset = device_id * 7;
-                }
-                break;
-            case kDpx:
-                if (device_id < visible_devices.size()) {
-                    offset = (visible_devices[device_id] / 2) * 6;
-                } else {
-                    offset = (device_id / 2) * 6;
-                }
-                break;
-            case kTpx:
-                // Please note that although there are only 6 XCCs per socket on MI300A,
-                // there are two dummy render nodes added by the driver.
-                // This needs to be taken into account when creating drm_node on each socket in TPX mode.
-                if (device_id < visible_devices.size()) {
-                    offset = (visible_devices[device_id] / 3) * 5;
-                } else {
-                    offset = (device_id / 3) * 5;
-                }
-                break;
-            case kQpx:
-                if (device_id < visible_devices.size()) {
-                    offset = (visible_devices[device_id] / 4) * 4;
-                } else {
-                    offset = (device_id / 4) * 4;
-                }
-                break;
-            case kCpx:
-                // Please note that both MI300A and MI300X have the same gfx_arch_name which is
-                // gfx942. Therefore we cannot use the gfx942 to identify MI300A.
-                // instead use the device name and look for MI300A
-                // Also, as explained aboe in the TPX mode section, we need to be taken into account
-                // the extra two dummy nodes when creating drm_node on each socket in CPX mode as well.
-                std::string mi300a = "MI300A";
-                size_t found_mi300a = device_name.find(mi300a);
-                if (found_mi300a != std::string::npos) {
-                    if (device_id < visible_devices.size()) {
-                        offset = (visible_devices[device_id] / 6) * 2;
-                    } else {
-                        offset = (device_id / 6) * 2;
-                    }
-                }
-                break;
-        }
-    }
-}
\ No newline at end of file
@@ -29,18 +29,16 @@ THE SOFTWARE.
 #include <fcntl.h>
 #include <unistd.h>
 #include <cstring>
-#if __cplusplus >= 201703L && __has_include(<filesystem>)
-    #include <filesystem>
-    namespace fs = std::filesystem;
-#else
-    #include <experimental/filesystem>
-    namespace fs = std::experimental::filesystem;
-#endif
+#include <algorithm>
 #include <va/va.h>
 #include <va/va_drm.h>
 #include <va/va_drmcommon.h>
 #include "../roc_decoder_caps.h"
+#include "../roc_decoder_backend.h"
+#include "../roc_device_topology.h"
+#include "vaapi_display_pool.h"
 #include "../../commons.h"
+#include "../../tracer/roc_pipeline_tracer.h"
 #include "../../../api/rocdecode.h"
 
 #define CHECK_VAAPI(call) {\
@@ -52,50 +50,50 @@ THE SOFTWARE.
 }
 
 #define INIT_SLICE_PARAM_LIST_NUM 16 // initial slice parameter buffer list size
+#define MIN_SLICE_DATA_BUF_SIZE (256 * 1024) // minimum slice data buffer allocation when buffers are reused
 
-typedef enum {
-    kSpx = 0, // Single Partition Accelerator
-    kDpx = 1, // Dual Partition Accelerator
-    kTpx = 2, // Triple Partition Accelerator
-    kQpx = 3, // Quad Partition Accelerator
-    kCpx = 4, // Core Partition Accelerator
-} ComputePartition;
-
-class VaapiVideoDecoder {
+class VaapiVideoDecoder : public RocDecoderBackend {
 public:
     VaapiVideoDecoder(RocDecoderCreateInfo &decoder_create_info);
     ~VaapiVideoDecoder();
-    rocDecStatus InitializeDecoder(std::string device_name, std::string gcn_arch_name);
-    rocDecStatus SubmitDecode(RocdecPicParams *pPicParams);
-    rocDecStatus GetDecodeStatus(int pic_idx, RocdecDecodeStatus* decode_status);
-    rocDecStatus ExportSurface(int pic_idx, VADRMPRIMESurfaceDescriptor &va_drm_prime_surface_desc);
-    rocDecStatus SyncSurface(int pic_idx);
-    rocDecStatus ReconfigureDecoder(RocdecReconfigureDecoderInfo *reconfig_params);
+    rocDecStatus InitializeDecoder(std::string device_name, std::string gcn_arch_name) override;
+    rocDecStatus SubmitDecode(RocdecPicParams *pPicParams) override;
+    rocDecStatus GetDecodeStatus(int pic_idx, RocdecDecodeStatus* decode_status) override;
+    rocDecStatus ExportSurface(int pic_idx, VADRMPRIMESurfaceDescriptor &va_drm_prime_surface_desc) override;
+    rocDecStatus SyncSurface(int pic_idx) override;
+    rocDecStatus ReconfigureDecoder(RocdecReconfigureDecoderInfo *reconfig_params) override;
+    bool CanReconfigureInPlace(const RocdecReconfigureDecoderInfo &reconfig_params) override;
+    uint64_t GetSurfaceMemoryUsage() override;
 private:
     RocDecoderCreateInfo decoder_create_info_;
-    int drm_fd_;
-    VADisplay va_display_;
+    VADisplay va_display_; // shared with the other decoders on the render node through VaapiDisplayPool
     VAConfigAttrib va_config_attrib_;
-    VAConfigID va_config_id_;
+    VAConfigID va_config_id_; // owned by VaapiDisplayPool
     VAProfile va_profile_;
     VAContextID va_context_id_;
     std::vector<VASurfaceID> va_surface_ids_;
+    uint32_t surface_width_; // allocated surface size: max_width x max_height, so that smaller sizes reuse the surfaces
+    uint32_t surface_height_;
     bool supports_modifiers_;
 
+    bool reuse_data_buffers_; // keep the data buffers across pictures and refill them with vaMapBuffer
     VABufferID pic_params_buf_id_;
     VABufferID iq_matrix_buf_id_;
     std::vector<VABufferID> slice_params_buf_id_ = std::vector<VABufferID>(INIT_SLICE_PARAM_LIST_NUM, 0);
     uint32_t num_slices_;
+    uint32_t num_slice_params_bufs_; // number of allocated slice parameter buffers (high-water mark)
+    bool multi_slice_params_buf_; // submit the slice (AV1 tile) parameters of a picture as one multi-element buffer
+    uint32_t slice_params_buf_num_elements_; // allocated elements of the multi-element slice parameter buffer
     VABufferID slice_data_buf_id_;
-    uint32_t slice_data_buf_size_;
+    uint32_t slice_data_buf_size_; // allocated slice data buffer size in bytes (high-water mark)
 
     rocDecStatus InitVAAPI(std::string drm_node);
     rocDecStatus CreateDecoderConfig();
     rocDecStatus CreateSurfaces();
     rocDecStatus CreateContext();
     rocDecStatus DestroyDataBuffers();
-    void GetVisibleDevices(std::vector<int>& visible_devices);
-    void GetCurrentComputePartition(std::vector<ComputePartition> &currnet_compute_partitions);
-    void GetDrmNodeOffset(std::string device_name, uint8_t device_id, std::vector<int>& visible_devices,
-                                    std::vector<ComputePartition> &current_compute_partitions, int &offset);
+    rocDecStatus UploadDataBuffer(VABufferType buf_type, uint32_t size, void *data, VABufferID &buf_id);
+    rocDecStatus UploadSliceParams(uint32_t size, uint32_t num_elements, void *data);
+    rocDecStatus UploadSliceData(uint32_t size, void *data);
+    bool DriverSupportsMultiSliceParams();
 };
\ No newline at end of file
@@ -0,0 +1,153 @@
+/*
+Copyright (c) 2023 - 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include "../commons.h"
+#include "roc_pipeline_tracer.h"
+
+#define DEFAULT_TRACE_MAX_EVENTS (1 << 20)
+
+// event names come from the application through rocDecTraceEvent, so they are escaped as JSON strings
+static void WriteJsonString(FILE *fp, const char *str) {
+    fputc('"', fp);
+    for (const unsigned char *c = reinterpret_cast<const unsigned char *>(str); *c; c++) {
+        if (*c == '"' || *c == '\\') {
+            fputc('\\', fp);
+            fputc(*c, fp);
+        } else if (*c < 0x20) {
+            fprintf(fp, "\\u%04x", *c);
+        } else {
+            fputc(*c, fp);
+        }
+    }
+    fputc('"', fp);
+}
+
+static uint64_t TraceTimeNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+RocPipelineTracer::ThreadBuffer::~ThreadBuffer() {
+    TraceChunk *chunk = head.next.load();
+    while (chunk) {
+        TraceChunk *next = chunk->next.load();
+        delete chunk;
+        chunk = next;
+    }
+}
+
+RocPipelineTracer::RocPipelineTracer() : max_events_per_thread_{DEFAULT_TRACE_MAX_EVENTS}, start_time_ns_{TraceTimeNs()} {
+    char *trace = std::getenv("ROCDECODE_TRACE");
+    if (trace == nullptr || std::atoi(trace) == 0) {
+        return;
+    }
+    char *file_path = std::getenv("ROCDECODE_TRACE_FILE");
+    file_path_ = file_path ? file_path : "rocdecode_trace_" + TOSTR(getpid()) + ".json";
+    char *max_events = std::getenv("ROCDECODE_TRACE_MAX_EVENTS");
+    if (max_events != nullptr) {
+        max_events_per_thread_ = std::strtoull(max_events, nullptr, 10);
+    }
+    enabled_ = true;
+    std::atexit(&RocPipelineTracer::DumpAtExit);
+}
+
+void RocPipelineTracer::DumpAtExit() {
+    RocPipelineTracer &tracer = GetInstance();
+    if (tracer.enabled_) {
+        tracer.enabled_ = false;
+        tracer.Dump(nullptr);
+    }
+}
+
+RocPipelineTracer::ThreadBuffer *RocPipelineTracer::GetThreadBuffer() {
+    thread_local ThreadBuffer *thread_buffer = nullptr;
+    if (thread_buffer == nullptr) {
+        std::unique_ptr<ThreadBuffer> buffer = std::make_unique<ThreadBuffer>();
+        buffer->tid = static_cast<uint32_t>(syscall(SYS_gettid));
+        thread_buffer = buffer.get();
+        std::lock_guard<std::mutex> lock(mutex_);
+        thread_buffers_.push_back(std::move(buffer));
+    }
+    return thread_buffer;
+}
+
+void RocPipelineTracer::Record(const char *name, char phase, int pic_idx) {
+    if (!IsEnabled()) {
+        return;
+    }
+    ThreadBuffer *buffer = GetThreadBuffer();
+    if (buffer->num_events >= max_events_per_thread_) {
+        return;
+    }
+    TraceChunk *chunk = buffer->tail;
+    uint32_t count = chunk->count.load(std::memory_order_relaxed);
+    if (count == TraceChunk::kNumEvents) {
+        TraceChunk *new_chunk = new TraceChunk;
+        chunk->next.store(new_chunk, std::memory_order_release);
+        buffer->tail = chunk = new_chunk;
+        count = 0;
+    }
+    chunk->events[count] = {name, TraceTimeNs(), pic_idx, phase};
+    chunk->count.store(count + 1, std::memory_order_release);
+    buffer->num_events++;
+}
+
+bool RocPipelineTracer::Dump(const char *file_path) {
+    std::string path = file_path ? file_path : file_path_;
+    std::lock_guard<std::mutex> lock(mutex_);
+    FILE *fp = fopen(path.c_str(), "w");
+    if (fp == nullptr) {
+        ERR("Failed to open the trace file " + path);
+        return false;
+    }
+    int pid = getpid();
+    bool first = true;
+    fprintf(fp, "{\"traceEvents\":[\n");
+    for (auto &buffer : thread_buffers_) {
+        // the events published so far; the owner thread may keep appending meanwhile
+        for (TraceChunk *chunk = &buffer->head; chunk; chunk = chunk->next.load(std::memory_order_acquire)) {
+            uint32_t count = chunk->count.load(std::memory_order_acquire);
+            for (uint32_t i = 0; i < count; i++) {
+                const TraceEvent &event = chunk->events[i];
+                fprintf(fp, "%s{\"name\":", first ? "" : ",\n");
+                WriteJsonString(fp, event.name);
+                fprintf(fp, ",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":%d,\"tid\":%u", event.phase, (event.time_ns - start_time_ns_) / 1000.0,
+                        pid, buffer->tid);
+                if (event.phase == 'i') {
+                    fprintf(fp, ",\"s\":\"t\"");
+                }
+                if (event.pic_idx >= 0) {
+                    fprintf(fp, ",\"args\":{\"pic_idx\":%d}", event.pic_idx);
+                }
+                fprintf(fp, "}");
+                first = false;
+            }
+        }
+    }
+    fprintf(fp, "\n],\"displayTimeUnit\":\"ms\"}\n");
+    fclose(fp);
+    return true;
+}
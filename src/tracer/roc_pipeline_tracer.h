@@ -0,0 +1,115 @@
+/*
+Copyright (c) 2023 - 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/*! \brief Timeline tracer of the decode pipeline, dumped as Chrome trace JSON (chrome://tracing, ui.perfetto.dev).
+ *
+ * Tracing is compiled in and off unless ROCDECODE_TRACE=1. Every thread records begin/end events of the pipeline
+ * stages, tagged with the pic_idx, into its own chunked buffer: recording takes no lock and allocates only when a
+ * chunk of events is full. The events are written to ROCDECODE_TRACE_FILE (default rocdecode_trace_<pid>.json) at
+ * process exit from an atexit handler, or on demand with rocDecTraceDump. A thread stops recording after ROCDECODE_TRACE_MAX_EVENTS
+ * (default 1M) events.
+ */
+class RocPipelineTracer {
+public:
+    static RocPipelineTracer& GetInstance() {
+        // never destroyed, so that threads still recording at exit do not touch a destroyed tracer
+        static RocPipelineTracer *instance = new RocPipelineTracer();
+        return *instance;
+    }
+    bool IsEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+    /*! \brief Records an event of the calling thread.
+     * \param [in] name Event name; must stay valid until the trace is dumped, e.g. a string literal
+     * \param [in] phase 'B' (begin), 'E' (end) or 'i' (instant)
+     * \param [in] pic_idx Picture index the event belongs to, or -1
+     */
+    void Record(const char *name, char phase, int pic_idx);
+    /*! \brief Writes the events recorded so far to file_path, or to ROCDECODE_TRACE_FILE if file_path is null.
+     */
+    bool Dump(const char *file_path);
+
+private:
+    struct TraceEvent {
+        const char *name;
+        uint64_t time_ns;
+        int32_t pic_idx;
+        char phase;
+    };
+    struct TraceChunk {
+        static constexpr uint32_t kNumEvents = 4096;
+        TraceEvent events[kNumEvents];
+        std::atomic<uint32_t> count{0}; // published with release ordering after the event is written
+        std::atomic<TraceChunk *> next{nullptr};
+    };
+    // owned by the tracer and written by one thread only
+    struct ThreadBuffer {
+        uint32_t tid;
+        TraceChunk head;
+        TraceChunk *tail = &head;
+        size_t num_events = 0;
+        ~ThreadBuffer();
+    };
+    RocPipelineTracer();
+    ~RocPipelineTracer() = delete;
+    RocPipelineTracer(const RocPipelineTracer&) = delete;
+    RocPipelineTracer& operator=(const RocPipelineTracer&) = delete;
+    ThreadBuffer *GetThreadBuffer();
+    static void DumpAtExit();
+
+    std::atomic<bool> enabled_{false};
+    std::string file_path_;
+    size_t max_events_per_thread_;
+    uint64_t start_time_ns_;
+    std::mutex mutex_; // guards thread_buffers_ and the dump
+    std::vector<std::unique_ptr<ThreadBuffer>> thread_buffers_;
+};
+
+/*! \brief Records the begin event of a pipeline stage at construction and its end event at destruction.
+ */
+class RocPipelineTraceScope {
+public:
+    RocPipelineTraceScope(const char *name, int pic_idx) : name_{RocPipelineTracer::GetInstance().IsEnabled() ? name : nullptr}, pic_idx_{pic_idx} {
+        if (name_) {
+            RocPipelineTracer::GetInstance().Record(name_, 'B', pic_idx_);
+        }
+    }
+    ~RocPipelineTraceScope() {
+        if (name_) {
+            RocPipelineTracer::GetInstance().Record(name_, 'E', pic_idx_);
+        }
+    }
+private:
+    const char *name_;
+    int pic_idx_;
+};
+
+#define ROCDEC_TRACE_CONCAT_(a, b) a##b
+#define ROCDEC_TRACE_CONCAT(a, b) ROCDEC_TRACE_CONCAT_(a, b)
+#define ROCDEC_TRACE_SCOPE(name, pic_idx) RocPipelineTraceScope ROCDEC_TRACE_CONCAT(trace_scope_, __LINE__)(name, pic_idx)
@@ -0,0 +1,99 @@
+/*
+Copyright (c) 2023 - 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+// Checks the reuse and eviction of the decoder pool (ROCDECODE_DECODER_POOL_SIZE) on the null decoder backend. The host
+// memory surfaces of the null backend tell a reused session from a new one, and the process memory usage tells whether
+// a parked session is still alive. The test exits with a session parked, which the pool destroys at exit.
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include "rocdecode.h"
+#include "test_common.h"
+
+#define IDLE_TIMEOUT_MS 200
+
+static rocDecDecoderHandle CreatePooledDecoder(rocDecVideoCodec codec_type, uint32_t width, uint32_t height) {
+    RocDecoderCreateInfo create_info = {};
+    create_info.codec_type = codec_type;
+    create_info.width = width;
+    create_info.height = height;
+    create_info.max_width = 176;
+    create_info.max_height = 144;
+    return CreateNullDecoder(create_info);
+}
+
+static void *GetSurface(rocDecDecoderHandle decoder) {
+    void *planes[3] = {};
+    uint32_t pitches[3] = {};
+    RocdecProcParams proc_params = {};
+    TEST_CHECK_EQ(rocDecGetVideoFrame(decoder, 0, planes, pitches, &proc_params), ROCDEC_SUCCESS);
+    TEST_CHECK(planes[0] != nullptr);
+    return planes[0];
+}
+
+static uint64_t GetProcessSurfaceBytes() {
+    RocdecMemoryUsage memory_usage = {};
+    TEST_CHECK_EQ(rocDecGetMemoryUsage(&memory_usage), ROCDEC_SUCCESS);
+    return memory_usage.surface_bytes;
+}
+
+int main(int argc, char **argv) {
+    // read once, when the pool is first used
+    setenv("ROCDECODE_DECODER_POOL_SIZE", "1", 1);
+    setenv("ROCDECODE_DECODER_POOL_IDLE_MS", std::to_string(IDLE_TIMEOUT_MS).c_str(), 1);
+
+    // a destroyed decoder is parked with its surfaces, and a matching request gets it back
+    rocDecDecoderHandle decoder = CreatePooledDecoder(rocDecVideoCodec_HEVC, 176, 144);
+    void *hevc_surface = GetSurface(decoder);
+    uint64_t session_bytes = GetProcessSurfaceBytes();
+    TEST_CHECK(session_bytes > 0);
+    TEST_CHECK_EQ(rocDecDestroyDecoder(decoder), ROCDEC_SUCCESS);
+    TEST_CHECK_EQ(GetProcessSurfaceBytes(), session_bytes);
+    decoder = CreatePooledDecoder(rocDecVideoCodec_HEVC, 176, 144);
+    TEST_CHECK(GetSurface(decoder) == hevc_surface);
+    TEST_CHECK_EQ(GetProcessSurfaceBytes(), session_bytes);
+    TEST_CHECK_EQ(rocDecDestroyDecoder(decoder), ROCDEC_SUCCESS);
+
+    // another codec does not match the parked session; parking it evicts the HEVC one from the full pool
+    decoder = CreatePooledDecoder(rocDecVideoCodec_AV1, 176, 144);
+    void *av1_surface = GetSurface(decoder);
+    TEST_CHECK(av1_surface != hevc_surface);
+    TEST_CHECK_EQ(GetProcessSurfaceBytes(), 2 * session_bytes);
+    TEST_CHECK_EQ(rocDecDestroyDecoder(decoder), ROCDEC_SUCCESS);
+    TEST_CHECK_EQ(GetProcessSurfaceBytes(), session_bytes);
+
+    // a smaller coded size within the max dimensions reuses the parked session through a reconfiguration
+    decoder = CreatePooledDecoder(rocDecVideoCodec_AV1, 160, 128);
+    TEST_CHECK(GetSurface(decoder) == av1_surface);
+    TEST_CHECK_EQ(rocDecDestroyDecoder(decoder), ROCDEC_SUCCESS);
+
+    // an idle session is destroyed by the eviction thread
+    std::this_thread::sleep_for(std::chrono::milliseconds(4 * IDLE_TIMEOUT_MS));
+    TEST_CHECK_EQ(GetProcessSurfaceBytes(), 0);
+
+    decoder = CreatePooledDecoder(rocDecVideoCodec_HEVC, 176, 144);
+    TEST_CHECK_EQ(rocDecDestroyDecoder(decoder), ROCDEC_SUCCESS);
+    TEST_CHECK_EQ(GetProcessSurfaceBytes(), session_bytes);
+    printf("decoder pool test passed\n");
+    return 0;
+}
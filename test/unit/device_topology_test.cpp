@@ -0,0 +1,121 @@
+/*
+Copyright (c) 2023 - 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+// Checks the compute partition discovery and the render node mapping of RocDecDeviceTopology against fake sysfs trees:
+// the DRM class links to the PCI device directories, the fallback walk of devices/, and the visible device list
+
+#include <fstream>
+#include <string>
+#include <cstdlib>
+#include <filesystem>
+#include "roc_device_topology.h"
+#include "test_common.h"
+
+namespace fs = std::filesystem;
+
+#define DRI_DIR "/fake/dri"
+
+static void WriteFile(const fs::path &path, const std::string &content) {
+    fs::create_directories(path.parent_path());
+    std::ofstream file(path);
+    file << content << "\n";
+    TEST_CHECK(file.good());
+}
+
+// card0 and card1 link to two PCI devices in DPX mode; card0-DP-1 is a connector of card0 and must be skipped
+static void CheckDrmClassTree(const fs::path &root) {
+    fs::path sysfs = root / "class_tree";
+    fs::path gpu0 = sysfs / "devices" / "pci0000:00" / "0000:01:00.0";
+    fs::path gpu1 = sysfs / "devices" / "pci0000:00" / "0000:02:00.0";
+    WriteFile(gpu0 / "current_compute_partition", "DPX");
+    WriteFile(gpu1 / "current_compute_partition", "DPX");
+    fs::create_directories(sysfs / "class" / "drm" / "card0");
+    fs::create_directories(sysfs / "class" / "drm" / "card1");
+    fs::create_directories(sysfs / "class" / "drm" / "card0-DP-1");
+    fs::create_directory_symlink(gpu0, sysfs / "class" / "drm" / "card0" / "device");
+    fs::create_directory_symlink(gpu1, sysfs / "class" / "drm" / "card1" / "device");
+    fs::create_directory_symlink(gpu0, sysfs / "class" / "drm" / "card0-DP-1" / "device");
+
+    RocDecDeviceTopology &topology = RocDecDeviceTopology::GetInstance();
+    topology.SetSysfsRoot(sysfs.string(), DRI_DIR);
+    std::vector<ComputePartition> partitions = topology.GetComputePartitions();
+    TEST_CHECK_EQ(partitions.size(), 2);
+    TEST_CHECK_EQ(partitions[0], kDpx);
+    TEST_CHECK_EQ(partitions[1], kDpx);
+    // DPX: two partitions per socket with 6 render nodes between the sockets
+    TEST_CHECK(topology.GetRenderNode(0, "AMD Instinct MI300X", "gfx942:sramecc+:xnack-") == DRI_DIR "/renderD128");
+    TEST_CHECK(topology.GetRenderNode(3, "AMD Instinct MI300X", "gfx942:sramecc+:xnack-") == DRI_DIR "/renderD137");
+    // the partition mode only applies to gfx942
+    TEST_CHECK(topology.GetRenderNode(2, "AMD Radeon", "gfx1100") == DRI_DIR "/renderD130");
+    TEST_CHECK_EQ(topology.GetRenderNodeMap().size(), 3);
+}
+
+// without a DRM class directory the partition files are found by walking devices/
+static void CheckDevicesFallback(const fs::path &root) {
+    fs::path sysfs = root / "devices_tree";
+    WriteFile(sysfs / "devices" / "pci0000:40" / "0000:41:00.0" / "current_compute_partition", "cpx");
+
+    RocDecDeviceTopology &topology = RocDecDeviceTopology::GetInstance();
+    topology.SetSysfsRoot(sysfs.string(), DRI_DIR);
+    TEST_CHECK(topology.GetRenderNodeMap().empty());
+    std::vector<ComputePartition> partitions = topology.GetComputePartitions();
+    TEST_CHECK_EQ(partitions.size(), 1);
+    TEST_CHECK_EQ(partitions[0], kCpx);
+    // CPX: MI300A has 2 dummy render nodes per socket of 6 partitions, MI300X has none
+    TEST_CHECK(topology.GetRenderNode(7, "AMD Instinct MI300A", "gfx942:sramecc+:xnack-") == DRI_DIR "/renderD137");
+    topology.SetSysfsRoot(sysfs.string(), DRI_DIR);
+    TEST_CHECK(topology.GetRenderNode(7, "AMD Instinct MI300X", "gfx942:sramecc+:xnack-") == DRI_DIR "/renderD135");
+}
+
+// device ids index the sorted visible device list; without partition files SPX is assumed
+static void CheckVisibleDevices(const fs::path &root) {
+    fs::path sysfs = root / "empty_tree";
+    fs::create_directories(sysfs);
+    setenv("ROCR_VISIBLE_DEVICES", "5,4", 1);
+
+    RocDecDeviceTopology &topology = RocDecDeviceTopology::GetInstance();
+    topology.SetSysfsRoot(sysfs.string(), DRI_DIR);
+    std::vector<int> visible_devices = topology.GetVisibleDevices();
+    TEST_CHECK_EQ(visible_devices.size(), 2);
+    TEST_CHECK_EQ(visible_devices[0], 4);
+    TEST_CHECK_EQ(visible_devices[1], 5);
+    TEST_CHECK(topology.GetComputePartitions().empty());
+    TEST_CHECK(topology.GetRenderNode(1, "AMD Instinct MI300X", "gfx942") == DRI_DIR "/renderD168");
+    TEST_CHECK(topology.GetRenderNode(0, "AMD Radeon", "gfx1100") == DRI_DIR "/renderD132");
+    // ids past the visible list are used as they are
+    TEST_CHECK(topology.GetRenderNode(2, "AMD Radeon", "gfx1100") == DRI_DIR "/renderD130");
+    unsetenv("ROCR_VISIBLE_DEVICES");
+}
+
+int main(int argc, char **argv) {
+    unsetenv("ROCR_VISIBLE_DEVICES");
+    unsetenv("HIP_VISIBLE_DEVICES");
+    char root_template[] = "/tmp/rocdecode_topology_XXXXXX";
+    TEST_CHECK(mkdtemp(root_template) != nullptr);
+    fs::path root(root_template);
+    CheckDrmClassTree(root);
+    CheckDevicesFallback(root);
+    CheckVisibleDevices(root);
+    fs::remove_all(root);
+    printf("device topology test passed\n");
+    return 0;
+}
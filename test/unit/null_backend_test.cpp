@@ -0,0 +1,103 @@
+/*
+Copyright (c) 2023 - 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+// Checks the decode status and timing of the null decoder backend, with and without ROCDECODE_NULL_DECODE_DELAY_US
+
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include "rocdecode.h"
+#include "test_common.h"
+
+#define NUM_SURFACES 4  // the number of surfaces CreateNullDecoder() allocates by default
+#define DECODE_DELAY_US 50000
+
+static void DecodeInto(rocDecDecoderHandle decoder, int pic_idx) {
+    RocdecPicParams pic_params = {};
+    uint8_t bitstream[16] = {0, 0, 1};
+    pic_params.curr_pic_idx = pic_idx;
+    pic_params.bitstream_data = bitstream;
+    pic_params.bitstream_data_len = sizeof(bitstream);
+    TEST_CHECK_EQ(rocDecDecodeFrame(decoder, &pic_params), ROCDEC_SUCCESS);
+}
+
+static void CheckImmediateCompletion() {
+    unsetenv("ROCDECODE_NULL_DECODE_DELAY_US");
+    rocDecDecoderHandle decoder = CreateNullDecoder();
+    for (int pic_idx = 0; pic_idx < NUM_SURFACES; pic_idx++) {
+        DecodeInto(decoder, pic_idx);
+        TEST_CHECK_EQ(GetStatus(decoder, pic_idx), rocDecodeStatus_Success);
+    }
+
+    // the surfaces are host memory with the VA-API surface layout: 256-byte aligned pitch, chroma after 16-line aligned luma
+    void *planes[3] = {};
+    uint32_t pitches[3] = {};
+    RocdecProcParams proc_params = {};
+    TEST_CHECK_EQ(rocDecGetVideoFrame(decoder, 1, planes, pitches, &proc_params), ROCDEC_SUCCESS);
+    TEST_CHECK(planes[0] != nullptr && planes[1] != nullptr);
+    TEST_CHECK_EQ(pitches[0], 256);
+    TEST_CHECK_EQ(static_cast<uint8_t *>(planes[1]) - static_cast<uint8_t *>(planes[0]), 256 * 144);
+    memset(planes[0], 0x80, pitches[0] * 144);
+
+    // out-of-range surfaces are rejected
+    RocdecPicParams pic_params = {};
+    pic_params.curr_pic_idx = NUM_SURFACES;
+    TEST_CHECK_EQ(rocDecDecodeFrame(decoder, &pic_params), ROCDEC_INVALID_PARAMETER);
+    RocdecDecodeStatus decode_status = {};
+    TEST_CHECK_EQ(rocDecGetDecodeStatus(decoder, NUM_SURFACES, &decode_status), ROCDEC_INVALID_PARAMETER);
+    TEST_CHECK_EQ(rocDecDestroyDecoder(decoder), ROCDEC_SUCCESS);
+}
+
+static void CheckDelayedCompletion() {
+    setenv("ROCDECODE_NULL_DECODE_DELAY_US", std::to_string(DECODE_DELAY_US).c_str(), 1);
+    rocDecDecoderHandle decoder = CreateNullDecoder();
+
+    // a picture is in progress until the delay has passed, and other surfaces are not affected
+    auto submit_time = std::chrono::steady_clock::now();
+    DecodeInto(decoder, 2);
+    TEST_CHECK_EQ(GetStatus(decoder, 2), rocDecodeStatus_InProgress);
+    TEST_CHECK_EQ(GetStatus(decoder, 3), rocDecodeStatus_Success);
+
+    // rocDecGetVideoFrame waits for the decode to complete
+    void *planes[3] = {};
+    uint32_t pitches[3] = {};
+    RocdecProcParams proc_params = {};
+    TEST_CHECK_EQ(rocDecGetVideoFrame(decoder, 2, planes, pitches, &proc_params), ROCDEC_SUCCESS);
+    auto elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - submit_time).count();
+    TEST_CHECK(elapsed_us >= DECODE_DELAY_US);
+    TEST_CHECK_EQ(GetStatus(decoder, 2), rocDecodeStatus_Success);
+
+    // the status turns to success by itself once the delay has passed
+    DecodeInto(decoder, 0);
+    TEST_CHECK_EQ(GetStatus(decoder, 0), rocDecodeStatus_InProgress);
+    std::this_thread::sleep_for(std::chrono::microseconds(DECODE_DELAY_US));
+    TEST_CHECK_EQ(GetStatus(decoder, 0), rocDecodeStatus_Success);
+    TEST_CHECK_EQ(rocDecDestroyDecoder(decoder), ROCDEC_SUCCESS);
+}
+
+int main(int argc, char **argv) {
+    CheckImmediateCompletion();
+    CheckDelayedCompletion();
+    printf("null backend test passed\n");
+    return 0;
+}
@@ -0,0 +1,190 @@
+/*
+Copyright (c) 2023 - 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+// Checks that a parser in event mode returns the same sequence, decode and display events, in the same order, as the
+// callbacks of a parser in callback mode, also when the events are fetched one by one
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include "rocparser.h"
+#include "roc_bitstream_reader.h"
+#include "test_common.h"
+
+#define NUM_REPEATS 4
+
+struct ParserEventRecord {
+    rocDecParserEventType event_type;
+    int pic_idx;
+    RocdecTimeStamp pts;
+    uint32_t num_slices;
+    uint32_t bitstream_data_len;
+    bool operator==(const ParserEventRecord &other) const {
+        return event_type == other.event_type && pic_idx == other.pic_idx && pts == other.pts && num_slices == other.num_slices &&
+               bitstream_data_len == other.bitstream_data_len;
+    }
+};
+
+static std::vector<ParserEventRecord> callback_events;
+
+static int ROCDECAPI SequenceCallback(void *, RocdecVideoFormat *video_format) {
+    callback_events.push_back({rocDecParserEvent_SequenceChange, -1, 0, video_format->min_num_decode_surfaces, 0});
+    return 1;
+}
+
+static int ROCDECAPI DecodeCallback(void *, RocdecPicParams *pic_params) {
+    callback_events.push_back({rocDecParserEvent_DecodePicture, pic_params->curr_pic_idx, 0, pic_params->num_slices, pic_params->bitstream_data_len});
+    return 1;
+}
+
+static int ROCDECAPI DisplayCallback(void *, RocdecParserDispInfo *disp_info) {
+    callback_events.push_back({rocDecParserEvent_DisplayPicture, disp_info->picture_index, disp_info->pts, 0, 0});
+    return 1;
+}
+
+static ParserEventRecord RecordEvent(RocdecVideoParser parser, const RocdecParserEvent &event) {
+    switch (event.event_type) {
+        case rocDecParserEvent_SequenceChange:
+            return {event.event_type, -1, 0, event.video_format->min_num_decode_surfaces, 0};
+        case rocDecParserEvent_DecodePicture: {
+            ParserEventRecord record = {event.event_type, event.pic_params->curr_pic_idx, 0, event.pic_params->num_slices,
+                                        event.pic_params->bitstream_data_len};
+            TEST_CHECK_EQ(rocDecParserReleasePicParams(parser, event.pic_params), ROCDEC_SUCCESS);
+            return record;
+        }
+        default:
+            return {event.event_type, event.disp_info.picture_index, event.disp_info.pts, 0, 0};
+    }
+}
+
+static std::vector<std::vector<uint8_t>> ReadPictures(const char *file_path) {
+    std::vector<std::vector<uint8_t>> pictures;
+    RocdecBitstreamReader bs_reader = nullptr;
+    TEST_CHECK_EQ(rocDecCreateBitstreamReader(&bs_reader, file_path), ROCDEC_SUCCESS);
+    uint8_t *pic_data;
+    int pic_size;
+    int64_t pts;
+    while (rocDecGetBitstreamPicData(bs_reader, &pic_data, &pic_size, &pts) == ROCDEC_SUCCESS && pic_size > 0) {
+        pictures.emplace_back(pic_data, pic_data + pic_size);
+    }
+    rocDecDestroyBitstreamReader(bs_reader);
+    return pictures;
+}
+
+static RocdecParserParams GetParserParams() {
+    RocdecParserParams parser_params = {};
+    parser_params.codec_type = rocDecVideoCodec_HEVC;
+    parser_params.max_num_decode_surfaces = 1;
+    parser_params.max_display_delay = 1;
+    return parser_params;
+}
+
+template <typename ParseFunc>
+static void ParsePictures(const std::vector<std::vector<uint8_t>> &pictures, ParseFunc parse) {
+    int64_t pts = 0;
+    for (int i = 0; i < NUM_REPEATS; i++) {
+        for (auto &picture : pictures) {
+            RocdecSourceDataPacket packet = {};
+            packet.payload = picture.data();
+            packet.payload_size = static_cast<uint32_t>(picture.size());
+            packet.pts = pts++;
+            packet.flags = ROCDEC_PKT_TIMESTAMP;
+            parse(&packet);
+        }
+    }
+    RocdecSourceDataPacket packet = {};
+    packet.flags = ROCDEC_PKT_ENDOFSTREAM;
+    parse(&packet);
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <HEVC elementary stream>\n", argv[0]);
+        return 1;
+    }
+    std::vector<std::vector<uint8_t>> pictures = ReadPictures(argv[1]);
+    TEST_CHECK(!pictures.empty());
+
+    // callback mode
+    RocdecParserParams parser_params = GetParserParams();
+    parser_params.pfn_sequence_callback = SequenceCallback;
+    parser_params.pfn_decode_picture = DecodeCallback;
+    parser_params.pfn_display_picture = DisplayCallback;
+    RocdecVideoParser parser = nullptr;
+    TEST_CHECK_EQ(rocDecCreateVideoParser(&parser, &parser_params), ROCDEC_SUCCESS);
+    ParsePictures(pictures, [&](RocdecSourceDataPacket *packet) {
+        TEST_CHECK_EQ(rocDecParseVideoData(parser, packet), ROCDEC_SUCCESS);
+    });
+    TEST_CHECK_EQ(rocDecDestroyVideoParser(parser), ROCDEC_SUCCESS);
+
+    // event mode, fetching one event per call so that most events are carried over to the following calls
+    std::vector<ParserEventRecord> events;
+    parser_params = GetParserParams();
+    TEST_CHECK_EQ(rocDecCreateVideoParser(&parser, &parser_params), ROCDEC_SUCCESS);
+    RocdecSourceDataPacket callback_packet = {};
+    TEST_CHECK_EQ(rocDecParseVideoData(parser, &callback_packet), ROCDEC_INVALID_PARAMETER);
+    ParsePictures(pictures, [&](RocdecSourceDataPacket *packet) {
+        RocdecParserEvent event;
+        uint32_t num_events = 0;
+        TEST_CHECK_EQ(rocDecParseVideoDataEx(parser, packet, &event, 1, &num_events), ROCDEC_SUCCESS);
+        while (num_events > 0) {
+            events.push_back(RecordEvent(parser, event));
+            TEST_CHECK_EQ(rocDecParseVideoDataEx(parser, nullptr, &event, 1, &num_events), ROCDEC_SUCCESS);
+        }
+    });
+    TEST_CHECK_EQ(rocDecDestroyVideoParser(parser), ROCDEC_SUCCESS);
+
+    TEST_CHECK_EQ(events.size(), callback_events.size());
+    for (size_t i = 0; i < events.size(); i++) {
+        if (!(events[i] == callback_events[i])) {
+            fprintf(stderr, "event %zu differs: type %d pic_idx %d pts %lld vs type %d pic_idx %d pts %lld\n", i, events[i].event_type,
+                    events[i].pic_idx, static_cast<long long>(events[i].pts), callback_events[i].event_type, callback_events[i].pic_idx,
+                    static_cast<long long>(callback_events[i].pts));
+            return 1;
+        }
+    }
+
+    // the stream starts with a sequence change, every picture is displayed once, after it was decoded, and the displays
+    // follow the reordering of the stream
+    TEST_CHECK_EQ(events[0].event_type, rocDecParserEvent_SequenceChange);
+    size_t num_pictures = pictures.size() * NUM_REPEATS;
+    std::vector<bool> decoded(64, false);
+    std::vector<RocdecTimeStamp> display_pts;
+    for (auto &event : events) {
+        if (event.event_type == rocDecParserEvent_DecodePicture) {
+            TEST_CHECK(event.pic_idx >= 0 && event.pic_idx < 64 && !decoded[event.pic_idx]);
+            decoded[event.pic_idx] = true;
+        } else if (event.event_type == rocDecParserEvent_DisplayPicture) {
+            TEST_CHECK(event.pic_idx >= 0 && event.pic_idx < 64 && decoded[event.pic_idx]);
+            decoded[event.pic_idx] = false;
+            display_pts.push_back(event.pts);
+        }
+    }
+    TEST_CHECK_EQ(display_pts.size(), num_pictures);
+    TEST_CHECK(!std::is_sorted(display_pts.begin(), display_pts.end()));
+    std::sort(display_pts.begin(), display_pts.end());
+    for (size_t i = 0; i < display_pts.size(); i++) {
+        TEST_CHECK_EQ(display_pts[i], i);
+    }
+    printf("parser event test passed: %zu events\n", events.size());
+    return 0;
+}
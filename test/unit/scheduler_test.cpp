@@ -0,0 +1,126 @@
+/*
+Copyright (c) 2023 - 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+// Checks the placement decisions of RocDecScheduler with synthetic session loads, and the load a null backend decoder
+// reports to it: the frame rate reserved by rocDecSelectDevice, the pixels of failed submissions and reconfigurations.
+// The scheduler is process-wide, so each check uses devices of its own.
+
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "rocdecode.h"
+#include "roc_decoder_scheduler.h"
+#include "test_common.h"
+
+#define SAMPLE_WAIT_MS 1100 // longer than the shortest measurement interval of the scheduler
+
+// devices 0 and 1: a null backend decoder created through rocDecSelectDevice next to a synthetic session
+static void CheckDecoderLoad() {
+    RocDecScheduler &scheduler = RocDecScheduler::GetInstance();
+    std::shared_ptr<RocDecSessionLoad> synthetic_load = scheduler.RegisterSession(1, 1000); // 30000 pixels/s at the default rate
+
+    RocdecDeviceSelectInfo select_info = {};
+    select_info.codec_type = rocDecVideoCodec_HEVC;
+    select_info.chroma_format = rocDecVideoChromaFormat_420;
+    select_info.width = 176;
+    select_info.height = 144;
+    select_info.frame_rate = 1;
+    TEST_CHECK_EQ(rocDecSelectDevice(&select_info), ROCDEC_SUCCESS);
+    TEST_CHECK_EQ(select_info.device_id, 0);
+
+    RocDecoderCreateInfo create_info = {};
+    create_info.device_id = select_info.device_id;
+    create_info.codec_type = rocDecVideoCodec_HEVC;
+    create_info.chroma_format = rocDecVideoChromaFormat_420;
+    create_info.output_format = rocDecVideoSurfaceFormat_NV12;
+    create_info.width = create_info.max_width = create_info.target_width = 176;
+    create_info.height = create_info.max_height = create_info.target_height = 144;
+    create_info.num_decode_surfaces = 4;
+    create_info.backend_type = rocDecBackend_Null;
+    rocDecDecoderHandle decoder = nullptr;
+    TEST_CHECK_EQ(rocDecCreateDecoder(&decoder, &create_info), ROCDEC_SUCCESS);
+
+    // the decoder is estimated at the reserved 1 frame/s, 25344 pixels/s, below the synthetic session
+    std::vector<uint32_t> num_vcn = {1, 1};
+    TEST_CHECK_EQ(scheduler.SelectDevice(num_vcn, 1, 1), 0);
+
+    // pictures the backend rejects do not load the device: the measured rate of the decoder stays 0, while the
+    // synthetic session keeps submitting about 30000 pixels/s
+    synthetic_load->pixels_submitted += 30000;
+    for (int i = 0; i < 100; i++) {
+        RocdecPicParams pic_params = {};
+        pic_params.curr_pic_idx = create_info.num_decode_surfaces;
+        TEST_CHECK(rocDecDecodeFrame(decoder, &pic_params) != ROCDEC_SUCCESS);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(SAMPLE_WAIT_MS));
+    TEST_CHECK_EQ(scheduler.SelectDevice(num_vcn, 1, 1), 0);
+
+    // a reconfiguration replaces the measured rate by the estimate at the new size, 1920 * 1088 pixels/s
+    RocdecReconfigureDecoderInfo reconfig_params = {};
+    reconfig_params.width = reconfig_params.target_width = 1920;
+    reconfig_params.height = reconfig_params.target_height = 1088;
+    reconfig_params.num_decode_surfaces = create_info.num_decode_surfaces;
+    TEST_CHECK_EQ(rocDecReconfigureDecoder(decoder, &reconfig_params), ROCDEC_SUCCESS);
+    TEST_CHECK_EQ(scheduler.SelectDevice(num_vcn, 1, 1), 1);
+
+    TEST_CHECK_EQ(rocDecDestroyDecoder(decoder), ROCDEC_SUCCESS);
+    scheduler.UnregisterSession(synthetic_load);
+}
+
+// devices 2 and 3: reserved frame rates, pending reservations and the VCN instance count
+static void CheckPlacement() {
+    RocDecScheduler &scheduler = RocDecScheduler::GetInstance();
+    std::vector<uint32_t> num_vcn = {0, 0, 1, 1};
+
+    // equal loads go to the lower device id; the session created there takes the reserved 60 frames/s
+    TEST_CHECK_EQ(scheduler.SelectDevice(num_vcn, 1000, 60), 2);
+    std::shared_ptr<RocDecSessionLoad> load_60 = scheduler.RegisterSession(2, 1000);
+    TEST_CHECK_EQ(load_60->frame_rate, 60);
+    // without a reservation the session is counted at the default rate
+    std::shared_ptr<RocDecSessionLoad> load_default = scheduler.RegisterSession(3, 1000);
+    TEST_CHECK_EQ(load_default->frame_rate, 30);
+
+    // 60000 vs 30000 pixels/s
+    TEST_CHECK_EQ(scheduler.SelectDevice(num_vcn, 1000, 10), 3);
+    // the placement is held on device 3 until a session takes it: 60000 vs 40000 pixels/s
+    TEST_CHECK_EQ(scheduler.SelectDevice(num_vcn, 1000, 10), 3);
+    // 60000 vs 50000 pixels/s, but device 2 has 3 VCN instances
+    num_vcn[2] = 3;
+    TEST_CHECK_EQ(scheduler.SelectDevice(num_vcn, 1000, 10), 2);
+
+    // a smaller coded size lowers the estimate of the session: 20000 + 10000 vs 50000 pixels/s on one VCN instance each
+    num_vcn[2] = 1;
+    scheduler.UpdateSession(load_60, 333);
+    TEST_CHECK_EQ(scheduler.SelectDevice(num_vcn, 1000, 10), 2);
+
+    // no device that can decode the stream
+    TEST_CHECK_EQ(scheduler.SelectDevice({0, 0, 0, 0}, 1000, 10), -1);
+    scheduler.UnregisterSession(load_60);
+    scheduler.UnregisterSession(load_default);
+}
+
+int main(int argc, char **argv) {
+    CheckDecoderLoad();
+    CheckPlacement();
+    printf("scheduler test passed\n");
+    return 0;
+}
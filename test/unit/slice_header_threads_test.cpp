@@ -0,0 +1,617 @@
+/*
+Copyright (c) 2023 - 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+// Checks that the AVC and HEVC parsers return the same sequence formats, picture parameters, slice parameters, bitstream
+// data and display order with the slice headers parsed on the worker pool (ROCDECODE_SLICE_HEADER_THREADS=2) as on the
+// calling thread (ROCDECODE_SLICE_HEADER_THREADS=0). The synthetic streams have pictures with 4 to 16 slices, slices with
+// their own reference list modifications, HEVC dependent slice segments, and parameter sets sent between the slices of a
+// picture. The setting is read once per process, so each run parses in a child process.
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "rocparser.h"
+#include "test_common.h"
+
+#define PIC_SIZE 64  // 16 AVC macroblocks or 16 HEVC CTBs of 16x16
+#define NUM_CTBS 16
+#define NUM_P_PICS 6  // each P picture is followed by a B picture that refers to it
+
+static const int slice_counts[] = {16, 16, 8, 4, 16, 7, 16, 12};  // slices of the pictures, in decoding order
+
+/*! \brief Writes the RBSP of a NAL unit and appends it to a stream with a start code and emulation prevention
+ */
+class BitWriter {
+public:
+    void PutBit(uint32_t bit) {
+        if (num_bits_ % 8 == 0) {
+            rbsp_.push_back(0);
+        }
+        if (bit) {
+            rbsp_.back() |= 0x80 >> (num_bits_ % 8);
+        }
+        num_bits_++;
+    }
+    void PutBits(uint32_t value, int num_bits) {
+        for (int i = num_bits - 1; i >= 0; i--) {
+            PutBit((value >> i) & 1);
+        }
+    }
+    void PutUe(uint32_t value) {
+        int len = 0;
+        while (((value + 1) >> len) > 1) {
+            len++;
+        }
+        PutBits(0, len);
+        PutBits(value + 1, len + 1);
+    }
+    void PutSe(int32_t value) {
+        PutUe(value > 0 ? 2 * value - 1 : -2 * value);
+    }
+    void PutTrailingBits() {
+        PutBit(1);
+        while (num_bits_ % 8) {
+            PutBit(0);
+        }
+    }
+    void PutBytes(const std::vector<uint8_t> &bytes) {
+        for (uint8_t byte : bytes) {
+            PutBits(byte, 8);
+        }
+    }
+    void WriteNalUnit(const std::vector<uint8_t> &nal_unit_header, std::vector<uint8_t> &stream) {
+        stream.insert(stream.end(), {0, 0, 1});
+        stream.insert(stream.end(), nal_unit_header.begin(), nal_unit_header.end());
+        int num_zeros = 0;
+        for (uint8_t byte : rbsp_) {
+            if (num_zeros >= 2 && byte <= 3) {
+                stream.push_back(3);
+                num_zeros = 0;
+            }
+            stream.push_back(byte);
+            num_zeros = byte ? 0 : num_zeros + 1;
+        }
+        rbsp_.clear();
+        num_bits_ = 0;
+    }
+
+private:
+    std::vector<uint8_t> rbsp_;
+    size_t num_bits_ = 0;
+};
+
+/*! \brief Slice data after the header. It is not parsed, but has start code prefixes that need emulation prevention.
+ */
+static std::vector<uint8_t> SliceData(int pic, int slice) {
+    return {0, 0, 1, static_cast<uint8_t>(pic), 0, 0, 0, static_cast<uint8_t>(slice), 0, 0, 2, 0x80};
+}
+
+/*! \brief Picture types and POCs of both streams: an IDR picture, then P pictures, each followed by a non-reference B
+ * picture between it and the previous P picture
+ */
+struct PicInfo {
+    bool idr;
+    bool b;
+    int p_index;  // number of P pictures before this one, including itself
+    int poc;
+    int num_slices;
+};
+
+static std::vector<PicInfo> GetPicInfos() {
+    std::vector<PicInfo> pics;
+    pics.push_back({true, false, 0, 0, slice_counts[0]});
+    for (int k = 1; k <= NUM_P_PICS; k++) {
+        pics.push_back({false, false, k, 8 * k, 0});
+        pics.push_back({false, true, k, 8 * k - 4, 0});
+    }
+    for (size_t i = 0; i < pics.size(); i++) {
+        pics[i].num_slices = slice_counts[i % (sizeof(slice_counts) / sizeof(slice_counts[0]))];
+    }
+    return pics;
+}
+
+// AVC: 64x64 High profile, CABAC or CAVLC and weighted prediction depending on the PPS version
+
+static void WriteAvcPps(int pps_id, int version, std::vector<uint8_t> &stream) {
+    BitWriter bw;
+    bw.PutUe(pps_id);
+    bw.PutUe(0);                   // seq_parameter_set_id
+    bw.PutBit(version % 2 == 0);   // entropy_coding_mode_flag
+    bw.PutBit(0);                  // bottom_field_pic_order_in_frame_present_flag
+    bw.PutUe(0);                   // num_slice_groups_minus1
+    bw.PutUe(0);                   // num_ref_idx_l0_default_active_minus1
+    bw.PutUe(0);                   // num_ref_idx_l1_default_active_minus1
+    bw.PutBit(version % 3 == 1);   // weighted_pred_flag
+    bw.PutBits(0, 2);              // weighted_bipred_idc
+    bw.PutSe(version % 5 - 2);     // pic_init_qp_minus26
+    bw.PutSe(0);                   // pic_init_qs_minus26
+    bw.PutSe(0);                   // chroma_qp_index_offset
+    bw.PutBit(version % 2);        // deblocking_filter_control_present_flag
+    bw.PutBit(0);                  // constrained_intra_pred_flag
+    bw.PutBit(0);                  // redundant_pic_cnt_present_flag
+    bw.PutBit(version % 2);        // transform_8x8_mode_flag
+    bw.PutBit(0);                  // pic_scaling_matrix_present_flag
+    bw.PutSe(0);                   // second_chroma_qp_index_offset
+    bw.PutTrailingBits();
+    bw.WriteNalUnit({(3 << 5) | 8}, stream);
+}
+
+static std::vector<std::vector<uint8_t>> GetAvcStream() {
+    std::vector<std::vector<uint8_t>> pictures;
+    int pps_versions[2] = {0, 1};
+    std::vector<uint8_t> stream;
+    BitWriter bw;
+    bw.PutBits(100, 8);  // profile_idc
+    bw.PutBits(0, 8);    // constraint_set flags
+    bw.PutBits(30, 8);   // level_idc
+    bw.PutUe(0);         // seq_parameter_set_id
+    bw.PutUe(1);         // chroma_format_idc
+    bw.PutUe(0);         // bit_depth_luma_minus8
+    bw.PutUe(0);         // bit_depth_chroma_minus8
+    bw.PutBit(0);        // qpprime_y_zero_transform_bypass_flag
+    bw.PutBit(0);        // seq_scaling_matrix_present_flag
+    bw.PutUe(0);         // log2_max_frame_num_minus4
+    bw.PutUe(0);         // pic_order_cnt_type
+    bw.PutUe(2);         // log2_max_pic_order_cnt_lsb_minus4
+    bw.PutUe(2);         // max_num_ref_frames
+    bw.PutBit(0);        // gaps_in_frame_num_value_allowed_flag
+    bw.PutUe(PIC_SIZE / 16 - 1);  // pic_width_in_mbs_minus1
+    bw.PutUe(PIC_SIZE / 16 - 1);  // pic_height_in_map_units_minus1
+    bw.PutBit(1);        // frame_mbs_only_flag
+    bw.PutBit(1);        // direct_8x8_inference_flag
+    bw.PutBit(0);        // frame_cropping_flag
+    bw.PutBit(0);        // vui_parameters_present_flag
+    bw.PutTrailingBits();
+    bw.WriteNalUnit({(3 << 5) | 7}, stream);
+    WriteAvcPps(0, pps_versions[0], stream);
+    WriteAvcPps(1, pps_versions[1], stream);
+
+    std::vector<PicInfo> pics = GetPicInfos();
+    for (size_t i = 0; i < pics.size(); i++) {
+        const PicInfo &pic = pics[i];
+        int pps_id = i % 2;
+        int frame_num = pic.b ? pic.p_index + 1 : pic.p_index;
+        int slice_type = pic.idr ? 2 : (pic.b ? 1 : 0);
+        for (int s = 0; s < pic.num_slices; s++) {
+            // Send the active PPS again and change the other one halfway through the picture
+            if (s == pic.num_slices / 2) {
+                WriteAvcPps(pps_id, pps_versions[pps_id], stream);
+                WriteAvcPps(1 - pps_id, ++pps_versions[1 - pps_id], stream);
+            }
+            int version = pps_versions[pps_id];
+            bool modify_l0 = slice_type == 0 && frame_num >= 2 && s % 2;
+            bw.PutUe(s * 16 / pic.num_slices);  // first_mb_in_slice
+            bw.PutUe(slice_type);
+            bw.PutUe(pps_id);
+            bw.PutBits(frame_num % 16, 4);
+            if (pic.idr) {
+                bw.PutUe(0);  // idr_pic_id
+            }
+            bw.PutBits(pic.poc % 64, 6);  // pic_order_cnt_lsb
+            if (slice_type == 1) {
+                bw.PutBit(1);  // direct_spatial_mv_pred_flag
+            }
+            if (slice_type != 2) {
+                bw.PutBit(modify_l0);  // num_ref_idx_active_override_flag
+                if (modify_l0) {
+                    bw.PutUe(1);  // num_ref_idx_l0_active_minus1
+                }
+                // Move the older of the two reference frames to the front of list 0
+                bw.PutBit(modify_l0);  // ref_pic_list_modification_flag_l0
+                if (modify_l0) {
+                    bw.PutUe(0);  // modification_of_pic_nums_idc
+                    bw.PutUe(1);  // abs_diff_pic_num_minus1
+                    bw.PutUe(3);
+                }
+            }
+            if (slice_type == 1) {
+                bw.PutBit(0);  // ref_pic_list_modification_flag_l1
+            }
+            if (slice_type == 0 && version % 3 == 1) {
+                bw.PutUe(6);  // luma_log2_weight_denom
+                bw.PutUe(6);  // chroma_log2_weight_denom
+                for (int r = 0; r <= (modify_l0 ? 1 : 0); r++) {
+                    bw.PutBit(1);  // luma_weight_l0_flag
+                    bw.PutSe(64 + s);
+                    bw.PutSe(s % 3 - 1);
+                    bw.PutBit(0);  // chroma_weight_l0_flag
+                }
+            }
+            if (!pic.b) {
+                if (pic.idr) {
+                    bw.PutBit(0);  // no_output_of_prior_pics_flag
+                    bw.PutBit(0);  // long_term_reference_flag
+                } else {
+                    bw.PutBit(0);  // adaptive_ref_pic_marking_mode_flag
+                }
+            }
+            if (version % 2 == 0 && slice_type != 2) {
+                bw.PutUe(s % 3);  // cabac_init_idc
+            }
+            bw.PutSe(s % 5 - 2);  // slice_qp_delta
+            if (version % 2) {
+                bw.PutUe(s % 3 == 1 ? 1 : 0);  // disable_deblocking_filter_idc
+                if (s % 3 != 1) {
+                    bw.PutSe(0);      // slice_alpha_c0_offset_div2
+                    bw.PutSe(s % 2);  // slice_beta_offset_div2
+                }
+            }
+            bw.PutTrailingBits();
+            bw.PutBytes(SliceData(i, s));
+            bw.WriteNalUnit({static_cast<uint8_t>(pic.b ? 1 : (pic.idr ? (3 << 5) | 5 : (2 << 5) | 1))}, stream);
+        }
+        pictures.push_back(stream);
+        stream.clear();
+    }
+    return pictures;
+}
+
+// HEVC: 64x64 Main profile with 16x16 CTBs and dependent slice segments, cabac_init, chroma QP offsets, WPP and
+// deblocking overrides depending on the PPS version
+
+static void WriteHevcPtl(BitWriter &bw) {
+    bw.PutBits(0, 2);           // general_profile_space
+    bw.PutBit(0);               // general_tier_flag
+    bw.PutBits(1, 5);           // general_profile_idc
+    bw.PutBits(0x60000000, 32); // general_profile_compatibility_flag[]
+    bw.PutBits(9, 4);           // progressive, interlaced, non_packed and frame_only constraint flags
+    bw.PutBits(0, 32);          // 44 reserved bits
+    bw.PutBits(0, 12);
+    bw.PutBits(60, 8);          // general_level_idc
+}
+
+static void WriteHevcPps(int pps_id, int version, std::vector<uint8_t> &stream) {
+    BitWriter bw;
+    bw.PutUe(pps_id);
+    bw.PutUe(0);                       // pps_seq_parameter_set_id
+    bw.PutBit(1);                      // dependent_slice_segments_enabled_flag
+    bw.PutBit(0);                      // output_flag_present_flag
+    bw.PutBits(0, 3);                  // num_extra_slice_header_bits
+    bw.PutBit(0);                      // sign_data_hiding_enabled_flag
+    bw.PutBit(version % 2);            // cabac_init_present_flag
+    bw.PutUe(0);                       // num_ref_idx_l0_default_active_minus1
+    bw.PutUe(0);                       // num_ref_idx_l1_default_active_minus1
+    bw.PutSe(version % 5 - 2);         // init_qp_minus26
+    bw.PutBit(0);                      // constrained_intra_pred_flag
+    bw.PutBit(0);                      // transform_skip_enabled_flag
+    bw.PutBit(0);                      // cu_qp_delta_enabled_flag
+    bw.PutSe(0);                       // pps_cb_qp_offset
+    bw.PutSe(0);                       // pps_cr_qp_offset
+    bw.PutBit((version / 2) % 2);      // pps_slice_chroma_qp_offsets_present_flag
+    bw.PutBit(0);                      // weighted_pred_flag
+    bw.PutBit(0);                      // weighted_bipred_flag
+    bw.PutBit(0);                      // transquant_bypass_enabled_flag
+    bw.PutBit(0);                      // tiles_enabled_flag
+    bw.PutBit(version % 3 == 1);       // entropy_coding_sync_enabled_flag
+    bw.PutBit(version % 4 != 3);       // pps_loop_filter_across_slices_enabled_flag
+    bw.PutBit(1);                      // deblocking_filter_control_present_flag
+    bw.PutBit(version % 2 == 0);       // deblocking_filter_override_enabled_flag
+    bw.PutBit(0);                      // pps_deblocking_filter_disabled_flag
+    bw.PutSe(0);                       // pps_beta_offset_div2
+    bw.PutSe(0);                       // pps_tc_offset_div2
+    bw.PutBit(0);                      // pps_scaling_list_data_present_flag
+    bw.PutBit(1);                      // lists_modification_present_flag
+    bw.PutUe(0);                       // log2_parallel_merge_level_minus2
+    bw.PutBit(0);                      // slice_segment_header_extension_present_flag
+    bw.PutBit(0);                      // pps_extension_present_flag
+    bw.PutTrailingBits();
+    bw.WriteNalUnit({34 << 1, 1}, stream);
+}
+
+static std::vector<std::vector<uint8_t>> GetHevcStream() {
+    std::vector<std::vector<uint8_t>> pictures;
+    int pps_versions[2] = {0, 1};
+    std::vector<uint8_t> stream;
+    BitWriter bw;
+    bw.PutBits(0, 4);       // vps_video_parameter_set_id
+    bw.PutBits(3, 2);       // vps_base_layer_internal_flag, vps_base_layer_available_flag
+    bw.PutBits(0, 6);       // vps_max_layers_minus1
+    bw.PutBits(0, 3);       // vps_max_sub_layers_minus1
+    bw.PutBit(1);           // vps_temporal_id_nesting_flag
+    bw.PutBits(0xffff, 16);
+    WriteHevcPtl(bw);
+    bw.PutBit(1);           // vps_sub_layer_ordering_info_present_flag
+    bw.PutUe(2);            // vps_max_dec_pic_buffering_minus1
+    bw.PutUe(1);            // vps_max_num_reorder_pics
+    bw.PutUe(0);            // vps_max_latency_increase_plus1
+    bw.PutBits(0, 6);       // vps_max_layer_id
+    bw.PutUe(0);            // vps_num_layer_sets_minus1
+    bw.PutBit(0);           // vps_timing_info_present_flag
+    bw.PutBit(0);           // vps_extension_flag
+    bw.PutTrailingBits();
+    bw.WriteNalUnit({32 << 1, 1}, stream);
+
+    bw.PutBits(0, 4);       // sps_video_parameter_set_id
+    bw.PutBits(0, 3);       // sps_max_sub_layers_minus1
+    bw.PutBit(1);           // sps_temporal_id_nesting_flag
+    WriteHevcPtl(bw);
+    bw.PutUe(0);            // sps_seq_parameter_set_id
+    bw.PutUe(1);            // chroma_format_idc
+    bw.PutUe(PIC_SIZE);     // pic_width_in_luma_samples
+    bw.PutUe(PIC_SIZE);     // pic_height_in_luma_samples
+    bw.PutBit(0);           // conformance_window_flag
+    bw.PutUe(0);            // bit_depth_luma_minus8
+    bw.PutUe(0);            // bit_depth_chroma_minus8
+    bw.PutUe(4);            // log2_max_pic_order_cnt_lsb_minus4
+    bw.PutBit(1);           // sps_sub_layer_ordering_info_present_flag
+    bw.PutUe(2);            // sps_max_dec_pic_buffering_minus1
+    bw.PutUe(1);            // sps_max_num_reorder_pics
+    bw.PutUe(0);            // sps_max_latency_increase_plus1
+    bw.PutUe(0);            // log2_min_luma_coding_block_size_minus3
+    bw.PutUe(1);            // log2_diff_max_min_luma_coding_block_size
+    bw.PutUe(0);            // log2_min_luma_transform_block_size_minus2
+    bw.PutUe(2);            // log2_diff_max_min_luma_transform_block_size
+    bw.PutUe(0);            // max_transform_hierarchy_depth_inter
+    bw.PutUe(0);            // max_transform_hierarchy_depth_intra
+    bw.PutBit(0);           // scaling_list_enabled_flag
+    bw.PutBit(0);           // amp_enabled_flag
+    bw.PutBit(1);           // sample_adaptive_offset_enabled_flag
+    bw.PutBit(0);           // pcm_enabled_flag
+    bw.PutUe(2);            // num_short_term_ref_pic_sets
+    bw.PutUe(1);            // 0: P pictures refer to the previous P picture
+    bw.PutUe(0);
+    bw.PutUe(3);
+    bw.PutBit(1);
+    bw.PutBit(0);           // 1: B pictures refer to the P pictures before and after them
+    bw.PutUe(1);
+    bw.PutUe(1);
+    bw.PutUe(1);
+    bw.PutBit(1);
+    bw.PutUe(1);
+    bw.PutBit(1);
+    bw.PutBit(0);           // long_term_ref_pics_present_flag
+    bw.PutBit(0);           // sps_temporal_mvp_enabled_flag
+    bw.PutBit(0);           // strong_intra_smoothing_enabled_flag
+    bw.PutBit(0);           // vui_parameters_present_flag
+    bw.PutBit(0);           // sps_extension_present_flag
+    bw.PutTrailingBits();
+    bw.WriteNalUnit({33 << 1, 1}, stream);
+    WriteHevcPps(0, pps_versions[0], stream);
+    WriteHevcPps(1, pps_versions[1], stream);
+
+    std::vector<PicInfo> pics = GetPicInfos();
+    for (size_t i = 0; i < pics.size(); i++) {
+        const PicInfo &pic = pics[i];
+        int pps_id = i % 2;
+        int version = pps_versions[pps_id];
+        int slice_type = pic.idr ? 2 : (pic.b ? 0 : 1);
+        int nal_unit_type = pic.idr ? 19 : (pic.b ? 0 : 1);  // IDR_W_RADL, TRAIL_N, TRAIL_R
+        for (int s = 0; s < pic.num_slices; s++) {
+            // Send the active PPS again and change the other one halfway through the picture
+            if (s == pic.num_slices / 2) {
+                WriteHevcPps(pps_id, pps_versions[pps_id], stream);
+                WriteHevcPps(1 - pps_id, ++pps_versions[1 - pps_id], stream);
+            }
+            bool dependent = s % 3 == 2;
+            bw.PutBit(s == 0);  // first_slice_segment_in_pic_flag
+            if (pic.idr) {
+                bw.PutBit(0);  // no_output_of_prior_pics_flag
+            }
+            bw.PutUe(pps_id);
+            if (s > 0) {
+                bw.PutBit(dependent);  // dependent_slice_segment_flag
+                bw.PutBits(s * NUM_CTBS / pic.num_slices, 4);  // slice_segment_address
+            }
+            if (!dependent) {
+                bool sao_luma = s % 2, sao_chroma = (s / 2) % 2;
+                bool modify_l0 = slice_type == 0 && s % 2;
+                bw.PutUe(slice_type);
+                if (!pic.idr) {
+                    bw.PutBits(pic.poc % 256, 8);  // slice_pic_order_cnt_lsb
+                    if (!pic.b && pic.p_index % 2 == 0) {
+                        bw.PutBit(0);  // short_term_ref_pic_set_sps_flag
+                        bw.PutBit(0);  // inter_ref_pic_set_prediction_flag
+                        bw.PutUe(1);
+                        bw.PutUe(0);
+                        bw.PutUe(3);
+                        bw.PutBit(1);
+                    } else {
+                        bw.PutBit(1);      // short_term_ref_pic_set_sps_flag
+                        bw.PutBit(pic.b);  // short_term_ref_pic_set_idx
+                    }
+                }
+                bw.PutBit(sao_luma);
+                bw.PutBit(sao_chroma);
+                if (slice_type != 2) {
+                    bw.PutBit(modify_l0);  // num_ref_idx_active_override_flag
+                    if (modify_l0) {
+                        bw.PutUe(1);  // num_ref_idx_l0_active_minus1
+                        bw.PutUe(0);  // num_ref_idx_l1_active_minus1
+                    }
+                    if (slice_type == 0) {
+                        // Swap the two pictures of list 0
+                        bw.PutBit(modify_l0);  // ref_pic_list_modification_flag_l0
+                        if (modify_l0) {
+                            bw.PutBit(1);
+                            bw.PutBit(0);
+                        }
+                        bw.PutBit(0);  // ref_pic_list_modification_flag_l1
+                        bw.PutBit(0);  // mvd_l1_zero_flag
+                    }
+                    if (version % 2) {
+                        bw.PutBit(s % 2);  // cabac_init_flag
+                    }
+                    bw.PutUe(s % 5);  // five_minus_max_num_merge_cand
+                }
+                bw.PutSe(s % 5 - 2);  // slice_qp_delta
+                if ((version / 2) % 2) {
+                    bw.PutSe(s % 3 - 1);  // slice_cb_qp_offset
+                    bw.PutSe(0);          // slice_cr_qp_offset
+                }
+                bool deblocking_disabled = false;
+                if (version % 2 == 0) {
+                    bw.PutBit(s % 2);  // deblocking_filter_override_flag
+                    if (s % 2) {
+                        deblocking_disabled = (s / 2) % 2;
+                        bw.PutBit(deblocking_disabled);
+                        if (!deblocking_disabled) {
+                            bw.PutSe(1);   // slice_beta_offset_div2
+                            bw.PutSe(-1);  // slice_tc_offset_div2
+                        }
+                    }
+                }
+                if (version % 4 != 3 && (sao_luma || sao_chroma || !deblocking_disabled)) {
+                    bw.PutBit(1);  // slice_loop_filter_across_slices_enabled_flag
+                }
+            }
+            if (version % 3 == 1) {
+                bw.PutUe(s % 2);  // num_entry_point_offsets
+                if (s % 2) {
+                    bw.PutUe(7);  // offset_len_minus1
+                    bw.PutBits(5, 8);
+                }
+            }
+            bw.PutTrailingBits();
+            bw.PutBytes(SliceData(i, s));
+            bw.WriteNalUnit({static_cast<uint8_t>(nal_unit_type << 1), 1}, stream);
+        }
+        pictures.push_back(stream);
+        stream.clear();
+    }
+    return pictures;
+}
+
+// Everything the callbacks return, serialized with the pointers replaced by the data they point to
+
+static rocDecVideoCodec record_codec;
+static std::vector<uint8_t> record;
+static std::vector<uint32_t> record_num_slices;
+
+static void Append(const void *data, size_t size) {
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    record.insert(record.end(), bytes, bytes + size);
+}
+
+static int ROCDECAPI SequenceCallback(void *, RocdecVideoFormat *video_format) {
+    Append("S", 1);
+    Append(video_format, sizeof(RocdecVideoFormat));
+    return video_format->min_num_decode_surfaces;
+}
+
+static int ROCDECAPI DecodeCallback(void *, RocdecPicParams *pic_params) {
+    RocdecPicParams params = *pic_params;
+    params.bitstream_data = nullptr;
+    params.slice_params.avc = nullptr;
+    Append("D", 1);
+    Append(&params, sizeof(RocdecPicParams));
+    if (record_codec == rocDecVideoCodec_AVC) {
+        Append(pic_params->slice_params.avc, pic_params->num_slices * sizeof(RocdecAvcSliceParams));
+    } else {
+        Append(pic_params->slice_params.hevc, pic_params->num_slices * sizeof(RocdecHevcSliceParams));
+    }
+    Append(pic_params->bitstream_data, pic_params->bitstream_data_len);
+    record_num_slices.push_back(pic_params->num_slices);
+    return 1;
+}
+
+static int ROCDECAPI DisplayCallback(void *, RocdecParserDispInfo *disp_info) {
+    Append("P", 1);
+    Append(disp_info, sizeof(RocdecParserDispInfo));
+    return 1;
+}
+
+/*! \brief Parses a stream in a child process with the given number of slice header threads and returns its record
+ */
+static std::vector<uint8_t> ParseInChild(rocDecVideoCodec codec, const std::vector<std::vector<uint8_t>> &pictures, const char *num_threads) {
+    int fds[2];
+    TEST_CHECK_EQ(pipe(fds), 0);
+    fflush(stdout);
+    pid_t pid = fork();
+    TEST_CHECK(pid >= 0);
+    if (pid == 0) {
+        close(fds[0]);
+        setenv("ROCDECODE_SLICE_HEADER_THREADS", num_threads, 1);
+        record_codec = codec;
+        RocdecParserParams parser_params = {};
+        parser_params.codec_type = codec;
+        parser_params.max_num_decode_surfaces = 1;
+        parser_params.max_display_delay = 1;
+        parser_params.pfn_sequence_callback = SequenceCallback;
+        parser_params.pfn_decode_picture = DecodeCallback;
+        parser_params.pfn_display_picture = DisplayCallback;
+        RocdecVideoParser parser = nullptr;
+        TEST_CHECK_EQ(rocDecCreateVideoParser(&parser, &parser_params), ROCDEC_SUCCESS);
+        int64_t pts = 0;
+        for (auto &picture : pictures) {
+            RocdecSourceDataPacket packet = {};
+            packet.payload = picture.data();
+            packet.payload_size = static_cast<uint32_t>(picture.size());
+            packet.pts = pts++;
+            packet.flags = ROCDEC_PKT_TIMESTAMP;
+            TEST_CHECK_EQ(rocDecParseVideoData(parser, &packet), ROCDEC_SUCCESS);
+        }
+        RocdecSourceDataPacket packet = {};
+        packet.flags = ROCDEC_PKT_ENDOFSTREAM;
+        TEST_CHECK_EQ(rocDecParseVideoData(parser, &packet), ROCDEC_SUCCESS);
+        RocdecParserStats stats;
+        TEST_CHECK_EQ(rocDecGetParserStats(parser, &stats), ROCDEC_SUCCESS);
+        Append(&stats, offsetof(RocdecParserStats, parse_time_ns));
+        TEST_CHECK_EQ(rocDecDestroyVideoParser(parser), ROCDEC_SUCCESS);
+
+        // every slice of every picture was parsed and submitted
+        std::vector<PicInfo> pics = GetPicInfos();
+        TEST_CHECK_EQ(record_num_slices.size(), pics.size());
+        for (size_t i = 0; i < pics.size(); i++) {
+            TEST_CHECK_EQ(record_num_slices[i], pics[i].num_slices);
+        }
+        TEST_CHECK_EQ(stats.num_pics_displayed, pics.size());
+        TEST_CHECK(write(fds[1], record.data(), record.size()) == static_cast<ssize_t>(record.size()));
+        close(fds[1]);
+        exit(0);
+    }
+    close(fds[1]);
+    std::vector<uint8_t> child_record;
+    uint8_t buf[4096];
+    ssize_t size;
+    while ((size = read(fds[0], buf, sizeof(buf))) > 0) {
+        child_record.insert(child_record.end(), buf, buf + size);
+    }
+    close(fds[0]);
+    int status;
+    TEST_CHECK_EQ(waitpid(pid, &status, 0), pid);
+    TEST_CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    return child_record;
+}
+
+static void CheckStream(const char *name, rocDecVideoCodec codec, const std::vector<std::vector<uint8_t>> &pictures) {
+    std::vector<uint8_t> serial_record = ParseInChild(codec, pictures, "0");
+    std::vector<uint8_t> parallel_record = ParseInChild(codec, pictures, "2");
+    TEST_CHECK(!serial_record.empty());
+    TEST_CHECK_EQ(parallel_record.size(), serial_record.size());
+    for (size_t i = 0; i < serial_record.size(); i++) {
+        if (parallel_record[i] != serial_record[i]) {
+            fprintf(stderr, "%s: the records differ at byte %zu\n", name, i);
+            exit(1);
+        }
+    }
+    printf("%s: %zu pictures, %zu record bytes match\n", name, pictures.size(), serial_record.size());
+}
+
+int main() {
+    CheckStream("AVC", rocDecVideoCodec_AVC, GetAvcStream());
+    CheckStream("HEVC", rocDecVideoCodec_HEVC, GetHevcStream());
+    printf("slice header threads test passed\n");
+    return 0;
+}
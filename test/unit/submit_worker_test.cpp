@@ -0,0 +1,129 @@
+/*
+Copyright (c) 2023 - 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+// Drives the decode submission worker (RocDecoderCreateInfo::submit_queue_depth and ROCDECODE_SUBMIT_QUEUE_DEPTH) on the
+// null decoder backend, with ROCDECODE_NULL_DECODE_DELAY_US to keep the pictures in flight
+
+#include <chrono>
+#include <cstring>
+#include <string>
+#include "rocdecode.h"
+#include "test_common.h"
+
+#define NUM_SURFACES 6
+#define QUEUE_DEPTH 2
+#define NUM_SLICES 3
+#define DECODE_DELAY_US 20000
+
+static rocDecDecoderHandle CreateQueuedDecoder(uint32_t submit_queue_depth) {
+    RocDecoderCreateInfo create_info = {};
+    create_info.num_decode_surfaces = NUM_SURFACES;
+    create_info.submit_queue_depth = submit_queue_depth;
+    return CreateNullDecoder(create_info);
+}
+
+// the bitstream and the slice parameters live on the stack of this call and are clobbered before it returns, so the
+// worker only sees them through the copy made by the queue
+static rocDecStatus QueueInto(rocDecDecoderHandle decoder, int pic_idx) {
+    RocdecPicParams pic_params = {};
+    uint8_t bitstream[64] = {0, 0, 1};
+    RocdecHevcSliceParams slice_params[NUM_SLICES] = {};
+    pic_params.curr_pic_idx = pic_idx;
+    pic_params.bitstream_data = bitstream;
+    pic_params.bitstream_data_len = sizeof(bitstream);
+    pic_params.num_slices = NUM_SLICES;
+    pic_params.slice_params.hevc = slice_params;
+    rocDecStatus status = rocDecDecodeFrame(decoder, &pic_params);
+    memset(bitstream, 0xff, sizeof(bitstream));
+    memset(slice_params, 0xff, sizeof(slice_params));
+    return status;
+}
+
+static void CheckQueuedDecode() {
+    setenv("ROCDECODE_NULL_DECODE_DELAY_US", std::to_string(DECODE_DELAY_US).c_str(), 1);
+    unsetenv("ROCDECODE_SUBMIT_QUEUE_DEPTH");
+    rocDecDecoderHandle decoder = CreateQueuedDecoder(QUEUE_DEPTH);
+
+    // more pictures than the queue holds: the extra calls wait for the worker instead of failing, and every picture
+    // is in progress whether it is still queued or already with the backend
+    auto submit_time = std::chrono::steady_clock::now();
+    for (int pic_idx = 0; pic_idx < NUM_SURFACES; pic_idx++) {
+        TEST_CHECK_EQ(QueueInto(decoder, pic_idx), ROCDEC_SUCCESS);
+        TEST_CHECK_EQ(GetStatus(decoder, pic_idx), rocDecodeStatus_InProgress);
+    }
+
+    // out-of-range surfaces are rejected on the calling thread
+    RocdecPicParams pic_params = {};
+    pic_params.curr_pic_idx = NUM_SURFACES;
+    TEST_CHECK_EQ(rocDecDecodeFrame(decoder, &pic_params), ROCDEC_INVALID_PARAMETER);
+    pic_params.curr_pic_idx = -1;
+    TEST_CHECK_EQ(rocDecDecodeFrame(decoder, &pic_params), ROCDEC_INVALID_PARAMETER);
+
+    // rocDecGetVideoFrame waits for the submission and then for the decode of the picture
+    for (int pic_idx = NUM_SURFACES - 1; pic_idx >= 0; pic_idx--) {
+        void *planes[3] = {};
+        uint32_t pitches[3] = {};
+        RocdecProcParams proc_params = {};
+        TEST_CHECK_EQ(rocDecGetVideoFrame(decoder, pic_idx, planes, pitches, &proc_params), ROCDEC_SUCCESS);
+        TEST_CHECK(planes[0] != nullptr && planes[1] != nullptr);
+        TEST_CHECK_EQ(GetStatus(decoder, pic_idx), rocDecodeStatus_Success);
+    }
+    auto elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - submit_time).count();
+    TEST_CHECK(elapsed_us >= DECODE_DELAY_US);
+
+    // a surface can be queued again once its previous decode completed
+    TEST_CHECK_EQ(QueueInto(decoder, 0), ROCDEC_SUCCESS);
+    TEST_CHECK_EQ(QueueInto(decoder, 1), ROCDEC_SUCCESS);
+    TEST_CHECK_EQ(GetStatus(decoder, 1), rocDecodeStatus_InProgress);
+
+    // a reconfiguration waits for the queued pictures of the old configuration
+    RocdecReconfigureDecoderInfo reconfig_params = {};
+    reconfig_params.width = reconfig_params.target_width = 160;
+    reconfig_params.height = reconfig_params.target_height = 128;
+    reconfig_params.num_decode_surfaces = NUM_SURFACES;
+    TEST_CHECK_EQ(rocDecReconfigureDecoder(decoder, &reconfig_params), ROCDEC_SUCCESS);
+    for (int pic_idx = 0; pic_idx < NUM_SURFACES; pic_idx++) {
+        TEST_CHECK_EQ(GetStatus(decoder, pic_idx), rocDecodeStatus_Success);
+    }
+    TEST_CHECK_EQ(rocDecDestroyDecoder(decoder), ROCDEC_SUCCESS);
+}
+
+static void CheckDestroyWithQueuedPictures() {
+    // the queue depth comes from the environment when the create info leaves it at 0
+    setenv("ROCDECODE_NULL_DECODE_DELAY_US", std::to_string(DECODE_DELAY_US).c_str(), 1);
+    setenv("ROCDECODE_SUBMIT_QUEUE_DEPTH", "1", 1);
+    rocDecDecoderHandle decoder = CreateQueuedDecoder(0);
+    for (int pic_idx = 0; pic_idx < NUM_SURFACES; pic_idx++) {
+        TEST_CHECK_EQ(QueueInto(decoder, pic_idx), ROCDEC_SUCCESS);
+    }
+    TEST_CHECK_EQ(GetStatus(decoder, NUM_SURFACES - 1), rocDecodeStatus_InProgress);
+    // the worker drains the queue before the decoder goes away
+    TEST_CHECK_EQ(rocDecDestroyDecoder(decoder), ROCDEC_SUCCESS);
+    unsetenv("ROCDECODE_SUBMIT_QUEUE_DEPTH");
+}
+
+int main(int argc, char **argv) {
+    CheckQueuedDecode();
+    CheckDestroyWithQueuedPictures();
+    printf("submit worker test passed\n");
+    return 0;
+}
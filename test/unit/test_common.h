@@ -0,0 +1,74 @@
+/*
+Copyright (c) 2023 - 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+#include "rocdecode.h"
+
+/*! \brief Minimal checks for the unit tests: a failed check prints its location and ends the test with a non-zero exit code.
+ */
+#define TEST_CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            exit(1); \
+        } \
+    } while (0)
+
+#define TEST_CHECK_EQ(a, b) \
+    do { \
+        long long test_a = static_cast<long long>(a), test_b = static_cast<long long>(b); \
+        if (test_a != test_b) { \
+            fprintf(stderr, "%s:%d: check failed: %s == %s (%lld vs %lld)\n", __FILE__, __LINE__, #a, #b, test_a, test_b); \
+            exit(1); \
+        } \
+    } while (0)
+
+/*! \brief Creates a decoder on the null backend: 176x144 HEVC 4:2:0 NV12 with 4 surfaces by default. Every non-zero field of
+ * overrides replaces the default; max_width/max_height and target_width/target_height default to the size.
+ */
+static inline rocDecDecoderHandle CreateNullDecoder(const RocDecoderCreateInfo &overrides = {}) {
+    RocDecoderCreateInfo create_info = overrides;
+    create_info.codec_type = overrides.codec_type ? overrides.codec_type : rocDecVideoCodec_HEVC;
+    create_info.chroma_format = overrides.chroma_format ? overrides.chroma_format : rocDecVideoChromaFormat_420;
+    create_info.width = overrides.width ? overrides.width : 176;
+    create_info.height = overrides.height ? overrides.height : 144;
+    create_info.max_width = overrides.max_width ? overrides.max_width : create_info.width;
+    create_info.max_height = overrides.max_height ? overrides.max_height : create_info.height;
+    create_info.target_width = overrides.target_width ? overrides.target_width : create_info.width;
+    create_info.target_height = overrides.target_height ? overrides.target_height : create_info.height;
+    create_info.num_decode_surfaces = overrides.num_decode_surfaces ? overrides.num_decode_surfaces : 4;
+    create_info.backend_type = rocDecBackend_Null;
+    rocDecDecoderHandle decoder = nullptr;
+    TEST_CHECK_EQ(rocDecCreateDecoder(&decoder, &create_info), ROCDEC_SUCCESS);
+    return decoder;
+}
+
+/*! \brief Returns the decode status of a picture, which must be available
+ */
+static inline rocDecDecodeStatus GetStatus(rocDecDecoderHandle decoder, int pic_idx) {
+    RocdecDecodeStatus decode_status = {};
+    TEST_CHECK_EQ(rocDecGetDecodeStatus(decoder, pic_idx, &decode_status), ROCDEC_SUCCESS);
+    return static_cast<rocDecDecodeStatus>(decode_status.decode_status);
+}
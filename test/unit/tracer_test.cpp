@@ -0,0 +1,58 @@
+/*
+Copyright (c) 2023 - 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+// Checks that application event names recorded through rocDecTraceEvent are escaped in the Chrome trace JSON
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include "rocdecode.h"
+#include "test_common.h"
+
+int main(int argc, char **argv) {
+    // read when the tracer is first used; the dump at exit goes nowhere
+    std::string trace_path = "/tmp/rocdecode_tracer_test_" + std::to_string(getpid()) + ".json";
+    setenv("ROCDECODE_TRACE", "1", 1);
+    setenv("ROCDECODE_TRACE_FILE", "/dev/null", 1);
+
+    TEST_CHECK_EQ(rocDecTraceEvent("stage \"a\\b\"\n\t", rocDecTracePhase_Begin, 3), ROCDEC_SUCCESS);
+    TEST_CHECK_EQ(rocDecTraceEvent("stage \"a\\b\"\n\t", rocDecTracePhase_End, 3), ROCDEC_SUCCESS);
+    TEST_CHECK_EQ(rocDecTraceEvent("plain", rocDecTracePhase_Instant, -1), ROCDEC_SUCCESS);
+    TEST_CHECK_EQ(rocDecTraceEvent(nullptr, rocDecTracePhase_Instant, -1), ROCDEC_INVALID_PARAMETER);
+    TEST_CHECK_EQ(rocDecTraceDump(trace_path.c_str()), ROCDEC_SUCCESS);
+
+    std::ifstream file(trace_path);
+    std::stringstream trace;
+    trace << file.rdbuf();
+    std::string json = trace.str();
+    TEST_CHECK(json.find("{\"name\":\"stage \\\"a\\\\b\\\"\\u000a\\u0009\",\"ph\":\"B\"") != std::string::npos);
+    TEST_CHECK(json.find("{\"name\":\"stage \\\"a\\\\b\\\"\\u000a\\u0009\",\"ph\":\"E\"") != std::string::npos);
+    TEST_CHECK(json.find("{\"name\":\"plain\",\"ph\":\"i\"") != std::string::npos);
+    // no raw control character or unescaped quote is left in the names
+    TEST_CHECK(json.find("\n\t") == std::string::npos);
+    TEST_CHECK(json.find("\"a\\b\"") == std::string::npos);
+    unlink(trace_path.c_str());
+    printf("tracer test passed\n");
+    return 0;
+}
@@ -0,0 +1,219 @@
+/*
+Copyright (c) 2023 - 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+// rocdecode-metrics: lists the shared-memory metrics segments that rocDecode sessions publish with ROCDECODE_METRICS_SHM=1
+
+#include <iostream>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <dirent.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "amd_detail/rocdecode_metrics.h"
+
+#define SHM_DIR "/dev/shm"
+
+void ShowHelpAndExit() {
+    std::cout << "Usage: rocdecode-metrics [options]" << std::endl
+    << "Lists the metrics of the rocDecode decoder and parser sessions on this host that run with ROCDECODE_METRICS_SHM=1." << std::endl
+    << "Options:" << std::endl
+    << "-i Refresh interval in seconds - keeps printing the metrics until interrupted; optional; default: print once" << std::endl
+    << "-p PID - only lists the sessions of this process; optional" << std::endl
+    << "-c Removes the segments left behind by processes that are gone; optional" << std::endl;
+    exit(0);
+}
+
+struct Session {
+    std::string name;
+    RocdecMetricsSegment metrics;
+    bool alive;
+};
+
+static uint64_t GetTimeNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static const char *GetCodecName(uint32_t codec_type) {
+    // rocDecVideoCodec
+    static const char *codec_names[] = {"MPEG1", "MPEG2", "MPEG4", "AVC", "HEVC", "AV1", "VP8", "VP9", "JPEG"};
+    return codec_type < sizeof(codec_names) / sizeof(codec_names[0]) ? codec_names[codec_type] : "?";
+}
+
+static bool ProcessIsAlive(int pid) {
+    return kill(pid, 0) == 0 || errno == EPERM;
+}
+
+// Takes a copy of the segment with one atomic load per field; returns false if the segment is not a valid metrics segment
+static bool ReadSegment(const std::string &name, RocdecMetricsSegment *metrics) {
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    void *addr = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size >= static_cast<off_t>(sizeof(RocdecMetricsSegment))) {
+        addr = mmap(nullptr, sizeof(RocdecMetricsSegment), PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (addr == MAP_FAILED) {
+        return false;
+    }
+    const RocdecMetricsSegment *segment = static_cast<const RocdecMetricsSegment *>(addr);
+    bool valid = __atomic_load_n(&segment->magic, __ATOMIC_ACQUIRE) == ROCDECODE_METRICS_MAGIC &&
+                 segment->version == ROCDECODE_METRICS_VERSION && segment->size == sizeof(RocdecMetricsSegment);
+    if (valid) {
+        // the header is written once before the magic; the counters are updated while we read them
+        memcpy(metrics, segment, offsetof(RocdecMetricsSegment, update_time_ns));
+#define LOAD_FIELD(FIELD) metrics->FIELD = __atomic_load_n(&segment->FIELD, __ATOMIC_RELAXED)
+        LOAD_FIELD(update_time_ns);
+        LOAD_FIELD(width);
+        LOAD_FIELD(height);
+        LOAD_FIELD(num_surfaces);
+        LOAD_FIELD(surfaces_in_use);
+        LOAD_FIELD(frames_in_flight);
+        LOAD_FIELD(fps_milli);
+        LOAD_FIELD(num_frames);
+        LOAD_FIELD(num_frames_output);
+        LOAD_FIELD(num_bytes);
+        LOAD_FIELD(num_errors);
+        LOAD_FIELD(num_reconfigurations);
+#undef LOAD_FIELD
+    }
+    munmap(addr, sizeof(RocdecMetricsSegment));
+    return valid;
+}
+
+static std::vector<Session> ListSessions(int pid_filter) {
+    std::vector<Session> sessions;
+    // the segment names are ROCDECODE_METRICS_SHM_PREFIX<pid>.<session_id>, without the leading '/' in /dev/shm
+    const std::string prefix = ROCDECODE_METRICS_SHM_PREFIX + 1;
+    DIR *dir = opendir(SHM_DIR);
+    if (dir == nullptr) {
+        std::cerr << "ERROR: failed to open " << SHM_DIR << ": " << strerror(errno) << std::endl;
+        return sessions;
+    }
+    while (struct dirent *entry = readdir(dir)) {
+        if (strncmp(entry->d_name, prefix.c_str(), prefix.size()) != 0) {
+            continue;
+        }
+        Session session;
+        session.name = "/" + std::string(entry->d_name);
+        if (!ReadSegment(session.name, &session.metrics)) {
+            continue;
+        }
+        if (pid_filter > 0 && session.metrics.pid != pid_filter) {
+            continue;
+        }
+        session.alive = ProcessIsAlive(session.metrics.pid);
+        sessions.push_back(session);
+    }
+    closedir(dir);
+    std::sort(sessions.begin(), sessions.end(), [](const Session &a, const Session &b) {
+        return a.metrics.pid != b.metrics.pid ? a.metrics.pid < b.metrics.pid : a.metrics.session_id < b.metrics.session_id;
+    });
+    return sessions;
+}
+
+static void PrintSessions(const std::vector<Session> &sessions) {
+    uint64_t now = GetTimeNs();
+    printf("%8s %5s %-7s %4s %-5s %11s %9s %12s %12s %6s %9s %14s %7s %7s %9s\n", "PID", "SESS", "TYPE", "DEV", "CODEC", "SIZE", "FPS",
+           "FRAMES", "OUTPUT", "INFL", "SURF", "BYTES", "ERRORS", "RECONF", "UPTIME(s)");
+    for (const Session &session : sessions) {
+        const RocdecMetricsSegment &m = session.metrics;
+        char size[32], surfaces[32];
+        snprintf(size, sizeof(size), "%ux%u", m.width, m.height);
+        if (m.session_type == rocDecMetricsSession_Parser) {
+            snprintf(surfaces, sizeof(surfaces), "%u/%u", m.surfaces_in_use, m.num_surfaces);
+        } else {
+            snprintf(surfaces, sizeof(surfaces), "%u", m.num_surfaces);
+        }
+        // a session that stopped counting frames for two seconds is idle; its last frame rate is stale
+        double fps = (now - m.update_time_ns < 2000000000ull) ? m.fps_milli / 1000.0 : 0.0;
+        printf("%8d %5u %-7s %4d %-5s %11s %9.1f %12lu %12lu %6u %9s %14lu %7lu %7lu %9.1f%s\n", m.pid, m.session_id,
+               m.session_type == rocDecMetricsSession_Parser ? "parser" : "decoder", m.device_id, GetCodecName(m.codec_type), size, fps,
+               static_cast<unsigned long>(m.num_frames), static_cast<unsigned long>(m.num_frames_output), m.frames_in_flight, surfaces,
+               static_cast<unsigned long>(m.num_bytes), static_cast<unsigned long>(m.num_errors), static_cast<unsigned long>(m.num_reconfigurations),
+               (now - m.start_time_ns) / 1e9, session.alive ? "" : " (exited)");
+    }
+    fflush(stdout);
+}
+
+int main(int argc, char **argv) {
+    double interval = 0;
+    int pid_filter = 0;
+    bool cleanup = false;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-h")) {
+            ShowHelpAndExit();
+        }
+        if (!strcmp(argv[i], "-i")) {
+            if (++i == argc) {
+                ShowHelpAndExit();
+            }
+            interval = atof(argv[i]);
+            continue;
+        }
+        if (!strcmp(argv[i], "-p")) {
+            if (++i == argc) {
+                ShowHelpAndExit();
+            }
+            pid_filter = atoi(argv[i]);
+            continue;
+        }
+        if (!strcmp(argv[i], "-c")) {
+            cleanup = true;
+            continue;
+        }
+        ShowHelpAndExit();
+    }
+
+    if (cleanup) {
+        for (const Session &session : ListSessions(pid_filter)) {
+            if (!session.alive) {
+                if (shm_unlink(session.name.c_str()) == 0) {
+                    std::cout << "info: removed " << session.name << " of exited process " << session.metrics.pid << std::endl;
+                } else {
+                    std::cerr << "ERROR: failed to remove " << session.name << ": " << strerror(errno) << std::endl;
+                }
+            }
+        }
+    }
+    while (true) {
+        PrintSessions(ListSessions(pid_filter));
+        if (interval <= 0) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::duration<double>(interval));
+        printf("\n");
+    }
+    return 0;
+}
@@ -101,7 +101,8 @@ FFMpegVideoDecoder::FFMpegVideoDecoder(int device_id, OutputSurfaceMemoryType ou
         parser_params.codec_type = codec_id_;
         parser_params.max_num_decode_surfaces = 1; // let the parser to determine the decode buffer pool size
         parser_params.clock_rate = clk_rate;
-        parser_params.max_display_delay = disp_delay_;
+        parser_params.auto_display_delay = disp_delay_ == DISP_DELAY_AUTO;
+        parser_params.max_display_delay = parser_params.auto_display_delay ? 0 : disp_delay_;
         parser_params.user_data = this;
         parser_params.pfn_sequence_callback = FFMpegHandleVideoSequenceProc;
         parser_params.pfn_decode_picture = FFMpegHandlePictureDecodeProc;
@@ -124,12 +125,16 @@ FFMpegVideoDecoder::~FFMpegVideoDecoder() {
     std::lock_guard<std::mutex> lock(mtx_vp_frame_);
     for (auto &p_frame : vp_frames_ffmpeg_) {
         if (p_frame.frame_ptr) {
+#if !ROCDECODE_HOST_ONLY
             if (out_mem_type_ == OUT_SURFACE_MEM_DEV_COPIED) {
                 hipError_t hip_status = hipFree(p_frame.frame_ptr);
                 if (hip_status != hipSuccess) {
                     std::cerr << "ERROR: hipFree failed! (" << hip_status << ")" << std::endl;
                 }
-            }
+            } else
+#endif
+                delete [] (p_frame.frame_ptr);
+            p_frame.frame_ptr = nullptr;
         }
     }
 
@@ -355,10 +360,13 @@ int FFMpegVideoDecoder::ReconfigureDecoder(RocdecVideoFormat *p_video_format) {
         // pop decoded frame
         vp_frames_ffmpeg_.pop_back();
         if (p_frame->frame_ptr) {
+#if !ROCDECODE_HOST_ONLY
             if (out_mem_type_ == OUT_SURFACE_MEM_DEV_COPIED) {
                 hipError_t hip_status = hipFree(p_frame->frame_ptr);
                 if (hip_status != hipSuccess) std::cerr << "ERROR: hipFree failed! (" << hip_status << ")" << std::endl;
-            }
+            } else
+#endif
+                delete [] (p_frame->frame_ptr);
         }
         // release associated av_frame
         if (p_frame->av_frame_ptr) {
@@ -546,12 +554,17 @@ int FFMpegVideoDecoder::HandlePictureDisplay(RocdecParserDispInfo *pDispInfo) {
         if (++output_frame_cnt_ > vp_frames_ffmpeg_.size()) {
             num_alloced_frames_++;
             DecFrameBufferFFMpeg dec_frame = { 0 };
+#if ROCDECODE_HOST_ONLY
+            // host frame pool: FFMpeg decodes on the CPU and there is no device to copy to
+            dec_frame.frame_ptr = new uint8_t[GetFrameSize()];
+#else
             if (out_mem_type_ == OUT_SURFACE_MEM_DEV_COPIED) {
                 // allocate device memory
                 HIP_API_CALL(hipMalloc((void **)&dec_frame.frame_ptr, GetFrameSize()));
             } else {
                 dec_frame.frame_ptr = new uint8_t[GetFrameSize()];
             }
+#endif
 
             dec_frame.av_frame_ptr = p_av_frame;
             dec_frame.pts = pDispInfo->pts;
@@ -569,6 +582,7 @@ int FFMpegVideoDecoder::HandlePictureDisplay(RocdecParserDispInfo *pDispInfo) {
         std::cerr << "HandlePictureDisplay: Invalid Memory address for src/dst" << std::endl;
         return 0;
     }
+#if !ROCDECODE_HOST_ONLY
     if (out_mem_type_ == OUT_SURFACE_MEM_DEV_COPIED) {
         if (src_pitch[0] == dst_pitch) {
             int luma_size = src_pitch[0] * disp_height_;
@@ -577,13 +591,15 @@ int FFMpegVideoDecoder::HandlePictureDisplay(RocdecParserDispInfo *pDispInfo) {
             // use 2d copy to copy an ROI
             HIP_API_CALL(hipMemcpy2DAsync(p_frame_y, dst_pitch, p_src_ptr_y, src_pitch[0], dst_pitch, disp_height_, hipMemcpyHostToDevice, hip_stream_));
         }
-    } else {
+    } else
+#endif
+    {
         if (src_pitch[0] == dst_pitch) {
             int luma_size = src_pitch[0] * disp_height_;
             memcpy(p_frame_y, p_src_ptr_y, luma_size);
         } else {
             for (int i = 0; i < disp_height_; i++) {
-                memcpy(p_dec_frame, p_src_ptr_y, dst_pitch);
+                memcpy(p_frame_y, p_src_ptr_y, dst_pitch);
                 p_frame_y += dst_pitch;
                 p_src_ptr_y += src_pitch[0];
             }
@@ -594,6 +610,7 @@ int FFMpegVideoDecoder::HandlePictureDisplay(RocdecParserDispInfo *pDispInfo) {
     uint8_t *p_frame_uv = p_dec_frame + dst_pitch * disp_height_;
     uint8_t *p_src_ptr_uv = static_cast<uint8_t *>(src_ptr[1]) + ((disp_rect_.top + crop_rect_.top) >> 1) * src_pitch[1] + ((disp_rect_.left + crop_rect_.left)>>1) * byte_per_pixel_ ;
     dst_pitch = chroma_width_ *  byte_per_pixel_;          
+#if !ROCDECODE_HOST_ONLY
     if (out_mem_type_ == OUT_SURFACE_MEM_DEV_COPIED) {
         if (src_pitch[1] == dst_pitch) {
             int chroma_size = chroma_height_ * dst_pitch;
@@ -602,7 +619,9 @@ int FFMpegVideoDecoder::HandlePictureDisplay(RocdecParserDispInfo *pDispInfo) {
             // use 2d copy to copy an ROI
             HIP_API_CALL(hipMemcpy2DAsync(p_frame_uv, dst_pitch, p_src_ptr_uv, src_pitch[1], dst_pitch, chroma_height_, hipMemcpyHostToDevice, hip_stream_));
         }
-    } else {
+    } else
+#endif
+    {
         if (src_pitch[1] == dst_pitch) {
             int chroma_size = chroma_height_ * dst_pitch;
             memcpy(p_frame_uv, p_src_ptr_uv, chroma_size);
@@ -617,18 +636,22 @@ int FFMpegVideoDecoder::HandlePictureDisplay(RocdecParserDispInfo *pDispInfo) {
     }
 
     if (num_chroma_planes_ == 2) {
-        uint8_t *p_frame_v = p_frame_uv + dst_pitch * chroma_height_;
+        // p_frame_uv may have been advanced by the row copy above, so address the V plane from the frame start
+        uint8_t *p_frame_v = p_dec_frame + disp_width_ * byte_per_pixel_ * disp_height_ + dst_pitch * chroma_height_;
         uint8_t *p_src_ptr_v = static_cast<uint8_t *>(src_ptr[2]) + (disp_rect_.top + crop_rect_.top) * src_pitch[2] + ((disp_rect_.left + crop_rect_.left) >> 1) * byte_per_pixel_;
+#if !ROCDECODE_HOST_ONLY
         if (out_mem_type_ == OUT_SURFACE_MEM_DEV_COPIED) {
             if (src_pitch[2] == dst_pitch) {
                 int chroma_size = chroma_height_ * dst_pitch;
-                HIP_API_CALL(hipMemcpyDtoDAsync(p_frame_v, p_src_ptr_v, chroma_size, hip_stream_));
+                HIP_API_CALL(hipMemcpyHtoDAsync(p_frame_v, p_src_ptr_v, chroma_size, hip_stream_));
             } else {
                 // use 2d copy to copy an ROI
                 HIP_API_CALL(hipMemcpy2DAsync(p_frame_v, dst_pitch, p_src_ptr_v, src_pitch[2], dst_pitch, chroma_height_, hipMemcpyHostToDevice, hip_stream_));
             }            
         }
-        else {
+        else
+#endif
+        {
             if (src_pitch[2] == dst_pitch) {
                 int chroma_size = chroma_height_ * dst_pitch;
                 memcpy(p_frame_v, p_src_ptr_v, chroma_size);
@@ -637,12 +660,14 @@ int FFMpegVideoDecoder::HandlePictureDisplay(RocdecParserDispInfo *pDispInfo) {
                 for (int i = 0; i < chroma_height_; i++) {
                     memcpy(p_frame_v, p_src_ptr_v, dst_pitch);
                     p_frame_v += dst_pitch;
-                    p_src_ptr_v += src_pitch[1];
+                    p_src_ptr_v += src_pitch[2];
                 }
             }
         }         
     }
+#if !ROCDECODE_HOST_ONLY
     if (out_mem_type_ == OUT_SURFACE_MEM_DEV_COPIED) HIP_API_CALL(hipStreamSynchronize(hip_stream_));
+#endif
 
     return 1;
 }
@@ -770,6 +795,7 @@ void FFMpegVideoDecoder::SaveFrameToFile(std::string output_file_name, void *sur
     uint8_t *hst_ptr = nullptr;
     bool is_rgb = (rgb_image_size != 0);
     uint64_t output_image_size = is_rgb ? rgb_image_size : surf_info->output_surface_size_in_bytes;
+#if !ROCDECODE_HOST_ONLY
     if (surf_info->mem_type == OUT_SURFACE_MEM_DEV_COPIED) {
         if (hst_ptr == nullptr) {
             hst_ptr = new uint8_t [output_image_size];
@@ -782,6 +808,7 @@ void FFMpegVideoDecoder::SaveFrameToFile(std::string output_file_name, void *sur
             return;
         }
     } else
+#endif
         hst_ptr = static_cast<uint8_t *> (surf_mem);
 
     
@@ -50,6 +50,9 @@ public:
      *  \param [in] buf_size Buffer info
      */
     void UpdateMd5ForDataBuffer(void *data_buf, int buf_size) {
+#if ROCDECODE_HOST_ONLY
+        av_md5_update(md5_ctx_, static_cast<uint8_t *>(data_buf), buf_size);
+#else
         uint8_t *hstPtr = nullptr;
         hstPtr = new uint8_t[buf_size];
         hipError_t hip_status = hipSuccess;
@@ -63,6 +66,7 @@ public:
         if (hstPtr) {
             delete [] hstPtr;
         }
+#endif
     }
 
     /*! \brief Function to update MD5 digest for a decoded frame
@@ -73,6 +77,7 @@ public:
         int i;
         uint8_t *hst_ptr = nullptr;
         uint64_t output_image_size = surf_info->output_surface_size_in_bytes;
+#if !ROCDECODE_HOST_ONLY
         if (surf_info->mem_type == OUT_SURFACE_MEM_DEV_INTERNAL || surf_info->mem_type == OUT_SURFACE_MEM_DEV_COPIED) {
             if (hst_ptr == nullptr) {
                 hst_ptr = new uint8_t [output_image_size];
@@ -85,6 +90,7 @@ public:
                 return;
             }
         } else
+#endif
             hst_ptr = static_cast<uint8_t *> (surf_mem);
 
         // Need to covert interleaved planar to stacked planar, assuming 4:2:0 chroma sampling.
@@ -22,14 +22,56 @@ THE SOFTWARE.
 
 #include "roc_video_dec.h"
 
+#if ROCDECODE_HOST_ONLY
+/**
+ * @brief copies a 2D region between host buffers of different pitches (host-only builds have no hipMemcpy2D)
+ */
+static inline void HostMemcpy2D(uint8_t *p_dst, int dst_pitch, const uint8_t *p_src, int src_pitch, int width_in_bytes, int height) {
+    if (dst_pitch == src_pitch && dst_pitch == width_in_bytes) {
+        memcpy(p_dst, p_src, static_cast<size_t>(width_in_bytes) * height);
+        return;
+    }
+    for (int i = 0; i < height; i++) {
+        memcpy(p_dst, p_src, width_in_bytes);
+        p_dst += dst_pitch;
+        p_src += src_pitch;
+    }
+}
+#else
+/**
+ * @brief returns true for a decoded surface in host memory (the null decoder backend), which HIP does not know as device memory
+ */
+static bool IsHostMemory(const void *ptr) {
+    unsigned int mem_type = 0;
+    if (hipPointerGetAttribute(&mem_type, HIP_POINTER_ATTRIBUTE_MEMORY_TYPE, const_cast<void *>(ptr)) != hipSuccess) {
+        (void)hipGetLastError();    // pageable host memory is not registered with HIP
+        return true;
+    }
+    return mem_type != hipMemoryTypeDevice;
+}
+#endif
+
 RocVideoDecoder::RocVideoDecoder(int device_id, OutputSurfaceMemoryType out_mem_type, rocDecVideoCodec codec, bool force_zero_latency,
-              const Rect *p_crop_rect, bool extract_user_sei_Message, uint32_t disp_delay, int max_width, int max_height, uint32_t clk_rate) :
+              const Rect *p_crop_rect, bool extract_user_sei_Message, uint32_t disp_delay, int max_width, int max_height, uint32_t clk_rate,
+              bool tight_surface_pool) :
               device_id_{device_id}, out_mem_type_(out_mem_type), codec_id_(codec), b_force_zero_latency_(force_zero_latency), 
               b_extract_sei_message_(extract_user_sei_Message), disp_delay_(disp_delay), max_width_ (max_width), max_height_(max_height) {
 
+#if ROCDECODE_HOST_ONLY
+    // there is no device memory in a host-only build: decoded surfaces live in host memory
+    num_devices_ = 0;
+    if (out_mem_type_ == OUT_SURFACE_MEM_DEV_INTERNAL || out_mem_type_ == OUT_SURFACE_MEM_DEV_COPIED) {
+        THROW("Output Memory Type is not supported in the host-only build");
+    }
+#else
     if (!InitHIP(device_id_)) {
         THROW("Failed to initilize the HIP");
     }
+#endif
+    // frames of OUT_SURFACE_MEM_DEV_INTERNAL hold their decode surface until ReleaseFrame, which a tight pool has no room for
+    if (tight_surface_pool && out_mem_type_ == OUT_SURFACE_MEM_DEV_INTERNAL) {
+        THROW("A tight surface pool is not supported with OUT_SURFACE_MEM_DEV_INTERNAL, use a copied output memory type");
+    }
     if (p_crop_rect) crop_rect_ = *p_crop_rect;
     if (b_extract_sei_message_) {
         fp_sei_ = fopen("rocdec_sei_message.txt", "wb");
@@ -41,11 +83,14 @@ RocVideoDecoder::RocVideoDecoder(int device_id, OutputSurfaceMemoryType out_mem_
     parser_params.codec_type = codec_id_;
     parser_params.max_num_decode_surfaces = 1; // let the parser to determine the decode buffer pool size
     parser_params.clock_rate = clk_rate;
-    parser_params.max_display_delay = disp_delay_;
+    parser_params.auto_display_delay = disp_delay_ == DISP_DELAY_AUTO;
+    parser_params.max_display_delay = parser_params.auto_display_delay ? 0 : disp_delay_;
+    parser_params.tight_surface_pool = tight_surface_pool;
+    parser_params.decode_order_output = b_force_zero_latency_;
     parser_params.user_data = this;
     parser_params.pfn_sequence_callback = HandleVideoSequenceProc;
     parser_params.pfn_decode_picture = HandlePictureDecodeProc;
-    parser_params.pfn_display_picture = b_force_zero_latency_ ? NULL : HandlePictureDisplayProc;
+    parser_params.pfn_display_picture = HandlePictureDisplayProc;
     parser_params.pfn_get_sei_msg = b_extract_sei_message_ ? HandleSEIMessagesProc : NULL;
     ROCDEC_API_CALL(rocDecCreateVideoParser(&rocdec_parser_, &parser_params));
 }
@@ -82,6 +127,7 @@ RocVideoDecoder::~RocVideoDecoder() {
     if (out_mem_type_ != OUT_SURFACE_MEM_DEV_INTERNAL) {
         for (auto &p_frame : vp_frames_) {
             if (p_frame.frame_ptr) {
+#if !ROCDECODE_HOST_ONLY
               if (out_mem_type_ == OUT_SURFACE_MEM_DEV_COPIED) {
                   hipError_t hip_status = hipFree(p_frame.frame_ptr);
                   if (hip_status != hipSuccess) {
@@ -89,11 +135,13 @@ RocVideoDecoder::~RocVideoDecoder() {
                   }
               }
               else
+#endif
                   delete[] (p_frame.frame_ptr);
               p_frame.frame_ptr = nullptr;
             }
         }
     }
+#if !ROCDECODE_HOST_ONLY
     if (hip_stream_) {
         hipError_t hip_status = hipSuccess;
         hip_status = hipStreamDestroy(hip_stream_);
@@ -101,6 +149,7 @@ RocVideoDecoder::~RocVideoDecoder() {
             std::cerr << "ERROR: hipStream_Destroy failed! (" << hip_status << ")" << std::endl;
         }
     }
+#endif
     if (fp_out_) {
         fclose(fp_out_);
         fp_out_ = nullptr;
@@ -345,6 +394,7 @@ int RocVideoDecoder::HandleVideoSequence(RocdecVideoFormat *p_video_format) {
     videoDecodeCreateInfo.output_format = video_surface_format_;
     videoDecodeCreateInfo.bit_depth_minus_8 = bitdepth_minus_8_;
     videoDecodeCreateInfo.num_decode_surfaces = num_decode_surfaces;
+    num_decode_surfaces_ = num_decode_surfaces;
     videoDecodeCreateInfo.width = coded_width_;
     videoDecodeCreateInfo.height = coded_height_;
     videoDecodeCreateInfo.max_width = max_width_;
@@ -370,8 +420,11 @@ int RocVideoDecoder::HandleVideoSequence(RocdecVideoFormat *p_video_format) {
     chroma_height_ = (int)(ceil(target_height_ * GetChromaHeightFactor(video_surface_format_)));
     num_chroma_planes_ = GetChromaPlaneCount(video_surface_format_);
     if (video_chroma_format_ == rocDecVideoChromaFormat_Monochrome) num_chroma_planes_ = 0;
+    // the decoder allocates its surfaces at max_width x max_height
+    surface_alloc_width_ = max_width_;
+    surface_alloc_height_ = max_height_;
     if (out_mem_type_ == OUT_SURFACE_MEM_DEV_INTERNAL || out_mem_type_ == OUT_SURFACE_MEM_NOT_MAPPED)
-        GetSurfaceStrideInternal(video_surface_format_, p_video_format->coded_width, p_video_format->coded_height, &surface_stride_, &surface_vstride_);
+        GetSurfaceStrideInternal(video_surface_format_, surface_alloc_width_, surface_alloc_height_, &surface_stride_, &surface_vstride_);
     else {
         surface_stride_ = videoDecodeCreateInfo.target_width * byte_per_pixel_;    // todo:: check if we need pitched memory for faster copy
     }
@@ -411,6 +464,7 @@ int RocVideoDecoder::HandleVideoSequence(RocdecVideoFormat *p_video_format) {
     std::cout << input_video_info_str_.str();
 
     ROCDEC_API_CALL(rocDecCreateDecoder(&roc_decoder_, &videoDecodeCreateInfo));
+    b_surface_mem_checked_ = false;
     double elapsed_time = StopTimer(start_time);
     AddDecoderSessionOverHead(std::this_thread::get_id(), elapsed_time);
     return num_decode_surfaces;
@@ -479,8 +533,10 @@ int RocVideoDecoder::ReconfigureDecoder(RocdecVideoFormat *p_video_format) {
                                      p_video_format->display_area.top == disp_rect_.top &&
                                      p_video_format->display_area.left == disp_rect_.left &&
                                      p_video_format->display_area.right == disp_rect_.right);
+    // the parser may ask for a different number of surfaces at the same size, e.g. a new sequence with a larger DPB
+    bool is_num_surfaces_changed = p_video_format->min_num_decode_surfaces != num_decode_surfaces_;
 
-    if (!is_decode_res_changed && !is_display_rect_changed && !b_force_recofig_flush_) {
+    if (!is_decode_res_changed && !is_display_rect_changed && !is_num_surfaces_changed && !b_force_recofig_flush_) {
         return 1;
     }
 
@@ -498,11 +554,13 @@ int RocVideoDecoder::ReconfigureDecoder(RocdecVideoFormat *p_video_format) {
             // pop decoded frame
             vp_frames_.pop_back();
             if (p_frame->frame_ptr) {
+#if !ROCDECODE_HOST_ONLY
               if (out_mem_type_ == OUT_SURFACE_MEM_DEV_COPIED) {
                   hipError_t hip_status = hipFree(p_frame->frame_ptr);
                   if (hip_status != hipSuccess) std::cerr << "ERROR: hipFree failed! (" << hip_status << ")" << std::endl;
               }
               else
+#endif
                   delete [] (p_frame->frame_ptr);
             }
         }
@@ -529,8 +587,16 @@ int RocVideoDecoder::ReconfigureDecoder(RocdecVideoFormat *p_video_format) {
         }
     }
 
+    // the decoder keeps its surfaces when their number is unchanged and the new coded size fits them, and reallocates them
+    // at the larger of the coded size and the max size given at creation otherwise
+    bool keep_surfaces = p_video_format->min_num_decode_surfaces == num_decode_surfaces_ &&
+                         coded_width_ <= surface_alloc_width_ && coded_height_ <= surface_alloc_height_;
+    if (!keep_surfaces) {
+        surface_alloc_width_ = std::max<uint32_t>(max_width_, coded_width_);
+        surface_alloc_height_ = std::max<uint32_t>(max_height_, coded_height_);
+    }
     if (out_mem_type_ == OUT_SURFACE_MEM_DEV_INTERNAL || out_mem_type_ == OUT_SURFACE_MEM_NOT_MAPPED) {
-        GetSurfaceStrideInternal(video_surface_format_, coded_width_, coded_height_, &surface_stride_, &surface_vstride_);
+        GetSurfaceStrideInternal(video_surface_format_, surface_alloc_width_, surface_alloc_height_, &surface_stride_, &surface_vstride_);
     } else {
         surface_stride_ = target_width_ * byte_per_pixel_;
     }
@@ -565,7 +631,7 @@ int RocVideoDecoder::ReconfigureDecoder(RocdecVideoFormat *p_video_format) {
 
     // If the coded_width or coded_height hasn't changed but display resolution has changed, then need to update width and height for
     // correct output with cropping. There is no need to reconfigure the decoder.
-    if (!is_decode_res_changed && is_display_rect_changed) {
+    if (!is_decode_res_changed && !is_num_surfaces_changed && is_display_rect_changed) {
         return 1;
     }
 
@@ -592,6 +658,7 @@ int RocVideoDecoder::ReconfigureDecoder(RocdecVideoFormat *p_video_format) {
         return 0;
     }
     ROCDEC_API_CALL(rocDecReconfigureDecoder(roc_decoder_, &reconfig_params));
+    num_decode_surfaces_ = reconfig_params.num_decode_surfaces;
 
 
     input_video_info_str_.str("");
@@ -622,18 +689,16 @@ int RocVideoDecoder::HandlePictureDecode(RocdecPicParams *pPicParams) {
     if (!roc_decoder_) {
         THROW("RocDecoder not initialized: failed with ErrCode: " +  TOSTR(ROCDEC_NOT_INITIALIZED));
     }
+    RocVideoDecTraceScope trace_scope("RocVideoDecoder::HandlePictureDecode", pPicParams->curr_pic_idx);
     pic_num_in_dec_order_[pPicParams->curr_pic_idx] = decode_poc_++;
+    auto submit_time = std::chrono::steady_clock::now();
     ROCDEC_API_CALL(rocDecDecodeFrame(roc_decoder_, pPicParams));
+    AddStageLatency(DECODER_STAGE_SUBMIT, submit_time);
+    if (pPicParams->curr_pic_idx >= 0 && pPicParams->curr_pic_idx < MAX_FRAME_NUM) {
+        submit_time_[pPicParams->curr_pic_idx] = submit_time;
+    }
     last_decode_surf_idx_ = pPicParams->curr_pic_idx;
     decoded_pic_cnt_++;
-    if (b_force_zero_latency_ && ((!pPicParams->field_pic_flag) || (pPicParams->second_field))) {
-        RocdecParserDispInfo disp_info;
-        memset(&disp_info, 0, sizeof(disp_info));
-        disp_info.picture_index = pPicParams->curr_pic_idx;
-        disp_info.progressive_frame = !pPicParams->field_pic_flag;
-        disp_info.top_field_first = pPicParams->bottom_field_flag ^ 1;
-        HandlePictureDisplay(&disp_info);
-    }
     return 1;
 }
 
@@ -644,6 +709,10 @@ int RocVideoDecoder::HandlePictureDecode(RocdecPicParams *pPicParams) {
  * @return int 0:fail 1: success
  */
 int RocVideoDecoder::HandlePictureDisplay(RocdecParserDispInfo *pDispInfo) {
+    RocVideoDecTraceScope trace_scope("RocVideoDecoder::HandlePictureDisplay", pDispInfo->picture_index);
+    if (pDispInfo->picture_index >= 0 && pDispInfo->picture_index < MAX_FRAME_NUM) {
+        AddStageLatency(DECODER_STAGE_SUBMIT_TO_DISPLAY, submit_time_[pDispInfo->picture_index]);
+    }
     RocdecProcParams video_proc_params = {};
     video_proc_params.progressive_frame = pDispInfo->progressive_frame;
     video_proc_params.top_field_first = pDispInfo->top_field_first;
@@ -683,7 +752,18 @@ int RocVideoDecoder::HandlePictureDisplay(RocdecParserDispInfo *pDispInfo) {
     if (out_mem_type_ != OUT_SURFACE_MEM_NOT_MAPPED) {
         void * src_dev_ptr[3] = { 0 };
         uint32_t src_pitch[3] = { 0 };
+        auto map_start_time = std::chrono::steady_clock::now();
         ROCDEC_API_CALL(rocDecGetVideoFrame(roc_decoder_, pDispInfo->picture_index, src_dev_ptr, src_pitch, &video_proc_params));
+        AddStageLatency(DECODER_STAGE_MAP, map_start_time);
+#if !ROCDECODE_HOST_ONLY
+        if (!b_surface_mem_checked_) {
+            b_host_surfaces_ = IsHostMemory(src_dev_ptr[0]);
+            b_surface_mem_checked_ = true;
+            if (b_host_surfaces_ && out_mem_type_ == OUT_SURFACE_MEM_DEV_INTERNAL) {
+                THROW("OUT_SURFACE_MEM_DEV_INTERNAL is not supported with host-memory decode surfaces (null decoder backend), use a copied output memory type");
+            }
+        }
+#endif
         RocdecDecodeStatus dec_status;
         memset(&dec_status, 0, sizeof(dec_status));
         rocDecStatus result = rocDecGetDecodeStatus(roc_decoder_, pDispInfo->picture_index, &dec_status);
@@ -707,12 +787,16 @@ int RocVideoDecoder::HandlePictureDisplay(RocdecParserDispInfo *pDispInfo) {
                 if ((unsigned)++output_frame_cnt_ > vp_frames_.size()) {
                     num_alloced_frames_++;
                     DecFrameBuffer dec_frame = { 0 };
+#if ROCDECODE_HOST_ONLY
+                    dec_frame.frame_ptr = new uint8_t[GetFrameSize()];
+#else
                     if (out_mem_type_ == OUT_SURFACE_MEM_DEV_COPIED) {
                         // allocate device memory
                         HIP_API_CALL(hipMalloc((void **)&dec_frame.frame_ptr, GetFrameSize()));
                     } else {
                         dec_frame.frame_ptr = new uint8_t[GetFrameSize()];
                     }
+#endif
                     dec_frame.pts = pDispInfo->pts;
                     dec_frame.picture_index = pDispInfo->picture_index;
                     vp_frames_.push_back(dec_frame);
@@ -720,18 +804,36 @@ int RocVideoDecoder::HandlePictureDisplay(RocdecParserDispInfo *pDispInfo) {
                 p_dec_frame = vp_frames_[output_frame_cnt_ - 1].frame_ptr;
             }
             // Copy luma data
+            RocVideoDecTraceScope copy_trace_scope("RocVideoDecoder::CopyFrame", pDispInfo->picture_index);
+            auto copy_start_time = std::chrono::steady_clock::now();
             int dst_pitch = disp_width_ * byte_per_pixel_;
             uint8_t *p_src_ptr_y = static_cast<uint8_t *>(src_dev_ptr[0]) + (disp_rect_.top + crop_rect_.top) * src_pitch[0] + (disp_rect_.left + crop_rect_.left) * byte_per_pixel_;
+#if ROCDECODE_HOST_ONLY
+            // the decoded surfaces are in host memory: copy the display ROI of every plane
+            HostMemcpy2D(p_dec_frame, dst_pitch, p_src_ptr_y, src_pitch[0], dst_pitch, disp_height_);
+            uint8_t *p_frame_uv = p_dec_frame + dst_pitch * disp_height_;
+            uint8_t *p_src_ptr_uv = (num_chroma_planes_ == 1) ? static_cast<uint8_t *>(src_dev_ptr[1]) + ((disp_rect_.top + crop_rect_.top) >> 1) * src_pitch[1] + (disp_rect_.left + crop_rect_.left) * byte_per_pixel_ :
+            static_cast<uint8_t *>(src_dev_ptr[1]) + (disp_rect_.top + crop_rect_.top) * src_pitch[1] + (disp_rect_.left + crop_rect_.left) * byte_per_pixel_;
+            HostMemcpy2D(p_frame_uv, dst_pitch, p_src_ptr_uv, src_pitch[1], dst_pitch, chroma_height_);
+            if (num_chroma_planes_ == 2) {
+                uint8_t *p_frame_v = p_dec_frame + dst_pitch * (disp_height_ + chroma_height_);
+                uint8_t *p_src_ptr_v = static_cast<uint8_t *>(src_dev_ptr[2]) + (disp_rect_.top + crop_rect_.top) * src_pitch[2] + (disp_rect_.left + crop_rect_.left) * byte_per_pixel_;
+                HostMemcpy2D(p_frame_v, dst_pitch, p_src_ptr_v, src_pitch[2], dst_pitch, chroma_height_);
+            }
+#else
+            // host-memory surfaces of the null decoder backend are copied from the host
+            hipMemcpyKind dev_copy_kind = b_host_surfaces_ ? hipMemcpyHostToDevice : hipMemcpyDeviceToDevice;
+            hipMemcpyKind host_copy_kind = b_host_surfaces_ ? hipMemcpyHostToHost : hipMemcpyDeviceToHost;
             if (out_mem_type_ == OUT_SURFACE_MEM_DEV_COPIED) {
-                if (src_pitch[0] == dst_pitch) {
+                if (src_pitch[0] == dst_pitch && !b_host_surfaces_) {
                     int luma_size = src_pitch[0] * coded_height_;
                     HIP_API_CALL(hipMemcpyDtoDAsync(p_dec_frame, p_src_ptr_y, luma_size, hip_stream_));
                 } else {
                     // use 2d copy to copy an ROI
-                    HIP_API_CALL(hipMemcpy2DAsync(p_dec_frame, dst_pitch, p_src_ptr_y, src_pitch[0], dst_pitch, disp_height_, hipMemcpyDeviceToDevice, hip_stream_));
+                    HIP_API_CALL(hipMemcpy2DAsync(p_dec_frame, dst_pitch, p_src_ptr_y, src_pitch[0], dst_pitch, disp_height_, dev_copy_kind, hip_stream_));
                 }
             } else
-                HIP_API_CALL(hipMemcpy2DAsync(p_dec_frame, dst_pitch, p_src_ptr_y, src_pitch[0], dst_pitch, disp_height_, hipMemcpyDeviceToHost, hip_stream_));
+                HIP_API_CALL(hipMemcpy2DAsync(p_dec_frame, dst_pitch, p_src_ptr_y, src_pitch[0], dst_pitch, disp_height_, host_copy_kind, hip_stream_));
 
             // Copy chroma plane ( )
             // rocDec output gives pointer to luma and chroma pointers seperated for the decoded frame
@@ -739,32 +841,34 @@ int RocVideoDecoder::HandlePictureDisplay(RocdecParserDispInfo *pDispInfo) {
             uint8_t *p_src_ptr_uv = (num_chroma_planes_ == 1) ? static_cast<uint8_t *>(src_dev_ptr[1]) + ((disp_rect_.top + crop_rect_.top) >> 1) * src_pitch[1] + (disp_rect_.left + crop_rect_.left) * byte_per_pixel_ :
             static_cast<uint8_t *>(src_dev_ptr[1]) + (disp_rect_.top + crop_rect_.top) * src_pitch[1] + (disp_rect_.left + crop_rect_.left) * byte_per_pixel_;
             if (out_mem_type_ == OUT_SURFACE_MEM_DEV_COPIED) {
-                if (src_pitch[1] == dst_pitch) {
+                if (src_pitch[1] == dst_pitch && !b_host_surfaces_) {
                     int chroma_size = chroma_height_ * dst_pitch;
                     HIP_API_CALL(hipMemcpyDtoDAsync(p_frame_uv, p_src_ptr_uv, chroma_size, hip_stream_));
                 } else {
                     // use 2d copy to copy an ROI
-                    HIP_API_CALL(hipMemcpy2DAsync(p_frame_uv, dst_pitch, p_src_ptr_uv, src_pitch[1], dst_pitch, chroma_height_, hipMemcpyDeviceToDevice, hip_stream_));
+                    HIP_API_CALL(hipMemcpy2DAsync(p_frame_uv, dst_pitch, p_src_ptr_uv, src_pitch[1], dst_pitch, chroma_height_, dev_copy_kind, hip_stream_));
                 }
             } else
-                HIP_API_CALL(hipMemcpy2DAsync(p_frame_uv, dst_pitch, p_src_ptr_uv, src_pitch[1], dst_pitch, chroma_height_, hipMemcpyDeviceToHost, hip_stream_));
+                HIP_API_CALL(hipMemcpy2DAsync(p_frame_uv, dst_pitch, p_src_ptr_uv, src_pitch[1], dst_pitch, chroma_height_, host_copy_kind, hip_stream_));
 
             if (num_chroma_planes_ == 2) {
                 uint8_t *p_frame_v = p_dec_frame + dst_pitch * (disp_height_ + chroma_height_);
                 uint8_t *p_src_ptr_v = static_cast<uint8_t *>(src_dev_ptr[2]) + (disp_rect_.top + crop_rect_.top) * src_pitch[2] + (disp_rect_.left + crop_rect_.left) * byte_per_pixel_;
                 if (out_mem_type_ == OUT_SURFACE_MEM_DEV_COPIED) {
-                    if (src_pitch[2] == dst_pitch) {
+                    if (src_pitch[2] == dst_pitch && !b_host_surfaces_) {
                         int chroma_size = chroma_height_ * dst_pitch;
                         HIP_API_CALL(hipMemcpyDtoDAsync(p_frame_v, p_src_ptr_v, chroma_size, hip_stream_));
                     } else {
                         // use 2d copy to copy an ROI
-                        HIP_API_CALL(hipMemcpy2DAsync(p_frame_v, dst_pitch, p_src_ptr_v, src_pitch[2], dst_pitch, chroma_height_, hipMemcpyDeviceToDevice, hip_stream_));
+                        HIP_API_CALL(hipMemcpy2DAsync(p_frame_v, dst_pitch, p_src_ptr_v, src_pitch[2], dst_pitch, chroma_height_, dev_copy_kind, hip_stream_));
                     }
                 } else
-                    HIP_API_CALL(hipMemcpy2DAsync(p_frame_v, dst_pitch, p_src_ptr_v, src_pitch[2], dst_pitch, chroma_height_, hipMemcpyDeviceToHost, hip_stream_));
+                    HIP_API_CALL(hipMemcpy2DAsync(p_frame_v, dst_pitch, p_src_ptr_v, src_pitch[2], dst_pitch, chroma_height_, host_copy_kind, hip_stream_));
             }
 
             HIP_API_CALL(hipStreamSynchronize(hip_stream_));
+#endif
+            AddStageLatency(DECODER_STAGE_COPY, copy_start_time);
         }
     } else {
         RocdecDecodeStatus dec_status;
@@ -816,6 +920,12 @@ int RocVideoDecoder::GetSEIMessage(RocdecSeiMessageInfo *pSEIMessageInfo) {
 
 
 int RocVideoDecoder::DecodeFrame(const uint8_t *data, size_t size, int pkt_flags, int64_t pts, int *num_decoded_pics) {
+    RocVideoDecTraceScope trace_scope("RocVideoDecoder::DecodeFrame");
+    if (out_mem_type_ == OUT_SURFACE_MEM_DEV_COPIED || out_mem_type_ == OUT_SURFACE_MEM_HOST_COPIED) {
+        // the copied frames of the previous call are reused from here on whether they were released or not
+        std::lock_guard<std::mutex> lock(mtx_stage_latency_);
+        frame_get_times_.clear();
+    }
     output_frame_cnt_ = 0, output_frame_cnt_ret_ = 0;
     decoded_pic_cnt_ = 0;
     RocdecSourceDataPacket packet = { 0 };
@@ -840,9 +950,11 @@ uint8_t* RocVideoDecoder::GetFrame(int64_t *pts) {
         if (out_mem_type_ == OUT_SURFACE_MEM_DEV_INTERNAL && !vp_frames_q_.empty()) {
             DecFrameBuffer *fb = &vp_frames_q_.front();
             if (pts) *pts = fb->pts;
+            PushFrameGetTime(fb->pts);
             return fb->frame_ptr;
         } else if (vp_frames_.size() > 0){
             if (pts) *pts = vp_frames_[output_frame_cnt_ret_].pts;
+            PushFrameGetTime(vp_frames_[output_frame_cnt_ret_].pts);
             return vp_frames_[output_frame_cnt_ret_++].frame_ptr;
         }
     }
@@ -862,6 +974,15 @@ uint8_t* RocVideoDecoder::GetFrame(int64_t *pts) {
 bool RocVideoDecoder::ReleaseFrame(int64_t pTimestamp, bool b_flushing) {
     if (out_mem_type_ == OUT_SURFACE_MEM_NOT_MAPPED)
         return true;    // nothing to do
+    {
+        // the frames may be released in any order; of the frames with the same pts the one got first is released first
+        std::lock_guard<std::mutex> lock(mtx_stage_latency_);
+        auto it = frame_get_times_.lower_bound(pTimestamp);
+        if (it != frame_get_times_.end() && it->first == pTimestamp) {
+            AddStageLatencyLocked(DECODER_STAGE_HOLD, it->second);
+            frame_get_times_.erase(it);
+        }
+    }
     if (out_mem_type_ != OUT_SURFACE_MEM_DEV_INTERNAL) {
         if (!b_flushing)  // if not flushing the buffers are re-used, so keep them
             return true;            // nothing to do
@@ -900,6 +1021,10 @@ bool RocVideoDecoder::ReleaseFrame(int64_t pTimestamp, bool b_flushing) {
 bool RocVideoDecoder::ReleaseInternalFrames() {
     if (out_mem_type_ != OUT_SURFACE_MEM_DEV_INTERNAL || out_mem_type_ == OUT_SURFACE_MEM_NOT_MAPPED)
         return true;            // nothing to do
+    {
+        std::lock_guard<std::mutex> lock(mtx_stage_latency_);
+        frame_get_times_.clear();
+    }
     // only needed when using internal mapped buffer
     while (!vp_frames_q_.empty()) {
         std::lock_guard<std::mutex> lock(mtx_vp_frame_);
@@ -914,6 +1039,7 @@ void RocVideoDecoder::SaveFrameToFile(std::string output_file_name, void *surf_m
     uint8_t *hst_ptr = nullptr;
     bool is_rgb = (rgb_image_size != 0);
     uint64_t output_image_size = is_rgb ? rgb_image_size : surf_info->output_surface_size_in_bytes;
+#if !ROCDECODE_HOST_ONLY
     if (surf_info->mem_type == OUT_SURFACE_MEM_DEV_INTERNAL || surf_info->mem_type == OUT_SURFACE_MEM_DEV_COPIED) {
         if (hst_ptr == nullptr) {
             hst_ptr = new uint8_t [output_image_size];
@@ -926,6 +1052,7 @@ void RocVideoDecoder::SaveFrameToFile(std::string output_file_name, void *surf_m
             return;
         }
     } else
+#endif
         hst_ptr = static_cast<uint8_t *> (surf_mem);
 
     
@@ -1016,11 +1143,17 @@ void RocVideoDecoder::ResetSaveFrameToFile() {
 }
 
 void RocVideoDecoder::GetDeviceinfo(std::string &device_name, std::string &gcn_arch_name, int &pci_bus_id, int &pci_domain_id, int &pci_device_id) {
+#if ROCDECODE_HOST_ONLY
+    device_name = "host";
+    gcn_arch_name = "none";
+    pci_bus_id = pci_domain_id = pci_device_id = 0;
+#else
     device_name = hip_dev_prop_.name;
     gcn_arch_name = hip_dev_prop_.gcnArchName;
     pci_bus_id = hip_dev_prop_.pciBusID;
     pci_domain_id = hip_dev_prop_.pciDomainID;
     pci_device_id = hip_dev_prop_.pciDeviceID;
+#endif
 }
 
 
@@ -1033,6 +1166,7 @@ bool RocVideoDecoder::GetOutputSurfaceInfo(OutputSurfaceInfo **surface_info) {
     return true;
 }
 
+#if !ROCDECODE_HOST_ONLY
 bool RocVideoDecoder::InitHIP(int device_id) {
     HIP_API_CALL(hipGetDeviceCount(&num_devices_));
     if (num_devices_ < 1) {
@@ -1044,6 +1178,95 @@ bool RocVideoDecoder::InitHIP(int device_id) {
     HIP_API_CALL(hipStreamCreate(&hip_stream_));
     return true;
 }
+#endif
+
+void RocVideoDecoder::AddStageLatency(DecoderStage stage, std::chrono::steady_clock::time_point start_time) {
+    std::lock_guard<std::mutex> lock(mtx_stage_latency_);
+    AddStageLatencyLocked(stage, start_time);
+}
+
+void RocVideoDecoder::AddStageLatencyLocked(DecoderStage stage, std::chrono::steady_clock::time_point start_time) {
+    auto latency = std::chrono::steady_clock::now() - start_time;
+    stage_latency_[stage].Add(std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count());
+}
+
+void RocVideoDecoder::PushFrameGetTime(int64_t pts) {
+    std::lock_guard<std::mutex> lock(mtx_stage_latency_);
+    frame_get_times_.emplace(pts, std::chrono::steady_clock::now());
+}
+
+bool RocVideoDecoder::GetStageLatency(DecoderStage stage, StageLatency *latency) {
+    if (stage < 0 || stage >= DECODER_STAGE_NUM_STAGES || !latency) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mtx_stage_latency_);
+    stage_latency_[stage].GetLatency(latency);
+    return true;
+}
+
+void RocVideoDecoder::ResetStageLatencies() {
+    std::lock_guard<std::mutex> lock(mtx_stage_latency_);
+    for (int i = 0; i < DECODER_STAGE_NUM_STAGES; i++) {
+        stage_latency_[i].Reset();
+    }
+}
+
+const char *RocVideoDecoder::GetStageName(DecoderStage stage) {
+    switch (stage) {
+        case DECODER_STAGE_SUBMIT: return "Submit";
+        case DECODER_STAGE_SUBMIT_TO_DISPLAY: return "SubmitToDisplay";
+        case DECODER_STAGE_MAP: return "Map";
+        case DECODER_STAGE_COPY: return "Copy";
+        case DECODER_STAGE_HOLD: return "Hold";
+        default: return "Unknown";
+    }
+}
+
+void RocVideoDecoder::PrintStageLatencies() {
+    std::ostringstream str;
+    str << std::fixed << std::setprecision(1);
+    str << "  " << std::left << std::setw(16) << "Stage" << std::right << std::setw(10) << "Count" << std::setw(12) << "Mean(us)"
+        << std::setw(12) << "p50(us)" << std::setw(12) << "p99(us)" << std::setw(12) << "Max(us)" << std::endl;
+    for (int i = 0; i < DECODER_STAGE_NUM_STAGES; i++) {
+        StageLatency latency;
+        GetStageLatency(static_cast<DecoderStage>(i), &latency);
+        if (latency.count == 0) {
+            continue;
+        }
+        str << "  " << std::left << std::setw(16) << GetStageName(static_cast<DecoderStage>(i)) << std::right << std::setw(10) << latency.count
+            << std::setw(12) << latency.mean_us << std::setw(12) << latency.p50_us << std::setw(12) << latency.p99_us << std::setw(12) << latency.max_us << std::endl;
+    }
+    std::cout << str.str();
+}
+
+uint64_t RocVideoDecoder::GetFrameBufferMemoryUsage() {
+    std::lock_guard<std::mutex> lock(mtx_vp_frame_);
+    // the frame store is released when the frame size changes, so all its buffers have the current size
+    if (out_mem_type_ == OUT_SURFACE_MEM_DEV_INTERNAL || vp_frames_.empty()) {
+        return 0;
+    }
+    return static_cast<uint64_t>(vp_frames_.size()) * GetFrameSize();
+}
+
+void LatencyHistogram::Add(uint64_t latency_ns) {
+    buckets_[RocDecLatencyBuckets::GetBucketIndex(latency_ns)]++;
+    count_++;
+    total_ns_ += latency_ns;
+    max_ns_ = std::max(max_ns_, latency_ns);
+}
+
+void LatencyHistogram::Reset() {
+    memset(buckets_, 0, sizeof(buckets_));
+    count_ = total_ns_ = max_ns_ = 0;
+}
+
+void LatencyHistogram::GetLatency(StageLatency *latency) const {
+    latency->count = count_;
+    latency->mean_us = count_ ? total_ns_ / 1000.0 / count_ : 0;
+    latency->p50_us = RocDecLatencyBuckets::GetPercentile(buckets_, max_ns_, 50) / 1000.0;
+    latency->p99_us = RocDecLatencyBuckets::GetPercentile(buckets_, max_ns_, 99) / 1000.0;
+    latency->max_us = max_ns_ / 1000.0;
+}
 
 std::chrono::_V2::system_clock::time_point RocVideoDecoder::StartTimer() {
     return std::chrono::_V2::system_clock::now();
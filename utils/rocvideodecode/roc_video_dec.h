@@ -34,11 +34,20 @@ THE SOFTWARE.
 #include <stdexcept>
 #include <exception>
 #include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <iomanip>
+#include <algorithm>
 #include <unordered_map>
+#include <map>
 #include <chrono>
+#include <thread>
+#if !ROCDECODE_HOST_ONLY
 #include <hip/hip_runtime.h>
+#endif
 #include "rocdecode.h"
 #include "rocparser.h"
+#include "amd_detail/rocdecode_latency_histogram.h"
 
 /*!
  * \file
@@ -49,6 +58,7 @@ THE SOFTWARE.
  */
 
 #define MAX_FRAME_NUM       16
+#define DISP_DELAY_AUTO     UINT32_MAX   // disp_delay that lets the parser derive the display delay from the stream
 
 typedef int (ROCDECAPI *PFNRECONFIGUEFLUSHCALLBACK)(void *, uint32_t, void *);
 
@@ -140,6 +150,7 @@ private:
         }                                                                                                     \
     } while (0)
 
+#if !ROCDECODE_HOST_ONLY
 #define HIP_API_CALL( call )                                                                                  \
     do {                                                                                                      \
         hipError_t hip_status = call;                                                                         \
@@ -152,6 +163,39 @@ private:
         }                                                                                                     \
     }                                                                                                         \
     while (0)
+#endif
+
+/**
+ * @brief Whether the rocDecode pipeline trace is on (ROCDECODE_TRACE=1, read by the library at startup). Read once here,
+ * so that a scope costs no library call when tracing is off.
+ */
+inline bool IsRocDecTraceEnabled() {
+    static const bool enabled = [] {
+        const char *trace = std::getenv("ROCDECODE_TRACE");
+        return trace != nullptr && std::atoi(trace) != 0;
+    }();
+    return enabled;
+}
+
+/**
+ * @brief Emits a begin/end pair on the rocDecode pipeline trace for the enclosing scope (no-op unless ROCDECODE_TRACE=1)
+ */
+class RocVideoDecTraceScope {
+public:
+    RocVideoDecTraceScope(const char *name, int pic_idx = -1) : name_(IsRocDecTraceEnabled() ? name : nullptr), pic_idx_(pic_idx) {
+        if (name_) {
+            rocDecTraceEvent(name_, rocDecTracePhase_Begin, pic_idx_);
+        }
+    }
+    ~RocVideoDecTraceScope() {
+        if (name_) {
+            rocDecTraceEvent(name_, rocDecTracePhase_End, pic_idx_);
+        }
+    }
+private:
+    const char *name_;
+    int pic_idx_;
+};
 
 
 struct Rect {
@@ -176,6 +220,38 @@ typedef struct DecFrameBuffer_ {
 } DecFrameBuffer;
 
 
+typedef enum DecoderStage_enum {
+    DECODER_STAGE_SUBMIT = 0,             /**< rocDecDecodeFrame call in HandlePictureDecode */
+    DECODER_STAGE_SUBMIT_TO_DISPLAY = 1,  /**< From the submission of a picture to its display callback */
+    DECODER_STAGE_MAP = 2,                /**< rocDecGetVideoFrame call (surface mapping) in HandlePictureDisplay */
+    DECODER_STAGE_COPY = 3,               /**< Copy of the decoded surface into the output frame (D2D or D2H) in HandlePictureDisplay */
+    DECODER_STAGE_HOLD = 4,               /**< From GetFrame to ReleaseFrame of an output frame */
+    DECODER_STAGE_NUM_STAGES
+} DecoderStage;
+
+typedef struct StageLatency_ {
+    uint64_t count;     /**< Number of samples */
+    double mean_us;     /**< Mean latency in microseconds */
+    double p50_us;      /**< Median latency in microseconds */
+    double p99_us;      /**< 99th percentile latency in microseconds */
+    double max_us;      /**< Max latency in microseconds */
+} StageLatency;
+
+/**
+ * @brief Latency histogram of a decoder stage, with the log-linear buckets of RocDecLatencyBuckets
+ */
+class LatencyHistogram {
+    public:
+        void Add(uint64_t latency_ns);
+        void Reset();
+        void GetLatency(StageLatency *latency) const;
+    private:
+        uint64_t buckets_[RocDecLatencyBuckets::kNumBuckets] = {};
+        uint64_t count_ = 0;
+        uint64_t total_ns_ = 0;
+        uint64_t max_ns_ = 0;
+};
+
 typedef struct OutputSurfaceInfoType {
     uint32_t output_width;                      /**< Output width of decoded surface*/
     uint32_t output_height;                     /**< Output height of decoded surface*/
@@ -205,22 +281,25 @@ class RocVideoDecoder {
         * @param device_id : device_id to initialize HIP and VCN
         * @param out_mem_type : out_mem_type for the decoded surface
         * @param codec : codec type
-        * @param force_zero_latency : to force zero latency (output in decoding orde)
+        * @param force_zero_latency : to force zero latency (output in decoding order, right after each picture is submitted)
         * @param p_crop_rect : to crop output
         * @param extract_user_SEI_Message : enable to extract SEI
-        * @param disp_delay : output delayed by #disp_delay surfaces
+        * @param disp_delay : output delayed by #disp_delay surfaces, or DISP_DELAY_AUTO for the smallest delay that keeps the output order
         * @param max_width : Max. width for the output surface
         * @param max_height : Max. height for the output surface
         * @param clk_rate : FPS clock-rate
+        * @param tight_surface_pool : allocate only the decode surfaces the stream needs plus disp_delay (not supported with OUT_SURFACE_MEM_DEV_INTERNAL)
         */
         RocVideoDecoder(int device_id,  OutputSurfaceMemoryType out_mem_type, rocDecVideoCodec codec, bool force_zero_latency = false,
                           const Rect *p_crop_rect = nullptr, bool extract_user_SEI_Message = false, uint32_t disp_delay = 0, int max_width = 0, int max_height = 0,
-                          uint32_t clk_rate = 1000);
+                          uint32_t clk_rate = 1000, bool tight_surface_pool = false);
         ~RocVideoDecoder();
         
         rocDecVideoCodec GetCodecId() { return codec_id_; }
 
+#if !ROCDECODE_HOST_ONLY
         hipStream_t GetStream() {return hip_stream_;}
+#endif
 
         /**
          * @brief Get the output frame width
@@ -390,6 +469,38 @@ class RocVideoDecoder {
             }
          }
 
+        /**
+         * @brief Get the latency statistics of a stage of this decoder session since it was created or last reset
+         * 
+         * @param stage - DECODER_STAGE_XXX
+         * @param latency - count, mean, p50, p99 and max latency of the stage
+         * @return true - success
+         * @return false - invalid stage or latency pointer
+         */
+        bool GetStageLatency(DecoderStage stage, StageLatency *latency);
+
+        /**
+         * @brief Reset the latency statistics of all stages
+         */
+        void ResetStageLatencies();
+
+        /**
+         * @brief Print the latency statistics of all stages to std::cout
+         */
+        void PrintStageLatencies();
+
+        /**
+         * @brief Get the bytes held by the output frame buffers of the copied output modes: device memory with
+         * OUT_SURFACE_MEM_DEV_COPIED, host memory with OUT_SURFACE_MEM_HOST_COPIED. The decoder, parser and bitstream reader
+         * report their own memory with rocDecGetDecoderMemoryUsage, rocDecGetParserMemoryUsage and rocDecGetBitstreamReaderMemoryUsage
+         */
+        uint64_t GetFrameBufferMemoryUsage();
+
+        /**
+         * @brief Get the name of a stage
+         */
+        static const char *GetStageName(DecoderStage stage);
+
         /**
          * @brief Check if the given Video Codec is supported on the given GPU
          * 
@@ -453,11 +564,25 @@ class RocVideoDecoder {
          */
         bool ReleaseInternalFrames();
 
+#if !ROCDECODE_HOST_ONLY
         /**
          * @brief Function to Initialize GPU-HIP
          * 
          */
         bool InitHIP(int device_id);
+#endif
+
+        /**
+         * @brief Function to add the time elapsed since start_time to the histogram of a stage
+         */
+        void AddStageLatency(DecoderStage stage, std::chrono::steady_clock::time_point start_time);
+        void AddStageLatencyLocked(DecoderStage stage, std::chrono::steady_clock::time_point start_time);
+
+        /**
+         * @brief Function to record the time an output frame is handed to the application by GetFrame
+         * @param pts Timestamp of the frame, which ReleaseFrame is called with
+         */
+        void PushFrameGetTime(int64_t pts);
 
         /**
          * @brief Function to get start time
@@ -482,8 +607,12 @@ class RocVideoDecoder {
         ReconfigParams *p_reconfig_params_ = nullptr;
         bool b_force_recofig_flush_ = false;
         int32_t num_frames_flushed_during_reconfig_ = 0;
+#if !ROCDECODE_HOST_ONLY
         hipDeviceProp_t hip_dev_prop_;
         hipStream_t hip_stream_;
+#endif
+        bool b_surface_mem_checked_ = false;    // b_host_surfaces_ is known for the current decoder
+        bool b_host_surfaces_ = false;          // the decoder hands out host-memory surfaces (null backend)
         rocDecVideoCodec codec_id_ = rocDecVideoCodec_NumCodecs;
         rocDecVideoChromaFormat video_chroma_format_ = rocDecVideoChromaFormat_420;
         rocDecVideoSurfaceFormat video_surface_format_ = rocDecVideoSurfaceFormat_NV12;
@@ -501,10 +630,12 @@ class RocVideoDecoder {
         uint32_t coded_width_ = 0;
         uint32_t disp_width_ = 0;
         uint32_t coded_height_ = 0;
+        uint32_t num_decode_surfaces_ = 0;
         uint32_t disp_height_ = 0;
         uint32_t target_width_ = 0;
         uint32_t target_height_ = 0;
         int max_width_ = 0, max_height_ = 0;
+        uint32_t surface_alloc_width_ = 0, surface_alloc_height_ = 0; // size the decoder surfaces are allocated at, which sets their strides
         uint32_t chroma_height_ = 0, chroma_width_ = 0;
         uint32_t num_chroma_planes_ = 0;
         uint32_t num_components_ = 0;
@@ -524,4 +655,8 @@ class RocVideoDecoder {
         uint32_t extra_output_file_count_ = 0;
         std::thread::id decoder_session_id_; // Decoder session identifier. Used to gather session level stats.
         std::unordered_map<std::thread::id, double> session_overhead_; // Records session overhead of initialization+deinitialization time. Format is (thread id, duration)
+        std::mutex mtx_stage_latency_;  // guards stage_latency_ and frame_get_times_
+        LatencyHistogram stage_latency_[DECODER_STAGE_NUM_STAGES];
+        std::chrono::steady_clock::time_point submit_time_[MAX_FRAME_NUM]; // submit time of the picture decoded into each surface
+        std::multimap<int64_t, std::chrono::steady_clock::time_point> frame_get_times_; // GetFrame time of the frames not released yet, by pts
 };
\ No newline at end of file
@@ -154,6 +154,12 @@ class VideoDemuxer {
             }
         }
         bool Demux(uint8_t **video, int *video_size, int64_t *pts = nullptr) {
+            rocDecTraceEvent("VideoDemuxer::Demux", rocDecTracePhase_Begin, -1);
+            bool ret = DemuxPacket(video, video_size, pts);
+            rocDecTraceEvent("VideoDemuxer::Demux", rocDecTracePhase_End, -1);
+            return ret;
+        }
+        bool DemuxPacket(uint8_t **video, int *video_size, int64_t *pts) {
             if (!av_fmt_input_ctx_) {
                 return false;
             }